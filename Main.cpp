@@ -1,19 +1,352 @@
 #include "game_management/GameManager.h"
+#include "game_management/BatchRunner.h"
 #include "common/MyPlayerFactory.h"
 #include "common/MyTankAlgorithmFactory.h"
+#include "common/WorkStealingPool.h"
+#include "game_management/AllocationStats.h"
+#include "game_management/LiveStateExport.h"
+#include "game_management/TerminalRenderer.h"
+#include <chrono>
+#include <climits>
+#include <csignal>
+#include <thread>
+#include <memory>
 #include <string>
+#include <vector>
 #include <iostream>
 
+static void printUsage(const char* program) {
+    std::cerr << "Usage: " << program << " <game_board_input_file>... [--fast-forward-cycles]"
+              << " [--mcts] [--mcts-threads N] [--mcts-rollouts N] [--mcts-time-ms N]"
+              << " [--jobs N] [--pin-threads] [--isolate] [--game-timeout-ms N] [--stats] [--cache FILE]"
+              << " [--latency] [--report-slow-ms N] [--slow-do-nothing] [--lockstep] [--parallel-search]"
+              << " [--board-cache] [--live NAME] [--terminal-view] [--view-fps N]" << std::endl;
+    std::cerr << "       " << program << " --view NAME [--view-fps N]" << std::endl;
+}
+
+// The whole of text as an integer within [minValue, maxValue]
+static bool parseInteger(const std::string& text, long long minValue, long long maxValue, long long& value) {
+    size_t used = 0;
+    long long parsed;
+    try {
+        parsed = std::stoll(text, &used);
+    } catch (const std::exception&) {
+        return false;
+    }
+    if (used != text.size() || parsed < minValue || parsed > maxValue) {
+        return false;
+    }
+    value = parsed;
+    return true;
+}
+
+// The whole of text as a number within [minValue, maxValue]
+static bool parseNumber(const std::string& text, double minValue, double maxValue, double& value) {
+    size_t used = 0;
+    double parsed;
+    try {
+        parsed = std::stod(text, &used);
+    } catch (const std::exception&) {
+        return false;
+    }
+    // NaN fails both comparisons
+    if (used != text.size() || !(parsed >= minValue && parsed <= maxValue)) {
+        return false;
+    }
+    value = parsed;
+    return true;
+}
+
+static int invalidValue(const char* program, const std::string& option, const std::string& value) {
+    std::cerr << "Invalid value for " << option << ": " << value << std::endl;
+    printUsage(program);
+    return 1;
+}
+
+static volatile std::sig_atomic_t viewerStopped = 0;
+
+static void stopViewer(int) {
+    viewerStopped = 1;
+}
+
+// Swallows the game's logs while the terminal view owns the screen
+class NullBuffer : public std::streambuf {
+protected:
+    int overflow(int c) override { return c; }
+};
+
+// Show the games another process publishes with --live, until interrupted. Runs that
+// end are followed by the next one to publish under the same name.
+static int runViewer(const std::string& name, double fps) {
+    std::signal(SIGINT, stopViewer);
+    std::signal(SIGTERM, stopViewer);
+    auto interval = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::duration<double>(1.0 / fps));
+    LiveStateView view(name);
+    LiveFrame frame;
+    TerminalRenderer renderer(std::cout);
+    bool waiting = false;
+    while (!viewerStopped) {
+        if (!view.attached()) {
+            if (!view.attach()) {
+                if (!waiting) {
+                    std::cout << "Waiting for live state " << name << "..." << std::endl;
+                    waiting = true;
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(100));
+                continue;
+            }
+            std::cout << "Attached to " << name << std::endl;
+            waiting = false;
+            frame = LiveFrame();
+        }
+        // Checked first, so the last frame of a closed run is still shown
+        bool closed = view.writerClosed();
+        if (view.poll(frame)) {
+            std::string title = frame.mapName + " - game " + std::to_string(frame.game);
+            renderer.draw(title, frame.round, frame.rows, frame.columns, frame.cells.data());
+        } else if (closed) {
+            renderer.reset();
+            std::cout << "Live state " << name << " closed" << std::endl;
+            view.detach();
+            continue;
+        }
+        std::this_thread::sleep_for(interval);
+    }
+    return 0;
+}
+
+static void printBatchResults(const std::vector<BatchEntry>& entries) {
+    for (const auto& entry : entries) {
+        std::cout << entry.boardFile << ": ";
+        if (entry.crashed) {
+            std::cout << "crashed - " << entry.error << std::endl;
+        } else if (entry.failed) {
+            std::cout << "failed - " << entry.error << std::endl;
+        } else if (entry.result.winner == 0) {
+            std::cout << "tie after " << entry.result.rounds << " rounds"
+                      << (entry.cached ? " (cached)" : "") << std::endl;
+        } else {
+            std::cout << "player " << entry.result.winner << " won after " << entry.result.rounds
+                      << " rounds" << (entry.cached ? " (cached)" : "") << std::endl;
+        }
+    }
+}
+
 int main(int argc, char** argv) {
-    if (argc != 2) {
-        std::cerr << "Usage: " << argv[0] << " <game_board_input_file>" << std::endl;
+    std::vector<std::string> boardFiles;
+    bool fastForwardCycles = false;
+    bool useMcts = false;
+    bool pinThreads = false;
+    bool isolate = false;  // Play batch games in worker processes
+    bool lockstep = false;  // Play batch games side by side, results only
+    bool parallelSearch = false;  // Split path searches on huge boards across the pool
+    bool boardCache = false;  // Load boards from binary sidecars written on first read
+    bool writeStats = false;
+    std::string cacheFile;  // Empty for no result cache
+    bool writeLatency = false;
+    double slowMs = 0;  // Report decisions slower than this, 0 for none
+    bool slowDoNothing = false;
+    unsigned jobs = 0;  // 0 uses the hardware concurrency
+    long long gameTimeoutMs = 0;  // Per game in isolated batches, 0 for none
+    std::string liveName;  // Shared memory to publish rounds to, empty for none
+    std::string viewName;  // Shared memory to show rounds from instead of playing
+    bool terminalView = false;  // Redraw the board in place instead of logging
+    double viewFps = 0;  // Frame rate limit of either view, 0 for the default
+    MctsConfig mctsConfig;
+    const long long MAX_THREADS = 1024;
+    const double MAX_FPS = 1000;
+    long long number = 0;
+    for (int i = 1; i < argc; i++) {
+        std::string option = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (option.rfind("--", 0) != 0) {
+            boardFiles.push_back(option);
+        } else if (option == "--fast-forward-cycles") {
+            fastForwardCycles = true;
+        } else if (option == "--mcts") {
+            useMcts = true;
+        } else if (option == "--mcts-threads" && hasValue) {
+            if (!parseInteger(argv[++i], 1, MAX_THREADS, number)) {
+                return invalidValue(argv[0], option, argv[i]);
+            }
+            mctsConfig.threads = static_cast<unsigned>(number);
+            useMcts = true;
+        } else if (option == "--mcts-rollouts" && hasValue) {
+            if (!parseInteger(argv[++i], 1, INT_MAX, number)) {
+                return invalidValue(argv[0], option, argv[i]);
+            }
+            mctsConfig.rolloutsPerTurn = static_cast<int>(number);
+            useMcts = true;
+        } else if (option == "--mcts-time-ms" && hasValue) {
+            if (!parseInteger(argv[++i], 0, INT_MAX, number)) {
+                return invalidValue(argv[0], option, argv[i]);
+            }
+            mctsConfig.timeBudgetMs = static_cast<int>(number);
+            useMcts = true;
+        } else if (option == "--jobs" && hasValue) {
+            if (!parseInteger(argv[++i], 0, MAX_THREADS, number)) {
+                return invalidValue(argv[0], option, argv[i]);
+            }
+            jobs = static_cast<unsigned>(number);
+        } else if (option == "--pin-threads") {
+            pinThreads = true;
+        } else if (option == "--isolate") {
+            isolate = true;
+        } else if (option == "--game-timeout-ms" && hasValue) {
+            if (!parseInteger(argv[++i], 0, INT_MAX, gameTimeoutMs)) {
+                return invalidValue(argv[0], option, argv[i]);
+            }
+        } else if (option == "--lockstep") {
+            lockstep = true;
+        } else if (option == "--parallel-search") {
+            parallelSearch = true;
+        } else if (option == "--board-cache") {
+            boardCache = true;
+        } else if (option == "--stats") {
+            writeStats = true;
+        } else if (option == "--cache" && hasValue) {
+            cacheFile = argv[++i];
+        } else if (option == "--latency") {
+            writeLatency = true;
+        } else if (option == "--report-slow-ms" && hasValue) {
+            if (!parseNumber(argv[++i], 0, INT_MAX, slowMs)) {
+                return invalidValue(argv[0], option, argv[i]);
+            }
+        } else if (option == "--slow-do-nothing") {
+            slowDoNothing = true;
+        } else if (option == "--live" && hasValue) {
+            liveName = argv[++i];
+        } else if (option == "--view" && hasValue) {
+            viewName = argv[++i];
+        } else if (option == "--terminal-view") {
+            terminalView = true;
+        } else if (option == "--view-fps" && hasValue) {
+            if (!parseNumber(argv[++i], 0, MAX_FPS, viewFps)) {
+                return invalidValue(argv[0], option, argv[i]);
+            }
+        } else {
+            std::cerr << "Unknown option: " << option << std::endl;
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+    if (!viewName.empty()) {
+        if (!boardFiles.empty() || terminalView) {
+            printUsage(argv[0]);
+            return 1;
+        }
+        return runViewer(viewName, viewFps > 0 ? viewFps : 10);
+    }
+    if (boardFiles.empty()) {
+        printUsage(argv[0]);
         return 1;
     }
+    if (isolate && lockstep) {
+        std::cerr << "--isolate and --lockstep cannot be combined" << std::endl;
+        return 1;
+    }
+    if ((isolate || lockstep) && boardFiles.size() < 2) {
+        std::cerr << (isolate ? "--isolate" : "--lockstep") << " runs a batch and needs several boards" << std::endl;
+        return 1;
+    }
+    if (gameTimeoutMs > 0 && !isolate) {
+        std::cerr << "--game-timeout-ms needs --isolate" << std::endl;
+        return 1;
+    }
+    if (terminalView && boardFiles.size() > 1) {
+        std::cerr << "--terminal-view shows a single game" << std::endl;
+        return 1;
+    }
+    if (slowDoNothing && slowMs <= 0) {
+        std::cerr << "--slow-do-nothing needs --report-slow-ms" << std::endl;
+        return 1;
+    }
+    auto slowLimit = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::duration<double, std::milli>(slowMs));
+
+    // One pool serves both parallel games and parallel searches. Worker processes are
+    // forked from this one and must not inherit running threads, so isolated batches
+    // play their games, and the searches in them, on a single thread per process.
+    bool isolatedBatch = isolate && boardFiles.size() > 1;
+    std::unique_ptr<WorkStealingPool> pool;
+    if (!isolatedBatch && (boardFiles.size() > 1 || (useMcts && mctsConfig.threads > 1) || parallelSearch)) {
+        pool = std::make_unique<WorkStealingPool>(jobs, pinThreads);
+        mctsConfig.pool = pool.get();
+    }
+
+    // Made before any worker process is forked, so their games can stream to it too
+    std::unique_ptr<LiveStateExport> liveExport;
+    if (!liveName.empty()) {
+        if (lockstep) {
+            std::cerr << "Lockstep batches do not publish live state" << std::endl;
+        }
+        liveExport = std::make_unique<LiveStateExport>(liveName);
+    }
 
     MyPlayerFactory playerFactory;
-    MyTankAlgorithmFactory algorithmFactory;
+    MyTankAlgorithmFactory algorithmFactory(useMcts ? MyTankAlgorithmFactory::Strategy::Mcts
+                                                    : MyTankAlgorithmFactory::Strategy::Mixed,
+                                            mctsConfig);
+    if (parallelSearch) {
+        algorithmFactory.setSearchPool(pool.get());
+    }
+    if (boardFiles.size() > 1) {
+        std::unique_ptr<BatchRunner> batchRunner = isolatedBatch
+            ? std::make_unique<BatchRunner>(playerFactory, algorithmFactory)
+            : std::make_unique<BatchRunner>(playerFactory, algorithmFactory, *pool);
+        BatchRunner& batch = *batchRunner;
+        batch.setCycleFastForward(fastForwardCycles);
+        batch.setStatsOutput(writeStats);
+        batch.setLatencyOutput(writeLatency);
+        batch.setBoardCache(boardCache);
+        batch.setSlowDecisionReport(slowLimit, slowDoNothing);
+        batch.setLiveExport(liveExport.get());
+        batch.setGameTimeout(std::chrono::milliseconds(gameTimeoutMs));
+        std::unique_ptr<ResultCache> cache;
+        if (!cacheFile.empty()) {
+            std::string tag = algorithmFactory.versionTag();
+            // Replacing slow actions makes results depend on the machine as well
+            if (tag.empty() || slowDoNothing) {
+                std::cerr << "Results of these algorithms are not reproducible, not using the cache" << std::endl;
+            } else {
+                cache = std::make_unique<ResultCache>(cacheFile);
+                batch.setResultCache(cache.get(), tag);
+            }
+        }
+        if (isolatedBatch) {
+            printBatchResults(batch.runIsolated(boardFiles, jobs));
+        } else if (lockstep) {
+            printBatchResults(batch.runLockstep(boardFiles));
+        } else {
+            printBatchResults(batch.run(boardFiles));
+        }
+        // Worker processes keep their own counts, so this only covers games played in this one
+        AllocationStats::printReport(std::cout);
+        return 0;
+    }
+
     GameManager game(playerFactory, algorithmFactory);
-    game.readBoard(argv[1]);
+    game.setCycleFastForward(fastForwardCycles);
+    game.setStatsOutput(writeStats);
+    game.setLatencyOutput(writeLatency);
+    game.setBoardCache(boardCache);
+    game.setSlowDecisionReport(slowLimit, slowDoNothing);
+    game.setLiveExport(liveExport.get());
+    // The view draws to the real stdout; everything else logged to cout is dropped meanwhile
+    std::ostream screen(std::cout.rdbuf());
+    NullBuffer discarded;
+    std::unique_ptr<TerminalRenderer> renderer;
+    if (terminalView) {
+        renderer = std::make_unique<TerminalRenderer>(screen, viewFps);
+        game.setTerminalView(renderer.get());
+        std::cout.rdbuf(&discarded);
+    }
+    game.readBoard(boardFiles[0]);
     game.run();
+    if (terminalView) {
+        renderer.reset();
+        std::cout.rdbuf(screen.rdbuf());
+    }
+    AllocationStats::printReport(std::cout);
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,187 @@
+// Compares WorkStealingPool with the single shared queue it replaced: one mutex, one
+// condition variable, every worker taking from the same deque. Two loads:
+//   flat   - many tiny tasks submitted from outside the pool
+//   nested - tasks that fan out subtasks and wait for them, helping meanwhile
+// Usage: pool_bench [threads] [repeats]
+#include "../common/WorkStealingPool.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+    class SharedQueuePool {
+    public:
+        explicit SharedQueuePool(unsigned threads) : stopping(false) {
+            for (unsigned i = 0; i < threads; i++) {
+                workers.emplace_back([this]() { workerLoop(); });
+            }
+        }
+
+        ~SharedQueuePool() {
+            {
+                std::lock_guard<std::mutex> guard(lock);
+                stopping = true;
+            }
+            wake.notify_all();
+            for (std::thread& worker : workers) {
+                worker.join();
+            }
+        }
+
+        void submit(std::function<void()> task) {
+            {
+                std::lock_guard<std::mutex> guard(lock);
+                tasks.push_back(std::move(task));
+            }
+            wake.notify_one();
+        }
+
+        bool runPendingTask() {
+            std::function<void()> task;
+            {
+                std::lock_guard<std::mutex> guard(lock);
+                if (tasks.empty()) {
+                    return false;
+                }
+                task = std::move(tasks.front());
+                tasks.pop_front();
+            }
+            task();
+            return true;
+        }
+
+    private:
+        std::mutex lock;
+        std::condition_variable wake;
+        std::deque<std::function<void()>> tasks;
+        std::vector<std::thread> workers;
+        bool stopping;
+
+        void workerLoop() {
+            while (true) {
+                std::function<void()> task;
+                {
+                    std::unique_lock<std::mutex> guard(lock);
+                    wake.wait(guard, [this]() { return stopping || !tasks.empty(); });
+                    if (tasks.empty()) {
+                        return;
+                    }
+                    task = std::move(tasks.front());
+                    tasks.pop_front();
+                }
+                task();
+            }
+        }
+    };
+
+    // Counts finished tasks; waiting helps the pool until all of them are done
+    template <typename Pool>
+    void waitFor(Pool& pool, const std::atomic<int>& done, int expected) {
+        while (done.load() < expected) {
+            if (!pool.runPendingTask()) {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    volatile unsigned sink = 0;
+
+    void tinyWork(unsigned seed) {
+        unsigned value = seed;
+        for (int i = 0; i < 64; i++) {
+            value = value * 1664525u + 1013904223u;
+        }
+        sink = value;
+    }
+
+    const int FLAT_TASKS = 200000;
+    const int NESTED_OUTER = 2000;
+    const int NESTED_INNER = 64;
+
+    template <typename Pool>
+    void flatLoad(Pool& pool) {
+        std::atomic<int> done(0);
+        for (int i = 0; i < FLAT_TASKS; i++) {
+            pool.submit([&done, i]() {
+                tinyWork(static_cast<unsigned>(i));
+                done++;
+            });
+        }
+        waitFor(pool, done, FLAT_TASKS);
+    }
+
+    template <typename Pool>
+    void nestedLoad(Pool& pool) {
+        std::atomic<int> outerDone(0);
+        for (int i = 0; i < NESTED_OUTER; i++) {
+            pool.submit([&pool, &outerDone, i]() {
+                std::atomic<int> innerDone(0);
+                for (int j = 0; j < NESTED_INNER; j++) {
+                    pool.submit([&innerDone, i, j]() {
+                        tinyWork(static_cast<unsigned>(i * NESTED_INNER + j));
+                        innerDone++;
+                    });
+                }
+                waitFor(pool, innerDone, NESTED_INNER);
+                outerDone++;
+            });
+        }
+        waitFor(pool, outerDone, NESTED_OUTER);
+    }
+
+    // Best of repeats, in milliseconds
+    template <typename Run>
+    double bestOf(int repeats, Run run) {
+        double best = 0;
+        for (int i = 0; i < repeats; i++) {
+            auto start = std::chrono::steady_clock::now();
+            run();
+            double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            best = (i == 0) ? ms : std::min(best, ms);
+        }
+        return best;
+    }
+
+    void report(const char* load, int tasks, double sharedMs, double stealingMs) {
+        std::printf("%-7s %8d tasks  shared queue %9.1f ms  work stealing %9.1f ms  speedup %.2fx\n",
+                    load, tasks, sharedMs, stealingMs, sharedMs / stealingMs);
+    }
+}
+
+int main(int argc, char* argv[]) {
+    unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+    int repeats = 5;
+    if (argc > 1) {
+        threads = static_cast<unsigned>(std::max(1, std::stoi(argv[1])));
+    }
+    if (argc > 2) {
+        repeats = std::max(1, std::stoi(argv[2]));
+    }
+    std::printf("%u worker threads, best of %d\n", threads, repeats);
+
+    double sharedFlat;
+    double sharedNested;
+    {
+        SharedQueuePool pool(threads);
+        sharedFlat = bestOf(repeats, [&pool]() { flatLoad(pool); });
+        sharedNested = bestOf(repeats, [&pool]() { nestedLoad(pool); });
+    }
+    double stealingFlat;
+    double stealingNested;
+    {
+        WorkStealingPool pool(threads);
+        stealingFlat = bestOf(repeats, [&pool]() { flatLoad(pool); });
+        stealingNested = bestOf(repeats, [&pool]() { nestedLoad(pool); });
+    }
+    report("flat", FLAT_TASKS, sharedFlat, stealingFlat);
+    report("nested", NESTED_OUTER * NESTED_INNER, sharedNested, stealingNested);
+    return 0;
+}
@@ -0,0 +1,26 @@
+#pragma once
+#include <cstddef>
+#include <climits>
+
+using namespace std;
+
+// What the game knows about the board beyond its cells. The game's own maps implement
+// these, and GameSatelliteView hands them on to the algorithms through SatelliteView.
+
+// Predicted shell arrivals per cell
+class ShellForecast {
+public:
+    static constexpr int NO_SHELL = INT_MAX;
+
+    virtual ~ShellForecast() {}
+    // Rounds after currentRound until the next predicted shell reaches (x, y), NO_SHELL if none
+    virtual int getRoundsUntilShell(size_t x, size_t y, int currentRound) const = 0;
+};
+
+// Cells a tank can reach from each other without shooting
+class ComponentIndex {
+public:
+    virtual ~ComponentIndex() {}
+    // Cells with the same component are connected
+    virtual int componentOf(size_t x, size_t y) const = 0;
+};
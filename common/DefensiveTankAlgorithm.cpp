@@ -1,13 +1,15 @@
 #include "DefensiveTankAlgorithm.h"
 #include "SatelliteBattleInfo.h"
+#include <algorithm>
 #include <cmath>
 #include <iostream>
 #include "ActionRequest.h"
 #include "BoardConstants.h"
+#include "Directions.h"
 
 DefensiveTankAlgorithm::DefensiveTankAlgorithm() 
-    : boardWidth(0), boardHeight(0), turnCounter(0), tankX(-1), tankY(-1),
-      dirX(0), dirY(0), directionInitialized(false)
+    : infoTurn(0), boardWidth(0), boardHeight(0), turnCounter(0), tankX(-1), tankY(-1),
+      playerIndex(0), nextShootTurn(0), dirX(0), dirY(0), directionInitialized(false)
 {
     // Initialize defensive strategy
 }
@@ -17,6 +19,22 @@ DefensiveTankAlgorithm::~DefensiveTankAlgorithm()
     // Cleanup if needed
 }
 
+bool DefensiveTankAlgorithm::hashState(uint64_t& hash) const {
+    // The turn counter only matters modulo the battle info period and relative to the
+    // last info and the next allowed shot
+    for (int value : {boardWidth, boardHeight, tankX, tankY, playerIndex, dirX, dirY, int(directionInitialized),
+                      turnCounter % 4, turnCounter - infoTurn, std::max(0, nextShootTurn - turnCounter)}) {
+        mixState(hash, static_cast<uint64_t>(static_cast<int64_t>(value)));
+    }
+    for (const auto& row : board) {
+        mixState(hash, row.data(), row.size());
+    }
+    for (const auto& row : shellEta) {
+        mixState(hash, row.data(), row.size() * sizeof(int));
+    }
+    return true;
+}
+
 bool DefensiveTankAlgorithm::shouldGetBattleInfo() const {
     // Get battle info on first turn (turnCounter == 0) and every 4 turns after
     return turnCounter == 0 || turnCounter % 4 == 0;
@@ -64,98 +82,39 @@ bool DefensiveTankAlgorithm::isShellNearby(int tankX, int tankY) const {
     return false;
 }
 
-bool DefensiveTankAlgorithm::isInDanger() const {
-    // Check in 8 directions (horizontal, vertical, and diagonal)
-    const int directions[8][2] = {
-        {-1, -1}, {-1, 0}, {-1, 1},  // top-left, top, top-right
-        {0, -1},           {0, 1},   // left, right
-        {1, -1},  {1, 0},  {1, 1}    // bottom-left, bottom, bottom-right
-    };
-
-    for (const auto& dir : directions) {
-        // Check up to 2 spaces in each direction
-        for (int distance = 1; distance <= 2; distance++) {
-            int checkY = (tankY + dir[0] * distance + boardHeight) % boardHeight;
-            int checkX = (tankX + dir[1] * distance + boardWidth) % boardWidth;
-            
-            char cell = board[checkY][checkX];
-            bool isShell = cell == BoardConstants::SHELL;
-            
-            if (isShell) {
-                return true;
-            }
-            
-            // If we hit a wall, stop checking in this direction
-            if (cell == BoardConstants::WALL || cell == BoardConstants::DAMAGED_WALL) {
-                break;
-            }
-        }
+bool DefensiveTankAlgorithm::isCellThreatened(int x, int y) const {
+    if (shellEta.empty()) {
+        return false;
     }
-    return false;
+    int eta = shellEta[y][x];
+    if (eta == SatelliteBattleInfo::NO_SHELL) {
+        return false;
+    }
+    // The prediction is relative to the round the info arrived in; shells have moved since
+    int roundsSinceInfo = turnCounter - infoTurn + 1;
+    int remaining = eta - roundsSinceInfo;
+    return remaining >= 1 && remaining <= 2;
+}
+
+bool DefensiveTankAlgorithm::isInDanger() const {
+    // A shell is predicted to reach our cell within the next two rounds
+    return isCellThreatened(tankX, tankY);
 }
 
 void DefensiveTankAlgorithm::updateDirection(ActionRequest action) {
-    int newDirX, newDirY;
+    int offset = 0;
     switch (action) {
-        case ActionRequest::MoveForward:
-        case ActionRequest::MoveBackward:
-        case ActionRequest::Shoot:
-        case ActionRequest::GetBattleInfo:
-        case ActionRequest::DoNothing:
-            // No direction change needed for these actions
-            break;
-        case ActionRequest::RotateLeft45:
-            // Rotate 45 degrees left: (x,y) -> ((x-y)/√2, (x+y)/√2)
-            // Since we only use -1,0,1, we can simplify to:
-            if (dirX == 0) {
-                dirX = -dirY;
-                dirY = 0;
-            } else if (dirY == 0) {
-                dirY = dirX;
-                dirX = 0;
-            } else {
-                // For diagonal directions, we need to handle both components
-                newDirX = (dirX == dirY) ? -dirX : 0;
-                newDirY = (dirX == dirY) ? 0 : dirX;
-                dirX = newDirX;
-                dirY = newDirY;
-            }
-            break;
-
-        case ActionRequest::RotateRight45:
-            // Rotate 45 degrees right: (x,y) -> ((x+y)/√2, (y-x)/√2)
-            // Since we only use -1,0,1, we can simplify to:
-            if (dirX == 0) {
-                dirX = dirY;
-                dirY = 0;
-            } else if (dirY == 0) {
-                dirY = -dirX;
-                dirX = 0;
-            } else {
-                // For diagonal directions, we need to handle both components
-                newDirX = (dirX == -dirY) ? 0 : dirY;
-                newDirY = (dirX == -dirY) ? dirX : 0;
-                dirX = newDirX;
-                dirY = newDirY;
-            }
-            break;
-
-        case ActionRequest::RotateLeft90:
-            // Rotate 90 degrees left: (x,y) -> (y,-x)
-            newDirX = dirY;
-            newDirY = -dirX;
-            dirX = newDirX;
-            dirY = newDirY;
-            break;
-
-        case ActionRequest::RotateRight90:
-            // Rotate 90 degrees right: (x,y) -> (-y,x)
-            newDirX = -dirY;
-            newDirY = dirX;
-            dirX = newDirX;
-            dirY = newDirY;
-            break;
+        case ActionRequest::RotateLeft45:  offset = -1; break;
+        case ActionRequest::RotateRight45: offset = +1; break;
+        case ActionRequest::RotateLeft90:  offset = -2; break;
+        case ActionRequest::RotateRight90: offset = +2; break;
+        default: return; // No direction change needed for other actions
     }
+
+    // Same clockwise direction cycle the game uses, so the tracked direction stays in sync
+    int newIndex = Directions::rotate(Directions::indexOf(dirX, dirY), offset);
+    dirX = Directions::dx(newIndex);
+    dirY = Directions::dy(newIndex);
 }
 
 void DefensiveTankAlgorithm::updateBattleInfo(BattleInfo& info)
@@ -169,6 +128,8 @@ void DefensiveTankAlgorithm::updateBattleInfo(BattleInfo& info)
     
     // Get a copy of the board directly
     board = satelliteInfo.getBoard();
+    shellEta = satelliteInfo.getShellEta();
+    infoTurn = turnCounter;
     
     // Update tank position
     tankX = satelliteInfo.getTankX();
@@ -180,7 +141,7 @@ void DefensiveTankAlgorithm::updateBattleInfo(BattleInfo& info)
     // Initialize direction if not done yet
     if (!directionInitialized) {
         // Player 1 starts pointing left, Player 2 starts pointing right
-        dirX = (playerIndex == 1) ? -1 : 1;
+        dirX = BoardConstants::startingDx(playerIndex);
         dirY = 0;
         directionInitialized = true;
     }
@@ -230,14 +191,14 @@ ActionRequest DefensiveTankAlgorithm::wrapRotateRight90() {
 bool DefensiveTankAlgorithm::isAllyTankInDirection() const {
     // Check up to 2 spaces in the current direction
     for (int distance = 1; distance <= max(boardHeight, boardWidth); distance++) {
-        int checkY = (tankY + dirY * distance + boardHeight) % boardHeight;
-        int checkX = (tankX + dirX * distance + boardWidth) % boardWidth;
+        // Distance may exceed the board size, so wrap with a non-negative modulo
+        int checkY = ((tankY + dirY * distance) % boardHeight + boardHeight) % boardHeight;
+        int checkX = ((tankX + dirX * distance) % boardWidth + boardWidth) % boardWidth;
         
         char cell = board[checkY][checkX];
         std::cout << "Checking cell: " << checkX << ", " << checkY << " with value: " << cell << std::endl;
         // Check for ally tank based on player index
-        if ((playerIndex == 1 && cell == BoardConstants::PLAYER1_TANK) ||
-            (playerIndex == 2 && cell == BoardConstants::PLAYER2_TANK)) {
+        if (cell == BoardConstants::tankChar(playerIndex)) {
             return true;
         }
         
@@ -268,7 +229,8 @@ ActionRequest DefensiveTankAlgorithm::getAction()
         if (nextCell != BoardConstants::MINE && 
             nextCell != BoardConstants::WALL && 
             nextCell != BoardConstants::DAMAGED_WALL &&
-            nextCell != BoardConstants::SHELL) {
+            nextCell != BoardConstants::SHELL &&
+            !isCellThreatened(nextX, nextY)) {
             return wrapMoveForward();
         }
         else {
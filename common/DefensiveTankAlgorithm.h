@@ -12,9 +12,12 @@ public:
     
     ActionRequest getAction() override;
     void updateBattleInfo(BattleInfo& info) override;
+    bool hashState(uint64_t& hash) const override;
 
 private:
     std::vector<std::vector<char>> board;
+    std::vector<std::vector<int>> shellEta;  // Shell arrival predictions from the last battle info
+    int infoTurn;  // turnCounter value when the last battle info arrived
     int boardWidth;
     int boardHeight;
     int turnCounter;
@@ -32,6 +35,7 @@ private:
     bool hasLineOfSight(int x1, int y1, int x2, int y2) const;
     bool shouldGetBattleInfo() const;
     bool isInDanger() const;
+    bool isCellThreatened(int x, int y) const;
     bool isAllyTankInDirection() const;
     void updateDirection(ActionRequest action);
     ActionRequest wrapMoveForward();
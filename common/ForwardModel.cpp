@@ -0,0 +1,197 @@
+#include "ForwardModel.h"
+#include "../constants/BoardConstants.h"
+
+using namespace BoardConstants;
+
+ForwardModel::ForwardModel() : rows(0), columns(0) {}
+
+ForwardModel::ForwardModel(int rows, int columns)
+    : rows(rows), columns(columns), cells(static_cast<size_t>(rows) * columns, EMPTY_SPACE) {}
+
+size_t ForwardModel::addTank(int x, int y, int direction, int player, int numShells) {
+    tanks.push_back({x, y, direction, player, 0, numShells, true, false, 0, x, y, false});
+    return tanks.size() - 1;
+}
+
+void ForwardModel::addShell(int x, int y, int direction) {
+    shells.push_back({x, y, direction});
+}
+
+int ForwardModel::countAlive(int player) const {
+    int count = 0;
+    for (const auto& tank : tanks) {
+        if (tank.alive && tank.player == player) {
+            count++;
+        }
+    }
+    return count;
+}
+
+void ForwardModel::step(const vector<ActionRequest>& actions) {
+    beginRound();
+    moveShells();
+    moveShells();
+    for (size_t i = 0; i < tanks.size(); i++) {
+        applyAction(tanks[i], i < actions.size() ? actions[i] : ActionRequest::DoNothing);
+    }
+    checkSwaps();
+}
+
+void ForwardModel::beginRound() {
+    for (auto& tank : tanks) {
+        if (tank.shootCooldown > 0) {
+            tank.shootCooldown--;
+        }
+        if (tank.movingBackward) {
+            tank.backwardCounter++;
+        }
+        tank.moved = false;
+    }
+}
+
+bool ForwardModel::killTankAt(int x, int y) {
+    for (auto& tank : tanks) {
+        if (tank.alive && tank.x == x && tank.y == y) {
+            tank.alive = false;
+            return true;
+        }
+    }
+    return false;
+}
+
+void ForwardModel::moveShells() {
+    nextCell.resize(shells.size());
+    shellDestroyed.assign(shells.size(), false);
+    for (size_t i = 0; i < shells.size(); i++) {
+        int d = shells[i].direction;
+        nextCell[i] = static_cast<int>(index(wrapX(shells[i].x, Directions::dx(d)), wrapY(shells[i].y, Directions::dy(d))));
+    }
+
+    // Resolve each target cell once, the first shell heading there handles it
+    for (size_t i = 0; i < shells.size(); i++) {
+        bool firstForCell = true;
+        size_t sharing = 0;
+        for (size_t j = 0; j < shells.size(); j++) {
+            if (nextCell[j] == nextCell[i]) {
+                firstForCell = firstForCell && j >= i;
+                sharing++;
+            }
+        }
+        if (!firstForCell) {
+            continue;
+        }
+
+        int x = nextCell[i] % columns;
+        int y = nextCell[i] / columns;
+        char& cell = cells[nextCell[i]];
+        bool collision = true;
+        if (sharing > 1) {
+            // Multiple shells destroy everything in the cell
+            killTankAt(x, y);
+            cell = EMPTY_SPACE;
+        } else if (killTankAt(x, y)) {
+            // Shell hit a tank
+        } else if (cell == WALL) {
+            cell = DAMAGED_WALL;
+        } else if (cell == DAMAGED_WALL) {
+            cell = EMPTY_SPACE;
+        } else {
+            collision = false;  // Empty space or a mine the shell flies over
+        }
+
+        if (collision) {
+            for (size_t j = i; j < shells.size(); j++) {
+                if (nextCell[j] == nextCell[i]) {
+                    shellDestroyed[j] = true;
+                }
+            }
+        }
+    }
+
+    size_t kept = 0;
+    for (size_t i = 0; i < shells.size(); i++) {
+        if (shellDestroyed[i]) {
+            continue;
+        }
+        shells[kept] = shells[i];
+        shells[kept].x = nextCell[i] % columns;
+        shells[kept].y = nextCell[i] / columns;
+        kept++;
+    }
+    shells.resize(kept);
+}
+
+void ForwardModel::applyAction(ModelTank& tank, ActionRequest action) {
+    if (!tank.alive) {
+        return;
+    }
+
+    // During a backward move sequence only a forward move is accepted, and it cancels the sequence
+    if (tank.movingBackward) {
+        if (action == ActionRequest::MoveForward) {
+            tank.movingBackward = false;
+            tank.backwardCounter = 0;
+        }
+        return;
+    }
+
+    switch (action) {
+        case ActionRequest::MoveForward: {
+            int nextX = wrapX(tank.x, Directions::dx(tank.direction));
+            int nextY = wrapY(tank.y, Directions::dy(tank.direction));
+            char cell = getCell(nextX, nextY);
+            if (cell == WALL || cell == DAMAGED_WALL) {
+                break;
+            }
+            tank.prevX = tank.x;
+            tank.prevY = tank.y;
+            tank.x = nextX;
+            tank.y = nextY;
+            tank.moved = true;
+            break;
+        }
+        case ActionRequest::MoveBackward:
+            tank.movingBackward = true;
+            tank.backwardCounter = 0;
+            break;
+        case ActionRequest::RotateLeft90:
+            tank.direction = Directions::rotate(tank.direction, -2);
+            break;
+        case ActionRequest::RotateRight90:
+            tank.direction = Directions::rotate(tank.direction, 2);
+            break;
+        case ActionRequest::RotateLeft45:
+            tank.direction = Directions::rotate(tank.direction, -1);
+            break;
+        case ActionRequest::RotateRight45:
+            tank.direction = Directions::rotate(tank.direction, 1);
+            break;
+        case ActionRequest::Shoot:
+            if (tank.shootCooldown == 0 && tank.numShells > 0) {
+                addShell(tank.x, tank.y, tank.direction);
+                tank.shootCooldown = SHOOT_COOLDOWN;
+                tank.numShells--;
+            }
+            break;
+        case ActionRequest::GetBattleInfo:
+        case ActionRequest::DoNothing:
+            break;
+    }
+}
+
+void ForwardModel::checkSwaps() {
+    for (size_t i = 0; i < tanks.size(); i++) {
+        ModelTank& a = tanks[i];
+        if (!a.alive || !a.moved) {
+            continue;
+        }
+        for (size_t j = i + 1; j < tanks.size(); j++) {
+            ModelTank& b = tanks[j];
+            if (b.alive && b.moved && a.prevX == b.x && a.prevY == b.y && b.prevX == a.x && b.prevY == a.y) {
+                a.alive = false;
+                b.alive = false;
+                break;
+            }
+        }
+    }
+}
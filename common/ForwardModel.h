@@ -0,0 +1,73 @@
+#pragma once
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include "ActionRequest.h"
+#include "../constants/Directions.h"
+
+using namespace std;
+
+struct ModelTank {
+    int x, y;
+    int direction;        // Index into Directions::VECTORS
+    int player;
+    int shootCooldown;
+    int numShells;
+    bool alive;
+    bool movingBackward;
+    int backwardCounter;
+    int prevX, prevY;     // Position before this round's move, for swap detection
+    bool moved;
+};
+
+struct ModelShell {
+    int x, y;
+    int direction;
+};
+
+// Compact, cheaply copyable model of the game rules for search-based algorithms.
+// Mirrors GameManager's round structure without any I/O: tanks begin the round
+// (cooldown and backward-move counters), shells move twice, tanks act in order,
+// then tanks that swapped places are destroyed.
+class ForwardModel {
+public:
+    static constexpr int SHOOT_COOLDOWN = 4;
+
+    ForwardModel();
+    ForwardModel(int rows, int columns);
+
+    int getRows() const { return rows; }
+    int getColumns() const { return columns; }
+    char getCell(int x, int y) const { return cells[index(x, y)]; }
+    void setCell(int x, int y, char cell) { cells[index(x, y)] = cell; }
+
+    size_t addTank(int x, int y, int direction, int player, int numShells);
+    void addShell(int x, int y, int direction);
+
+    vector<ModelTank>& getTanks() { return tanks; }
+    const vector<ModelTank>& getTanks() const { return tanks; }
+    const vector<ModelShell>& getShells() const { return shells; }
+    int countAlive(int player) const;
+
+    // Play one full round; actions holds one entry per tank, in tank order
+    void step(const vector<ActionRequest>& actions);
+
+private:
+    int rows;
+    int columns;
+    vector<char> cells;  // Only walls, damaged walls, mines and empty space
+    vector<ModelTank> tanks;
+    vector<ModelShell> shells;
+    vector<int> nextCell;         // Scratch for shell movement
+    vector<char> shellDestroyed;
+
+    size_t index(int x, int y) const { return static_cast<size_t>(y) * columns + x; }
+    int wrapX(int x, int dx) const { return static_cast<int>(Directions::wrapStep(x, dx, columns)); }
+    int wrapY(int y, int dy) const { return static_cast<int>(Directions::wrapStep(y, dy, rows)); }
+
+    void beginRound();
+    void moveShells();
+    void applyAction(ModelTank& tank, ActionRequest action);
+    void checkSwaps();
+    bool killTankAt(int x, int y);
+};
@@ -1,43 +1,59 @@
-#include "GameSatelliteView.h"
-
-GameSatelliteView::GameSatelliteView(const vector<vector<char>>& board, size_t rows, size_t columns,
-                                   size_t requestingTankX, size_t requestingTankY)
-    : board(board), rows(rows), columns(columns), 
-      requestingTankX(requestingTankX), requestingTankY(requestingTankY) {}
-
-GameSatelliteView::~GameSatelliteView() {}
-
-char GameSatelliteView::getObjectAt(size_t x, size_t y) const {
-    // Check if coordinates are out of bounds
-    if (x >= columns || y >= rows) {
-        return BoardConstants::INVALID_LOCATION;
-    }
-
-    // If this is the requesting tank's position, return '%'
-    if (x == requestingTankX && y == requestingTankY) {
-        return '%';
-    }
-
-    // Get the character at the specified location
-    char cell = board[y][x];
-
-    // Map the cell character to the satellite view character according to rules
-    switch (cell) {
-        case BoardConstants::WALL:
-        case BoardConstants::DAMAGED_WALL:
-            return '#';
-        case BoardConstants::PLAYER1_TANK:
-            return '1';
-        case BoardConstants::PLAYER2_TANK:
-            return '2';
-        case BoardConstants::MINE:
-            return '@';
-        case BoardConstants::SHELL:
-        case BoardConstants::MINE_SHELL_COLLISION:
-            return '*';
-        case BoardConstants::EMPTY_SPACE:
-            return ' ';
-        default:
-            return ' ';  // Default to empty space for any other characters
-    }
-}
\ No newline at end of file
+#include "GameSatelliteView.h"
+
+GameSatelliteView::GameSatelliteView(const vector<vector<char>>& board, size_t rows, size_t columns,
+                                   size_t requestingTankX, size_t requestingTankY,
+                                   const ShellForecast* shellForecast, int currentRound,
+                                   const ComponentIndex* components)
+    : board(board), rows(rows), columns(columns), 
+      requestingTankX(requestingTankX), requestingTankY(requestingTankY),
+      shellForecast(shellForecast), currentRound(currentRound), components(components) {}
+
+GameSatelliteView::~GameSatelliteView() {}
+
+char GameSatelliteView::getObjectAt(size_t x, size_t y) const {
+    // Check if coordinates are out of bounds
+    if (x >= columns || y >= rows) {
+        return BoardConstants::INVALID_LOCATION;
+    }
+
+    // If this is the requesting tank's position, return '%'
+    if (x == requestingTankX && y == requestingTankY) {
+        return '%';
+    }
+
+    // Get the character at the specified location
+    char cell = board[y][x];
+
+    // Map the cell character to the satellite view character according to rules
+    switch (cell) {
+        case BoardConstants::WALL:
+        case BoardConstants::DAMAGED_WALL:
+            return '#';
+        case '1': case '2': case '3': case '4': case '5': case '6': case '7': case '8': case '9':
+            return cell;  // Tanks show as their player's digit
+        case BoardConstants::MINE:
+            return '@';
+        case BoardConstants::SHELL:
+        case BoardConstants::MINE_SHELL_COLLISION:
+            return '*';
+        case BoardConstants::EMPTY_SPACE:
+            return ' ';
+        default:
+            return ' ';  // Default to empty space for any other characters
+    }
+}
+
+int GameSatelliteView::getRoundsUntilShell(size_t x, size_t y) const {
+    if (!shellForecast || x >= columns || y >= rows) {
+        return NO_SHELL;
+    }
+    int rounds = shellForecast->getRoundsUntilShell(x, y, currentRound);
+    return (rounds == ShellForecast::NO_SHELL) ? NO_SHELL : rounds;
+}
+
+int GameSatelliteView::getComponent(size_t x, size_t y) const {
+    if (!components || x >= columns || y >= rows) {
+        return NO_COMPONENT;
+    }
+    return components->componentOf(x, y);
+}
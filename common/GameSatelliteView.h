@@ -1,21 +1,30 @@
-#pragma once
-#include "SatelliteView.h"
-#include <vector>
-#include "../constants/BoardConstants.h"
-
-using namespace std;
-
-class GameSatelliteView : public SatelliteView {
-private:
-    const vector<vector<char>>& board;
-    const size_t rows;
-    const size_t columns;
-    const size_t requestingTankX;
-    const size_t requestingTankY;
-
-public:
-    GameSatelliteView(const vector<vector<char>>& board, size_t rows, size_t columns, 
-                     size_t requestingTankX, size_t requestingTankY);
-    virtual ~GameSatelliteView() override;
-    virtual char getObjectAt(size_t x, size_t y) const override;
+#pragma once
+#include "SatelliteView.h"
+#include "BoardForecast.h"
+#include <vector>
+#include "../constants/BoardConstants.h"
+
+using namespace std;
+
+class GameSatelliteView : public SatelliteView {
+private:
+    const vector<vector<char>>& board;
+    const size_t rows;
+    const size_t columns;
+    const size_t requestingTankX;
+    const size_t requestingTankY;
+    const ShellForecast* shellForecast;  // Optional shell arrival predictions
+    const int currentRound;
+    const ComponentIndex* components;    // Optional connected components
+
+public:
+    GameSatelliteView(const vector<vector<char>>& board, size_t rows, size_t columns, 
+                     size_t requestingTankX, size_t requestingTankY,
+                     const ShellForecast* shellForecast = nullptr, int currentRound = 0,
+                     const ComponentIndex* components = nullptr);
+    virtual ~GameSatelliteView() override;
+    virtual char getObjectAt(size_t x, size_t y) const override;
+
+    virtual int getRoundsUntilShell(size_t x, size_t y) const override;
+    virtual int getComponent(size_t x, size_t y) const override;
 }; 
\ No newline at end of file
@@ -0,0 +1,306 @@
+#include "MctsTankAlgorithm.h"
+#include "SatelliteBattleInfo.h"
+#include "BoardConstants.h"
+#include "WorkStealingPool.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+
+// MoveBackward is left out of the search: it locks the tank until a forward move
+const ActionRequest MctsTankAlgorithm::SEARCH_ACTIONS[MctsTankAlgorithm::NUM_ACTIONS] = {
+    ActionRequest::MoveForward,
+    ActionRequest::Shoot,
+    ActionRequest::RotateLeft45,
+    ActionRequest::RotateRight45,
+    ActionRequest::RotateLeft90,
+    ActionRequest::RotateRight90,
+    ActionRequest::DoNothing
+};
+
+namespace {
+    uint64_t mixSeed(uint64_t a, uint64_t b) {
+        uint64_t z = a ^ (b + 0x9E3779B97F4A7C15ULL + (a << 6) + (a >> 2));
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+}
+
+MctsTankAlgorithm::MctsTankAlgorithm(const MctsConfig& config, uint64_t seed)
+    : config(config), seed(seed), rng(seed), hasModel(false), ownTank(0), playerIndex(0),
+      turnCounter(0), ownDirection(0), directionInitialized(false)
+{
+}
+
+MctsTankAlgorithm::~MctsTankAlgorithm()
+{
+}
+
+bool MctsTankAlgorithm::shouldGetBattleInfo() const {
+    // Get battle info on first turn (turnCounter == 0) and every 4 turns after
+    return turnCounter % 4 == 0;
+}
+
+int MctsTankAlgorithm::inferShellDirection(const std::vector<std::vector<int>>& shellEta, int x, int y) {
+    // The board is the round-start snapshot while predictions are taken after this round's
+    // two shell steps, so a shell at p flying along d is predicted at p+3d and p+4d next round
+    int rows = model.getRows();
+    int columns = model.getColumns();
+    int best = -1;
+    int bestMatches = 0;
+    for (int d = 0; d < Directions::COUNT; d++) {
+        int matches = 0;
+        for (int step = 3; step <= 4; step++) {
+            int cx = ((x + Directions::dx(d) * step) % columns + columns) % columns;
+            int cy = ((y + Directions::dy(d) * step) % rows + rows) % rows;
+            if (shellEta[cy][cx] == 1) {
+                matches++;
+            }
+        }
+        if (matches > bestMatches) {
+            best = d;
+            bestMatches = matches;
+        }
+    }
+    return best;
+}
+
+void MctsTankAlgorithm::updateBattleInfo(BattleInfo& info)
+{
+    SatelliteBattleInfo& satelliteInfo = static_cast<SatelliteBattleInfo&>(info);
+    playerIndex = satelliteInfo.getPlayerIndex();
+    if (!directionInitialized) {
+        // Player 1 starts pointing left, Player 2 starts pointing right
+        ownDirection = Directions::indexOf(BoardConstants::startingDx(playerIndex), 0);
+        directionInitialized = true;
+    }
+
+    // Keep what only this tank knows about itself
+    bool hadOwn = hasModel && model.getTanks()[ownTank].alive;
+    ModelTank previousOwn = hasModel ? model.getTanks()[ownTank] : ModelTank();
+    if (hadOwn) {
+        ownDirection = previousOwn.direction;
+    }
+
+    int rows = static_cast<int>(satelliteInfo.getRows());
+    int columns = static_cast<int>(satelliteInfo.getColumns());
+    const auto& board = satelliteInfo.getBoard();
+    model = ForwardModel(rows, columns);
+
+    struct SeenTank { int x, y, player; bool own; };
+    std::vector<SeenTank> seenTanks;
+    std::vector<std::pair<int, int>> seenShells;
+    for (int y = 0; y < rows; y++) {
+        for (int x = 0; x < columns; x++) {
+            char cell = board[y][x];
+            if (cell == BoardConstants::WALL || cell == BoardConstants::MINE) {
+                model.setCell(x, y, cell);
+            } else if (cell == BoardConstants::SHELL) {
+                seenShells.push_back({x, y});
+            } else if (cell == BoardConstants::REQUESTING_TANK) {
+                seenTanks.push_back({x, y, playerIndex, true});
+            } else if (BoardConstants::isTankChar(cell)) {
+                seenTanks.push_back({x, y, cell - '0', false});
+            }
+        }
+    }
+
+    // The engine moves tanks player by player, each in board order
+    std::sort(seenTanks.begin(), seenTanks.end(), [](const SeenTank& a, const SeenTank& b) {
+        if (a.player != b.player) return a.player < b.player;
+        if (a.y != b.y) return a.y < b.y;
+        return a.x < b.x;
+    });
+    for (const auto& seen : seenTanks) {
+        if (seen.own) {
+            ownTank = model.addTank(seen.x, seen.y, ownDirection, seen.player,
+                                    hadOwn ? previousOwn.numShells : config.assumedShells);
+            if (hadOwn) {
+                ModelTank& own = model.getTanks()[ownTank];
+                own.shootCooldown = previousOwn.shootCooldown;
+                own.movingBackward = previousOwn.movingBackward;
+                own.backwardCounter = previousOwn.backwardCounter;
+            }
+        } else {
+            // Enemy directions are not visible, pick one for this determinization
+            model.addTank(seen.x, seen.y, static_cast<int>(rng() % Directions::COUNT), seen.player, config.assumedShells);
+        }
+    }
+    for (const auto& [x, y] : seenShells) {
+        int direction = inferShellDirection(satelliteInfo.getShellEta(), x, y);
+        model.addShell(x, y, direction >= 0 ? direction : static_cast<int>(rng() % Directions::COUNT));
+    }
+    hasModel = true;
+
+    // Play out the rest of this round, in which this tank only requested info
+    advanceModel(ActionRequest::GetBattleInfo);
+    std::cout << "MctsTank: Model rebuilt with " << model.getTanks().size() << " tanks and "
+              << model.getShells().size() << " shells" << std::endl;
+}
+
+void MctsTankAlgorithm::advanceModel(ActionRequest action) {
+    std::vector<ActionRequest> actions(model.getTanks().size(), ActionRequest::DoNothing);
+    actions[ownTank] = action;
+    model.step(actions);
+}
+
+void MctsTankAlgorithm::randomActions(std::mt19937_64& random, std::vector<ActionRequest>& actions) const {
+    for (auto& action : actions) {
+        action = SEARCH_ACTIONS[random() % NUM_ACTIONS];
+    }
+}
+
+double MctsTankAlgorithm::evaluate(const ForwardModel& start, const ForwardModel& end) const {
+    int enemyLosses = 0;
+    int allyLosses = 0;
+    const auto& before = start.getTanks();
+    const auto& after = end.getTanks();
+    for (size_t i = 0; i < before.size(); i++) {
+        if (before[i].alive && !after[i].alive) {
+            if (before[i].player == playerIndex) {
+                allyLosses++;
+            } else {
+                enemyLosses++;
+            }
+        }
+    }
+    // Losing this tank counts on top of it being an ally loss
+    int selfLoss = after[ownTank].alive ? 0 : 1;
+    double score = (enemyLosses - allyLosses - selfLoss) / 2.0;
+    return std::max(-1.0, std::min(1.0, score));
+}
+
+void MctsTankAlgorithm::search(uint64_t searchSeed, int rollouts, std::array<int, NUM_ACTIONS>& visits,
+                               std::array<double, NUM_ACTIONS>& rewards) const {
+    std::mt19937_64 random(searchSeed);
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(config.timeBudgetMs);
+
+    std::vector<Node> nodes(1);
+    nodes.reserve(static_cast<size_t>(rollouts) + 1);
+    std::vector<int> path;
+    std::vector<ActionRequest> actions(model.getTanks().size());
+
+    for (int rollout = 0; rollout < rollouts; rollout++) {
+        if (config.timeBudgetMs > 0 && std::chrono::steady_clock::now() >= deadline) {
+            break;
+        }
+
+        ForwardModel sim = model;
+        int node = 0;
+        int depth = 0;
+        path.clear();
+        path.push_back(node);
+
+        // Selection and expansion over this tank's actions
+        while (depth < config.horizon && sim.getTanks()[ownTank].alive) {
+            int chosen = -1;
+            for (int a = 0; a < NUM_ACTIONS && chosen < 0; a++) {
+                if (nodes[node].children[a] < 0) {
+                    chosen = a;
+                }
+            }
+            bool expanding = chosen >= 0;
+            if (expanding) {
+                nodes[node].children[chosen] = static_cast<int>(nodes.size());
+                nodes.emplace_back();
+            } else {
+                double bestScore = -1e9;
+                double logParent = std::log(static_cast<double>(nodes[node].visits));
+                for (int a = 0; a < NUM_ACTIONS; a++) {
+                    const Node& child = nodes[nodes[node].children[a]];
+                    double score = child.totalReward / child.visits +
+                                   config.exploration * std::sqrt(logParent / child.visits);
+                    if (score > bestScore) {
+                        bestScore = score;
+                        chosen = a;
+                    }
+                }
+            }
+
+            randomActions(random, actions);
+            actions[ownTank] = SEARCH_ACTIONS[chosen];
+            sim.step(actions);
+            node = nodes[node].children[chosen];
+            path.push_back(node);
+            depth++;
+            if (expanding) {
+                break;
+            }
+        }
+
+        // Random playout to the horizon
+        while (depth < config.horizon && sim.getTanks()[ownTank].alive) {
+            randomActions(random, actions);
+            sim.step(actions);
+            depth++;
+        }
+
+        double reward = evaluate(model, sim);
+        for (int visited : path) {
+            nodes[visited].visits++;
+            nodes[visited].totalReward += reward;
+        }
+    }
+
+    for (int a = 0; a < NUM_ACTIONS; a++) {
+        int child = nodes[0].children[a];
+        visits[a] = child >= 0 ? nodes[child].visits : 0;
+        rewards[a] = child >= 0 ? nodes[child].totalReward : 0.0;
+    }
+}
+
+ActionRequest MctsTankAlgorithm::getAction()
+{
+    if (shouldGetBattleInfo() || !hasModel) {
+        turnCounter++;
+        return ActionRequest::GetBattleInfo;
+    }
+
+    // Root parallelisation: independent trees with their own seeds, merged by visit count
+    unsigned threads = std::max(1u, config.threads);
+    int rolloutsPerThread = (config.rolloutsPerTurn + static_cast<int>(threads) - 1) / static_cast<int>(threads);
+    std::vector<std::array<int, NUM_ACTIONS>> visits(threads);
+    std::vector<std::array<double, NUM_ACTIONS>> rewards(threads);
+    uint64_t turnSeed = mixSeed(seed, static_cast<uint64_t>(turnCounter));
+
+    if (config.pool && threads > 1) {
+        TaskGroup trees(*config.pool);
+        for (unsigned t = 1; t < threads; t++) {
+            trees.run([&, t]() {
+                search(mixSeed(turnSeed, t), rolloutsPerThread, visits[t], rewards[t]);
+            });
+        }
+        search(mixSeed(turnSeed, 0), rolloutsPerThread, visits[0], rewards[0]);
+        trees.wait();
+    } else {
+        for (unsigned t = 0; t < threads; t++) {
+            search(mixSeed(turnSeed, t), rolloutsPerThread, visits[t], rewards[t]);
+        }
+    }
+
+    int best = NUM_ACTIONS - 1;  // DoNothing if nothing was searched
+    int bestVisits = -1;
+    double bestMean = -2.0;
+    for (int a = 0; a < NUM_ACTIONS; a++) {
+        int totalVisits = 0;
+        double totalReward = 0.0;
+        for (unsigned t = 0; t < threads; t++) {
+            totalVisits += visits[t][a];
+            totalReward += rewards[t][a];
+        }
+        double mean = totalVisits > 0 ? totalReward / totalVisits : -2.0;
+        if (totalVisits > bestVisits || (totalVisits == bestVisits && mean > bestMean)) {
+            best = a;
+            bestVisits = totalVisits;
+            bestMean = mean;
+        }
+    }
+
+    ActionRequest action = SEARCH_ACTIONS[best];
+    std::cout << "MctsTank: Chose action " << static_cast<int>(action) << " with " << bestVisits
+              << " visits, mean reward " << bestMean << std::endl;
+    advanceModel(action);
+    turnCounter++;
+    return action;
+}
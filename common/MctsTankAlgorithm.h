@@ -0,0 +1,67 @@
+#pragma once
+#include "TankAlgorithm.h"
+#include "ActionRequest.h"
+#include "BattleInfo.h"
+#include "ForwardModel.h"
+#include <vector>
+#include <array>
+#include <cstdint>
+#include <random>
+
+class WorkStealingPool;
+
+struct MctsConfig {
+    int rolloutsPerTurn = 256;   // Total rollouts per decision, split across threads
+    int timeBudgetMs = 0;        // Optional wall-clock budget per decision, 0 for none
+    unsigned threads = 1;        // Independent search trees merged at the root
+    WorkStealingPool* pool = nullptr;  // Runs the trees in parallel, one after another when null
+    int horizon = 10;            // Rounds simulated per rollout
+    double exploration = 1.4;    // UCT exploration constant
+    int assumedShells = 1000;    // Shells assumed for tanks whose count is unknown
+};
+
+// Tank algorithm that picks actions by Monte Carlo tree search over ForwardModel.
+// The tree only branches on this tank's actions; all other tanks act randomly in
+// each rollout. Unknown shell and enemy directions are fixed once per battle info,
+// using the shell arrival predictions where they identify a shell's direction.
+class MctsTankAlgorithm : public TankAlgorithm
+{
+public:
+    explicit MctsTankAlgorithm(const MctsConfig& config = MctsConfig(), uint64_t seed = 0);
+    ~MctsTankAlgorithm() override;
+
+    ActionRequest getAction() override;
+    void updateBattleInfo(BattleInfo& info) override;
+
+private:
+    static constexpr int NUM_ACTIONS = 7;
+    static const ActionRequest SEARCH_ACTIONS[NUM_ACTIONS];
+
+    struct Node {
+        int visits = 0;
+        double totalReward = 0.0;
+        std::array<int, NUM_ACTIONS> children;  // Node index per action, -1 if not expanded
+        Node() { children.fill(-1); }
+    };
+
+    MctsConfig config;
+    uint64_t seed;
+    std::mt19937_64 rng;
+    ForwardModel model;      // Predicted current state
+    bool hasModel;
+    size_t ownTank;          // Index of this tank in the model
+    int playerIndex;
+    int turnCounter;
+    int ownDirection;
+    bool directionInitialized;
+
+    bool shouldGetBattleInfo() const;
+    int inferShellDirection(const std::vector<std::vector<int>>& shellEta, int x, int y);
+    void advanceModel(ActionRequest action);
+
+    // One independent search; fills visit counts and reward sums per root action
+    void search(uint64_t searchSeed, int rollouts, std::array<int, NUM_ACTIONS>& visits,
+                std::array<double, NUM_ACTIONS>& rewards) const;
+    double evaluate(const ForwardModel& start, const ForwardModel& end) const;
+    void randomActions(std::mt19937_64& random, std::vector<ActionRequest>& actions) const;
+};
@@ -8,4 +8,5 @@ public:
     
     ActionRequest getAction() override;
     void updateBattleInfo(BattleInfo& info) override;
+    bool hashState(uint64_t& /*hash*/) const override { return true; }  // No state at all
 }; 
\ No newline at end of file
@@ -1,13 +1,53 @@
 #include "MyTankAlgorithmFactory.h"
 #include "DefensiveTankAlgorithm.h"
 #include "OffensiveTankAlgorithm.h"
+#include <sstream>
+
+std::unique_ptr<TankAlgorithm> MyTankAlgorithmFactory::create(int player_index, int tank_index) const {
+    if (strategy == Strategy::Mcts) {
+        // Distinct, reproducible seed per tank
+        uint64_t seed = (static_cast<uint64_t>(player_index) << 32) | static_cast<uint32_t>(tank_index);
+        return std::make_unique<MctsTankAlgorithm>(mctsConfig, seed);
+    }
 
-std::unique_ptr<TankAlgorithm> MyTankAlgorithmFactory::create(int /*player_index*/, int tank_index) const {
     // Create defensive tanks for even indices (tank_index % 2 == 0)
     // Create offensive tanks for odd indices (tank_index % 2 == 1)
     if (tank_index % 2 == 0) {
         return std::make_unique<DefensiveTankAlgorithm>();
     } else {
-        return std::make_unique<OffensiveTankAlgorithm>();
+        return std::make_unique<OffensiveTankAlgorithm>(std::pmr::get_default_resource(), searchPool);
+    }
+}
+
+TankAlgorithmPtr MyTankAlgorithmFactory::createInArena(int player_index, int tank_index, std::pmr::memory_resource* resource) const {
+    // Same choice as create(), with the algorithms and their path buffers in the arena
+    if (strategy == Strategy::Mcts) {
+        uint64_t seed = (static_cast<uint64_t>(player_index) << 32) | static_cast<uint32_t>(tank_index);
+        return makeTankAlgorithm<MctsTankAlgorithm>(resource, mctsConfig, seed);
+    }
+
+    if (tank_index % 2 == 0) {
+        return makeTankAlgorithm<DefensiveTankAlgorithm>(resource);
+    } else {
+        return makeTankAlgorithm<OffensiveTankAlgorithm>(resource, resource, searchPool);
+    }
+}
+
+std::string MyTankAlgorithmFactory::versionTag() const {
+    std::ostringstream tag;
+    if (strategy == Strategy::Mixed) {
+        tag << "mixed-v" << ALGORITHM_VERSION;
+        // The parallel search breaks ties between equally short paths unlike the jump point one
+        if (searchPool) {
+            tag << "-pbfs";
+        }
+        return tag.str();
+    }
+    // A wall-clock budget makes the number of rollouts, and so the result, vary between runs
+    if (mctsConfig.timeBudgetMs > 0) {
+        return "";
     }
-} 
\ No newline at end of file
+    tag << "mcts-v" << ALGORITHM_VERSION << "-r" << mctsConfig.rolloutsPerTurn << "-t" << mctsConfig.threads
+        << "-h" << mctsConfig.horizon << "-e" << mctsConfig.exploration << "-s" << mctsConfig.assumedShells;
+    return tag.str();
+}
@@ -1,10 +1,29 @@
 #pragma once
 #include "TankAlgorithmFactory.h"
+#include "MctsTankAlgorithm.h"
 
 class MyTankAlgorithmFactory : public TankAlgorithmFactory {
 public:
+    // Mixed: defensive and offensive tanks alternate; Mcts: every tank searches
+    enum class Strategy { Mixed, Mcts };
+
     MyTankAlgorithmFactory() = default;
+    explicit MyTankAlgorithmFactory(Strategy strategy, const MctsConfig& mctsConfig = MctsConfig())
+        : strategy(strategy), mctsConfig(mctsConfig) {}
     ~MyTankAlgorithmFactory() override = default;
     
     std::unique_ptr<TankAlgorithm> create(int player_index, int tank_index) const override;
+    TankAlgorithmPtr createInArena(int player_index, int tank_index, std::pmr::memory_resource* resource) const override;
+    std::string versionTag() const override;
+
+    // Offensive tanks split their flat searches on huge boards across this pool; not owned
+    void setSearchPool(WorkStealingPool* pool) { searchPool = pool; }
+
+    // Bump whenever a change to one of the algorithms can change game results
+    static constexpr int ALGORITHM_VERSION = 6;
+
+private:
+    Strategy strategy = Strategy::Mixed;
+    MctsConfig mctsConfig;
+    WorkStealingPool* searchPool = nullptr;
 }; 
\ No newline at end of file
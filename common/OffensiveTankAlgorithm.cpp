@@ -2,12 +2,16 @@
 #include "SatelliteBattleInfo.h"
 #include "ActionRequest.h"
 #include "BoardConstants.h"
+#include "Directions.h"
 #include <iostream>
 #include <climits>
 #include <limits>
 
-OffensiveTankAlgorithm::OffensiveTankAlgorithm() : boardWidth(0), boardHeight(0), turnCounter(0), tankX(-1), tankY(-1),
-      dirX(0), dirY(0), directionInitialized(false), currentMode(OperationsMode::Regular)
+OffensiveTankAlgorithm::OffensiveTankAlgorithm(std::pmr::memory_resource* resource, WorkStealingPool* searchPool)
+    : boardWidth(0), boardHeight(0), turnCounter(0), tankX(-1), tankY(-1),
+      dirX(0), dirY(0), directionInitialized(false), playerIndex(0), currentMode(OperationsMode::Regular),
+      pathToClosestEnemy(resource), closestPath(resource), candidatePath(resource), pathScratch(resource),
+      jumpScratch(resource), searchPool(searchPool), chasePlanner(resource), nextWaypoint(0)
 {
     // Initialize offensive strategy
 }
@@ -23,20 +27,7 @@ bool OffensiveTankAlgorithm::shouldGetBattleInfo() const {
 }
 
 void OffensiveTankAlgorithm::updateDirection(ActionRequest action) {
-    const std::vector<std::pair<int, int>> directions = {
-        {1, 0}, {1, 1}, {0, 1}, {-1, 1},
-        {-1, 0}, {-1, -1}, {0, -1}, {1, -1}
-    };
-
-    // Find current direction index
-    int currentIndex = -1;
-    for (int i = 0; i < 8; ++i) {
-        if (directions[i].first == dirX && directions[i].second == dirY) {
-            currentIndex = i;
-            break;
-        }
-    }
-
+    int currentIndex = Directions::indexOf(dirX, dirY);
     if (currentIndex == -1) {
         throw std::runtime_error("Invalid current direction");
     }
@@ -50,9 +41,9 @@ void OffensiveTankAlgorithm::updateDirection(ActionRequest action) {
         default: return; // no direction change
     }
 
-    int newIndex = (currentIndex + offset + 8) % 8;
-    dirX = directions[newIndex].first;
-    dirY = directions[newIndex].second;
+    int newIndex = Directions::rotate(currentIndex, offset);
+    dirX = Directions::dx(newIndex);
+    dirY = Directions::dy(newIndex);
 }
 
 
@@ -70,6 +61,7 @@ void OffensiveTankAlgorithm::updateBattleInfo(BattleInfo& info)
     
     // Get a copy of the board directly
     board = satelliteInfo.getBoard();
+    components = satelliteInfo.getComponents();
     
     // Update tank position
     tankX = satelliteInfo.getTankX();
@@ -83,7 +75,7 @@ void OffensiveTankAlgorithm::updateBattleInfo(BattleInfo& info)
     // Initialize direction if not done yet
     if (!directionInitialized) {
         // Player 1 starts pointing left, Player 2 starts pointing right
-        dirX = (playerIndex == 1) ? -1 : 1;
+        dirX = BoardConstants::startingDx(playerIndex);
         dirY = 0;
         directionInitialized = true;
         std::cout << "OffensiveTank: Initialized direction - dirX: " << dirX << ", dirY: " << dirY << std::endl;
@@ -91,42 +83,160 @@ void OffensiveTankAlgorithm::updateBattleInfo(BattleInfo& info)
 
     // find path to closest enemy
     Point start = {tankX, tankY};
-    std::vector<Point> closestPath;
+    bool hugeBoard = boardWidth * boardHeight >= CLUSTER_SEARCH_MIN_CELLS;
+    bool largeBoard = !hugeBoard && boardWidth * boardHeight >= JUMP_SEARCH_MIN_CELLS;
+
+    // On large boards keep chasing the same enemy and only repair the path to it
+    if (largeBoard && chasePlanner.hasPlan()) {
+        Point enemy;
+        if (findChasedEnemy(enemy) && reachableWithoutShooting(enemy)) {
+            std::vector<Point> path = chasePlanner.replan(board, start, enemy);
+            if (!path.empty()) {
+                pathToClosestEnemy.assign(path);
+                std::cout << "OffensiveTank: Repaired path to chased enemy with " << path.size() << " steps" << std::endl;
+                return;
+            }
+        }
+        std::cout << "OffensiveTank: Lost the chased enemy, searching again" << std::endl;
+        chasePlanner.clear();
+    }
+
+    closestPath.clear();
+    clusterRoute.clear();
+    nextWaypoint = 0;
+    Point closestEnemy = {-1, -1};
     size_t minPathLength = std::numeric_limits<size_t>::max();
 
-    // Determine enemy tank character based on player index
-    char enemyTankChar = (playerIndex == 1) ? '2' : '1';  // Player 1 looks for '2', Player 2 looks for '1'
-    std::cout << "OffensiveTank: Looking for enemy tank character: " << enemyTankChar << std::endl;
+    // Every tank of another player is an enemy
+    std::cout << "OffensiveTank: Looking for tanks of players other than " << playerIndex << std::endl;
 
     // Find all enemy tanks on the board
+    std::vector<Point> enemies;
     for (int y = 0; y < boardHeight; y++) {
         for (int x = 0; x < boardWidth; x++) {
             // Check if this is an enemy tank
-            if (board[y][x] == enemyTankChar) {
-                Point enemyPos = {x, y};
-                std::cout << "OffensiveTank: Found enemy at position - X: " << x << ", Y: " << y << std::endl;
-                // Find path to this enemy
-                std::vector<Point> path = bfsPathfinder(board, start, enemyPos, false);
-                
-                // If we found a valid path and it's shorter than our current closest
-                if (!path.empty() && path.size() < minPathLength) {
-                    minPathLength = path.size();
-                    closestPath = path;
-                    std::cout << "OffensiveTank: Found new closest path with length: " << path.size() << std::endl;
-                }
+            if (BoardConstants::isTankChar(board[y][x]) && BoardConstants::teamOf(board[y][x]) != playerIndex) {
+                enemies.push_back({x, y});
+            }
+        }
+    }
+
+    // On huge boards compare the enemies by their coarse routes and refine only the first
+    // segment of the closest one's; the rest is refined as the tank gets there, if the
+    // next battle info hasn't replaced the route by then
+    if (hugeBoard) {
+        clusterPaths.update(board);
+        std::vector<Point> closestRoute;
+        for (Point enemyPos : enemies) {
+            if (!reachableWithoutShooting(enemyPos)) {
+                continue;
+            }
+            int length;
+            std::vector<Point> route = clusterPaths.coarseRoute(start, enemyPos, length);
+            if (!route.empty() && static_cast<size_t>(length) + 1 < minPathLength) {
+                minPathLength = length + 1;
+                closestRoute = route;
+                closestEnemy = enemyPos;
+                std::cout << "OffensiveTank: Found new closest route with length: " << length + 1 << std::endl;
+            }
+        }
+        if (closestRoute.size() > 1) {
+            closestPath.assign(clusterPaths.refineSegment(closestRoute[0], closestRoute[1]));
+        } else {
+            closestPath.assign(closestRoute);
+        }
+        if (!closestPath.empty()) {
+            clusterRoute.swap(closestRoute);
+            nextWaypoint = std::min<size_t>(2, clusterRoute.size());
+        }
+    }
+
+    // Otherwise, or if no route was found, search each enemy on the board itself
+    if (closestPath.empty()) {
+        minPathLength = std::numeric_limits<size_t>::max();
+        for (Point enemyPos : enemies) {
+            std::cout << "OffensiveTank: Found enemy at position - X: " << enemyPos.x << ", Y: " << enemyPos.y << std::endl;
+            // Find path to this enemy, straight through walls if it's walled off anyway
+            bool throughWalls = !reachableWithoutShooting(enemyPos);
+            if (throughWalls) {
+                std::cout << "OffensiveTank: Enemy is walled off, searching through walls" << std::endl;
+            }
+            if (hugeBoard && searchPool) {
+                candidatePath.assign(parallelBfsPathfinder(board, start, enemyPos, throughWalls, searchPool, parallelScratch));
+            } else if (boardWidth * boardHeight >= JUMP_SEARCH_MIN_CELLS) {
+                candidatePath.assign(jumpPointPathfinder(board, start, enemyPos, throughWalls, jumpScratch));
+            } else {
+                bfsPathfinder(board, start, enemyPos, throughWalls, pathScratch, candidatePath);
+            }
+
+            // If we found a valid path and it's shorter than our current closest
+            if (!candidatePath.empty() && candidatePath.size() < minPathLength) {
+                minPathLength = candidatePath.size();
+                closestPath.swap(candidatePath);
+                closestEnemy = enemyPos;
+                std::cout << "OffensiveTank: Found new closest path with length: " << closestPath.size() << std::endl;
             }
         }
     }
 
     // Save the path to the closest enemy
     if (!closestPath.empty()) {
-        pathToClosestEnemy = closestPath;
-        std::cout << "OffensiveTank: Updated path to closest enemy with " << closestPath.size() << " steps" << std::endl;
+        pathToClosestEnemy.swap(closestPath);
+        std::cout << "OffensiveTank: Updated path to closest enemy with " << pathToClosestEnemy.size() << " steps" << std::endl;
+        // Start chasing it; a path that needs walls shot through is searched again next time
+        if (largeBoard && (!reachableWithoutShooting(closestEnemy) || chasePlanner.plan(board, start, closestEnemy).empty())) {
+            chasePlanner.clear();
+        }
     } else {
         std::cout << "OffensiveTank: No valid path found to any enemy" << std::endl;
     }
 }
 
+bool OffensiveTankAlgorithm::reachableWithoutShooting(Point target) const {
+    // Without components every enemy might be reachable
+    if (components.empty() || components[tankY][tankX] == SatelliteBattleInfo::NO_COMPONENT) {
+        return true;
+    }
+    return components[tankY][tankX] == components[target.y][target.x];
+}
+
+void OffensiveTankAlgorithm::extendClusterPath() {
+    // Keep a next step in the path while waypoints are left
+    while (pathToClosestEnemy.size() < 2 && nextWaypoint < clusterRoute.size()) {
+        std::vector<Point> segment = clusterPaths.refineSegment(clusterRoute[nextWaypoint - 1], clusterRoute[nextWaypoint]);
+        if (segment.empty()) {
+            std::cout << "OffensiveTank: Could not refine the next route segment" << std::endl;
+            pathToClosestEnemy.clear();
+            clusterRoute.clear();
+            nextWaypoint = 0;
+            return;
+        }
+        for (size_t i = 1; i < segment.size(); i++) {
+            pathToClosestEnemy.push_back(segment[i]);
+        }
+        nextWaypoint++;
+        std::cout << "OffensiveTank: Refined the next route segment, " << pathToClosestEnemy.size() << " steps" << std::endl;
+    }
+}
+
+bool OffensiveTankAlgorithm::findChasedEnemy(Point& enemy) const {
+    // The enemy tank nearest to where the chased one was last seen
+    Point last = chasePlanner.target();
+    int best = CHASE_TRACKING_RADIUS + 1;
+    for (int y = 0; y < boardHeight; y++) {
+        for (int x = 0; x < boardWidth; x++) {
+            if (BoardConstants::isTankChar(board[y][x]) && BoardConstants::teamOf(board[y][x]) != playerIndex) {
+                int d = dist({x, y}, last, boardWidth, boardHeight);
+                if (d < best) {
+                    best = d;
+                    enemy = {x, y};
+                }
+            }
+        }
+    }
+    return best <= CHASE_TRACKING_RADIUS;
+}
+
 ActionRequest OffensiveTankAlgorithm::wrapMoveForward() {
     // Calculate next position based on current direction
     int nextX = (tankX + dirX + boardWidth) % boardWidth;
@@ -205,9 +315,11 @@ ActionRequest OffensiveTankAlgorithm::getAction()
         return wrapShoot();
     }
 
-    // If we have a path to the enemy, check if it's straight
+    // If we have a path to the enemy, check if it's straight; a path that ends at a
+    // waypoint short of the enemy is only followed
+    extendClusterPath();
     if (!pathToClosestEnemy.empty()) {
-        if (isPathStraight(pathToClosestEnemy, boardHeight, boardWidth)) {
+        if (nextWaypoint >= clusterRoute.size() && isPathStraight(pathToClosestEnemy, boardHeight, boardWidth)) {
             // Calculate direction to enemy
             array<int,2> pathDir = calcDirection(pathToClosestEnemy, boardHeight, boardWidth);
             array<int,2> currentDir = {dirX, dirY};
@@ -261,7 +373,7 @@ ActionRequest OffensiveTankAlgorithm::followPath() {
         // If path is clear, move forward
         else if (tile == ' ') {
             std::cout << "OffensiveTank: Path clear, moving forward" << std::endl;
-            pathToClosestEnemy.erase(pathToClosestEnemy.begin());
+            pathToClosestEnemy.pop_front();
             return wrapMoveForward();
         }
     }
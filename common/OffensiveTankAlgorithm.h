@@ -14,7 +14,9 @@ public:
         Panic
     };
 
-    OffensiveTankAlgorithm();
+    // With a search pool, flat searches on huge boards are parallel BFS instead of jump point search
+    explicit OffensiveTankAlgorithm(std::pmr::memory_resource* resource = std::pmr::get_default_resource(),
+                                    WorkStealingPool* searchPool = nullptr);
     ~OffensiveTankAlgorithm() override;
     
     ActionRequest getAction() override;
@@ -22,6 +24,7 @@ public:
 
 private:
     std::vector<std::vector<char>> board;
+    std::vector<std::vector<int>> components;  // Connected components from the battle info, if given
     int boardWidth;
     int boardHeight;
     int turnCounter;
@@ -32,7 +35,26 @@ private:
     bool directionInitialized;
     int playerIndex;
     OperationsMode currentMode;
-    std::vector<Point> pathToClosestEnemy;
+    PathBuffer pathToClosestEnemy;
+    PathBuffer closestPath;    // Best path of the current search, swapped in when one is found
+    PathBuffer candidatePath;  // Path to the enemy being searched
+    BfsScratch pathScratch;  // Search buffers reused across turns
+    JpsScratch jumpScratch;
+    WorkStealingPool* searchPool;
+    ParallelBfsScratch parallelScratch;
+    IncrementalPathFinder chasePlanner;  // Path to the enemy being chased on large boards
+    ClusterPathFinder clusterPaths;      // Entrance graph of huge boards, kept up to date between battle infos
+    std::vector<Point> clusterRoute;     // Coarse route to the closest enemy on huge boards
+    size_t nextWaypoint;                 // First waypoint of clusterRoute that pathToClosestEnemy doesn't reach yet
+
+    // Boards with at least this many cells are searched with jump points instead of BFS,
+    // and the chased enemy's path is repaired between battle infos
+    static constexpr int JUMP_SEARCH_MIN_CELLS = 32 * 32;
+    // Boards with at least this many cells are searched through clusters instead,
+    // without chasing, as the chase's first plan is a search of the whole board
+    static constexpr int CLUSTER_SEARCH_MIN_CELLS = 256 * 256;
+    // How far the chased enemy may have moved between two battle infos
+    static constexpr int CHASE_TRACKING_RADIUS = 4;
 
     // Helper functions for movement and rotation
     bool shouldGetBattleInfo() const;
@@ -44,5 +66,8 @@ private:
     ActionRequest wrapShoot();
     ActionRequest turnToAction(Turn t);
     void updateDirection(ActionRequest action);
+    bool findChasedEnemy(Point& enemy) const;
+    bool reachableWithoutShooting(Point target) const;
+    void extendClusterPath();
     ActionRequest followPath();
 }; 
\ No newline at end of file
@@ -5,9 +5,12 @@
 #include <algorithm>
 #include <cmath>
 #include <array>
+#include <climits>
 #include "../constants/BoardConstants.h"
 #include "PathFinder.h"
 #include "ActionRequest.h"
+#include "../constants/Directions.h"
+#include "WorkStealingPool.h"
 
 using namespace std;
 
@@ -22,13 +25,8 @@ const int directions[8][2] = {
     {-1, -1}, //UP_LEFT
 };
 
-bool isValid(int x, int y, const vector<vector<char>>& grid, const vector<vector<bool>>& visited, bool includeWalls) {
-    if (x < 0 || x >= static_cast<int>(grid[0].size()) || y < 0 || y >= static_cast<int>(grid.size())) {
-        return false;
-    }
-    if (visited[y][x]) {
-        return false;
-    }
+// Whether a path may pass through the cell, ignoring whether it was visited
+static bool isPassable(int x, int y, const vector<vector<char>>& grid, bool includeWalls) {
     if (grid[y][x] == BoardConstants::EMPTY_SPACE) {
         return true;
     }
@@ -36,12 +34,22 @@ bool isValid(int x, int y, const vector<vector<char>>& grid, const vector<vector
         (grid[y][x] == BoardConstants::WALL || grid[y][x] == BoardConstants::DAMAGED_WALL)) {
             return true;
         }
-    if (grid[y][x] == BoardConstants::PLAYER1_TANK || grid[y][x] == BoardConstants::PLAYER2_TANK) {
+    if (BoardConstants::isTankChar(grid[y][x])) {
         return true;
     }
     return false;
 }
 
+bool isValid(int x, int y, const vector<vector<char>>& grid, const vector<vector<bool>>& visited, bool includeWalls) {
+    if (x < 0 || x >= static_cast<int>(grid[0].size()) || y < 0 || y >= static_cast<int>(grid.size())) {
+        return false;
+    }
+    if (visited[y][x]) {
+        return false;
+    }
+    return isPassable(x, y, grid, includeWalls);
+}
+
 Point wrapPoint(int x, int y, int rows, int cols) {
     x = (x + rows) % rows;
     y = (y + cols) % cols;
@@ -49,6 +57,12 @@ Point wrapPoint(int x, int y, int rows, int cols) {
 }
 
 vector<Point> bfsPathfinder(const vector<vector<char>>& grid, Point start, Point end, bool includeWalls) {
+    BfsScratch scratch;
+    return bfsPathfinder(grid, start, end, includeWalls, scratch);
+}
+
+// BFS from start, leaving the parents in scratch; true if end was reached
+static bool bfsSearch(const vector<vector<char>>& grid, Point start, Point end, bool includeWalls, BfsScratch& scratch) {
     cout << "Starting BFS pathfinding from (" << start.x << "," << start.y << ") to (" << end.x << "," << end.y << ")" << endl;
     cout << "Include walls: " << (includeWalls ? "true" : "false") << endl;
 
@@ -63,55 +77,51 @@ vector<Point> bfsPathfinder(const vector<vector<char>>& grid, Point start, Point
     if (start.y < 0 || start.y >= rows || start.x < 0 || start.x >= cols) {
         cout << "ERROR: Start point (" << start.x << "," << start.y << ") is out of bounds!" << endl;
         cout << "Grid bounds: rows=" << rows << ", cols=" << cols << endl;
-        return {};
+        return false;
     }
     if (end.y < 0 || end.y >= rows || end.x < 0 || end.x >= cols) {
         cout << "ERROR: End point (" << end.x << "," << end.y << ") is out of bounds!" << endl;
         cout << "Grid bounds: rows=" << rows << ", cols=" << cols << endl;
-        return {};
+        return false;
     }
 
     cout << "Debug: Creating visited array" << endl;
-    vector<vector<bool>> visited(rows, vector<bool>(cols, false));
+    size_t cells = static_cast<size_t>(rows) * cols;
+    scratch.visited.assign(cells, 0);
     cout << "Debug: Creating parent array" << endl;
-    vector<vector<Point>> parent(rows, vector<Point>(cols, {-1, -1}));
+    scratch.parent.assign(cells, {-1, -1});
+    auto visited = [&](Point p) -> char& { return scratch.visited[static_cast<size_t>(p.y) * cols + p.x]; };
+    auto parent = [&](Point p) -> Point& { return scratch.parent[static_cast<size_t>(p.y) * cols + p.x]; };
 
     cout << "Debug: Creating queue" << endl;
-    queue<Node> q;
+    pmr::vector<Node>& q = scratch.frontier;
+    q.clear();
+    size_t head = 0;
     cout << "Debug: Setting start position as visited" << endl;
     cout << "Debug: Start coordinates - x: " << start.x << ", y: " << start.y << endl;
-    visited[start.y][start.x] = true;
+    visited(start) = 1;
     cout << "Debug: Successfully set start position as visited" << endl;
     cout << "Debug: Pushing start node to queue" << endl;
-    q.push({start, 0});
+    q.push_back({start, 0});
     cout << "Initialized BFS with grid size: " << rows << "x" << cols << endl;
 
-    while (!q.empty()) {
-        Node current = q.front();
-        q.pop();
+    while (head < q.size()) {
+        Node current = q[head++];
 
         Point pt = current.pt;
         cout << "Exploring node at (" << pt.x << "," << pt.y << ") with distance " << current.dist << endl;
 
         if (pt.x == end.x && pt.y == end.y) {
             cout << "Found path to destination!" << endl;
-            // Reconstruct path
-            vector<Point> path;
-            while (!(pt.x == -1 && pt.y == -1)) {
-                path.push_back(pt);
-                pt = parent[pt.y][pt.x];
-            }
-            reverse(path.begin(), path.end());
-            cout << "Path length: " << path.size() << " steps" << endl;
-            return path;
+            return true;
         }
 
         for (const auto& dir : directions) {
             Point neighbor = wrapPoint(pt.x + dir[1], pt.y + dir[0], cols, rows);
-            if (isValid(neighbor.x, neighbor.y, grid, visited, includeWalls)) {
-                visited[neighbor.y][neighbor.x] = true;
-                parent[neighbor.y][neighbor.x] = pt;
-                q.push({neighbor, current.dist + 1});
+            if (!visited(neighbor) && isPassable(neighbor.x, neighbor.y, grid, includeWalls)) {
+                visited(neighbor) = 1;
+                parent(neighbor) = pt;
+                q.push_back({neighbor, current.dist + 1});
                 cout << "Added valid neighbor at (" << neighbor.x << "," << neighbor.y << ")" << endl;
             }
         }
@@ -119,10 +129,973 @@ vector<Point> bfsPathfinder(const vector<vector<char>>& grid, Point start, Point
 
     cout << "No path found without walls, retrying with walls included" << endl;
     if (includeWalls) {
+        return false;
+    }
+
+    return bfsSearch(grid, start, end, true, scratch);
+}
+
+// Calls emit(p) for every cell from end back to start
+template <typename Emit>
+static void tracePath(const vector<vector<char>>& grid, Point end, const BfsScratch& scratch, Emit emit) {
+    size_t cols = grid[0].size();
+    for (Point pt = end; !(pt.x == -1 && pt.y == -1); pt = scratch.parent[static_cast<size_t>(pt.y) * cols + pt.x]) {
+        emit(pt);
+    }
+}
+
+vector<Point> bfsPathfinder(const vector<vector<char>>& grid, Point start, Point end, bool includeWalls, BfsScratch& scratch) {
+    // Full Points, so this works on boards of any size
+    vector<Point> path;
+    if (!bfsSearch(grid, start, end, includeWalls, scratch)) {
+        return path;
+    }
+    tracePath(grid, end, scratch, [&path](Point p) { path.push_back(p); });
+    reverse(path.begin(), path.end());
+    cout << "Path length: " << path.size() << " steps" << endl;
+    return path;
+}
+
+bool bfsPathfinder(const vector<vector<char>>& grid, Point start, Point end, bool includeWalls, BfsScratch& scratch, PathBuffer& path) {
+    path.clear();
+    if (!bfsSearch(grid, start, end, includeWalls, scratch)) {
+        return false;
+    }
+    tracePath(grid, end, scratch, [&path](Point p) { path.push_front(p); });
+    cout << "Path length: " << path.size() << " steps" << endl;
+    return true;
+}
+
+namespace {
+    // Frontiers smaller than this are expanded on the calling thread
+    const size_t PARALLEL_MIN_FRONTIER = 4096;
+    // Chunks per pool thread, so that uneven chunks even out
+    const size_t CHUNKS_PER_THREAD = 4;
+
+    template <typename Work>
+    void forEachChunk(WorkStealingPool* pool, size_t chunks, Work work) {
+        if (!pool || chunks == 1) {
+            for (size_t chunk = 0; chunk < chunks; chunk++) {
+                work(chunk);
+            }
+            return;
+        }
+        TaskGroup group(*pool);
+        for (size_t chunk = 0; chunk < chunks; chunk++) {
+            group.run([&work, chunk]() { work(chunk); });
+        }
+        group.wait();
+    }
+}
+
+vector<Point> parallelBfsPathfinder(const vector<vector<char>>& grid, Point start, Point end, bool includeWalls,
+                                    WorkStealingPool* pool, ParallelBfsScratch& scratch) {
+    cout << "Starting parallel BFS from (" << start.x << "," << start.y << ") to (" << end.x << "," << end.y << ")" << endl;
+    cout << "Include walls: " << (includeWalls ? "true" : "false") << endl;
+    int rows = grid.size();
+    int cols = grid[0].size();
+    if (start.y < 0 || start.y >= rows || start.x < 0 || start.x >= cols ||
+        end.y < 0 || end.y >= rows || end.x < 0 || end.x >= cols) {
+        cout << "ERROR: Start or end point is out of bounds!" << endl;
         return {};
     }
 
-    return bfsPathfinder(grid, start, end, true);
+    size_t cells = static_cast<size_t>(rows) * cols;
+    size_t words = (cells + 63) / 64;
+    if (scratch.visited.size() != words) {
+        vector<atomic<uint64_t>>(words).swap(scratch.visited);
+    }
+    if (scratch.claim.size() != cells) {
+        vector<atomic<uint32_t>>(cells).swap(scratch.claim);
+        scratch.parent.resize(cells);
+    }
+    size_t maxChunks = pool ? CHUNKS_PER_THREAD * pool->size() : 1;
+    scratch.reached.resize(maxChunks);
+    scratch.next.resize(maxChunks);
+    auto& visited = scratch.visited;
+    auto& claim = scratch.claim;
+
+    // Clear the buffers in chunks as well, unless the board is small
+    size_t clearChunks = cells < 16 * PARALLEL_MIN_FRONTIER ? 1 : maxChunks;
+    forEachChunk(pool, clearChunks, [&](size_t chunk) {
+        for (size_t w = words * chunk / clearChunks; w < words * (chunk + 1) / clearChunks; w++) {
+            visited[w].store(0, memory_order_relaxed);
+        }
+        for (size_t c = cells * chunk / clearChunks; c < cells * (chunk + 1) / clearChunks; c++) {
+            claim[c].store(UINT32_MAX, memory_order_relaxed);
+        }
+    });
+    auto isVisited = [&](uint32_t cell) {
+        return (visited[cell / 64].load(memory_order_relaxed) >> (cell % 64)) & 1;
+    };
+    // True if this call set the bit
+    auto markVisited = [&](uint32_t cell) {
+        uint64_t bit = uint64_t(1) << (cell % 64);
+        return (visited[cell / 64].fetch_or(bit, memory_order_relaxed) & bit) == 0;
+    };
+
+    uint32_t startCell = static_cast<uint32_t>(start.y * cols + start.x);
+    uint32_t endCell = static_cast<uint32_t>(end.y * cols + end.x);
+    markVisited(startCell);
+    scratch.frontier.assign(1, startCell);
+    scratch.levels = 0;
+    bool found = startCell == endCell;
+
+    while (!found && !scratch.frontier.empty()) {
+        const vector<uint32_t>& frontier = scratch.frontier;
+        size_t chunks = frontier.size() < PARALLEL_MIN_FRONTIER ? 1 : min(maxChunks, frontier.size() / (PARALLEL_MIN_FRONTIER / 4));
+        auto chunkBegin = [&](size_t chunk) { return frontier.size() * chunk / chunks; };
+
+        // Every unvisited neighbour keeps the lowest frontier index that reached it. A sequential
+        // BFS dequeues the frontier in this order, so that is the cell it would be discovered from.
+        forEachChunk(pool, chunks, [&](size_t chunk) {
+            vector<pair<uint32_t, uint32_t>>& reached = scratch.reached[chunk];
+            reached.clear();
+            for (size_t i = chunkBegin(chunk); i < chunkBegin(chunk + 1); i++) {
+                int x = frontier[i] % cols;
+                int y = frontier[i] / cols;
+                for (const auto& dir : directions) {
+                    Point neighbor = wrapPoint(x + dir[1], y + dir[0], cols, rows);
+                    uint32_t cell = static_cast<uint32_t>(neighbor.y * cols + neighbor.x);
+                    if (isVisited(cell) || !isPassable(neighbor.x, neighbor.y, grid, includeWalls)) {
+                        continue;
+                    }
+                    uint32_t key = static_cast<uint32_t>(i);
+                    uint32_t current = claim[cell].load(memory_order_relaxed);
+                    while (key < current && !claim[cell].compare_exchange_weak(current, key, memory_order_relaxed)) {
+                    }
+                    if (key < current) {
+                        reached.push_back({key, cell});
+                    }
+                }
+            }
+        });
+
+        // Keep the claims that held; in chunk order they are the sequential discovery order
+        forEachChunk(pool, chunks, [&](size_t chunk) {
+            vector<uint32_t>& next = scratch.next[chunk];
+            next.clear();
+            for (const auto& [key, cell] : scratch.reached[chunk]) {
+                if (claim[cell].load(memory_order_relaxed) == key && markVisited(cell)) {
+                    scratch.parent[cell] = frontier[key];
+                    next.push_back(cell);
+                }
+            }
+        });
+
+        scratch.levels++;
+        found = isVisited(endCell);
+        scratch.frontier.clear();
+        for (size_t chunk = 0; chunk < chunks; chunk++) {
+            scratch.frontier.insert(scratch.frontier.end(), scratch.next[chunk].begin(), scratch.next[chunk].end());
+        }
+    }
+
+    if (found) {
+        vector<Point> path;
+        for (uint32_t cell = endCell; cell != startCell; cell = scratch.parent[cell]) {
+            path.push_back({static_cast<int>(cell % cols), static_cast<int>(cell / cols)});
+        }
+        path.push_back(start);
+        reverse(path.begin(), path.end());
+        cout << "Path length: " << path.size() << " steps after " << scratch.levels << " levels" << endl;
+        return path;
+    }
+
+    cout << "No path found without walls, retrying with walls included" << endl;
+    if (includeWalls) {
+        return {};
+    }
+    return parallelBfsPathfinder(grid, start, end, true, pool, scratch);
+}
+
+namespace {
+    // Scans for jump points on a board that wraps at the edges. Boards narrower than
+    // three cells alias the neighbourhood the pruning rules look at, so on those every
+    // direction is searched one cell at a time.
+    class JumpScanner {
+    public:
+        JumpScanner(const vector<vector<char>>& grid, Point end, bool includeWalls)
+            : grid(grid), rows(grid.size()), cols(grid[0].size()), end(end), includeWalls(includeWalls),
+              pruning(rows >= 3 && cols >= 3) {}
+
+        bool isFree(int x, int y) const {
+            Point p = wrapPoint(x, y, cols, rows);
+            return isPassable(p.x, p.y, grid, includeWalls);
+        }
+
+        // Directions worth searching from a jump point reached going `arrival` (-1 at the start):
+        // onwards, and past any obstacle beside the cell that blocks the cheaper way around
+        int successors(Point p, int arrival, int dirs[Directions::COUNT]) const {
+            int count = 0;
+            if (arrival < 0 || !pruning) {
+                for (int dir = 0; dir < Directions::COUNT; dir++) {
+                    dirs[count++] = dir;
+                }
+                return count;
+            }
+            int dx = Directions::dx(arrival);
+            int dy = Directions::dy(arrival);
+            dirs[count++] = arrival;
+            if (dx != 0 && dy != 0) {
+                dirs[count++] = Directions::indexOf(dx, 0);
+                dirs[count++] = Directions::indexOf(0, dy);
+                if (!isFree(p.x - dx, p.y)) dirs[count++] = Directions::indexOf(-dx, dy);
+                if (!isFree(p.x, p.y - dy)) dirs[count++] = Directions::indexOf(dx, -dy);
+            } else if (dx != 0) {
+                if (!isFree(p.x, p.y - 1)) dirs[count++] = Directions::indexOf(dx, -1);
+                if (!isFree(p.x, p.y + 1)) dirs[count++] = Directions::indexOf(dx, 1);
+            } else {
+                if (!isFree(p.x - 1, p.y)) dirs[count++] = Directions::indexOf(-1, dy);
+                if (!isFree(p.x + 1, p.y)) dirs[count++] = Directions::indexOf(1, dy);
+            }
+            return count;
+        }
+
+        // Walk from `from` in direction dir to the next jump point, if there is one
+        bool jump(Point from, int dir, Point& found, int& steps) const {
+            int dx = Directions::dx(dir);
+            int dy = Directions::dy(dir);
+            bool diagonal = dx != 0 && dy != 0;
+            // A straight scan that gets all the way around is back where it started. Diagonal
+            // ones cycle through up to rows * cols cells, so they stop after the longer side
+            // and the search goes on from there.
+            int limit = !pruning ? 1 : diagonal ? max(rows, cols) : (dx != 0 ? cols : rows);
+            Point p = from;
+            for (int step = 1; step <= limit; step++) {
+                p = wrapPoint(p.x + dx, p.y + dy, cols, rows);
+                if (p == from || !isFree(p.x, p.y)) {
+                    return false;
+                }
+                bool isJumpPoint = !pruning || p == end || hasForcedNeighbour(p, dx, dy);
+                if (!isJumpPoint && diagonal) {
+                    Point unused;
+                    int unusedSteps;
+                    isJumpPoint = jump(p, Directions::indexOf(dx, 0), unused, unusedSteps) ||
+                                  jump(p, Directions::indexOf(0, dy), unused, unusedSteps) || step == limit;
+                }
+                if (isJumpPoint) {
+                    found = p;
+                    steps = step;
+                    return true;
+                }
+            }
+            return false;
+        }
+
+    private:
+        const vector<vector<char>>& grid;
+        int rows;
+        int cols;
+        Point end;
+        bool includeWalls;
+        bool pruning;
+
+        bool hasForcedNeighbour(Point p, int dx, int dy) const {
+            if (dx != 0 && dy != 0) {
+                return (!isFree(p.x - dx, p.y) && isFree(p.x - dx, p.y + dy)) ||
+                       (!isFree(p.x, p.y - dy) && isFree(p.x + dx, p.y - dy));
+            }
+            if (dx != 0) {
+                return (!isFree(p.x, p.y - 1) && isFree(p.x + dx, p.y - 1)) ||
+                       (!isFree(p.x, p.y + 1) && isFree(p.x + dx, p.y + 1));
+            }
+            return (!isFree(p.x - 1, p.y) && isFree(p.x - 1, p.y + dy)) ||
+                   (!isFree(p.x + 1, p.y) && isFree(p.x + 1, p.y + dy));
+        }
+    };
+}
+
+vector<Point> jumpPointPathfinder(const vector<vector<char>>& grid, Point start, Point end, bool includeWalls, JpsScratch& scratch) {
+    cout << "Starting jump point search from (" << start.x << "," << start.y << ") to (" << end.x << "," << end.y << ")" << endl;
+    cout << "Include walls: " << (includeWalls ? "true" : "false") << endl;
+
+    int rows = grid.size();
+    int cols = grid[0].size();
+    if (start.y < 0 || start.y >= rows || start.x < 0 || start.x >= cols) {
+        cout << "ERROR: Start point (" << start.x << "," << start.y << ") is out of bounds!" << endl;
+        return {};
+    }
+    if (end.y < 0 || end.y >= rows || end.x < 0 || end.x >= cols) {
+        cout << "ERROR: End point (" << end.x << "," << end.y << ") is out of bounds!" << endl;
+        return {};
+    }
+
+    size_t cells = static_cast<size_t>(rows) * cols;
+    scratch.g.assign(cells, INT_MAX);
+    scratch.parent.assign(cells, {-1, -1});
+    scratch.arrival.assign(cells, -1);
+    scratch.closed.assign(cells, 0);
+    scratch.open.clear();
+    scratch.expanded = 0;
+    auto at = [cols](Point p) { return static_cast<size_t>(p.y) * cols + p.x; };
+    // dist() wraps x by its first size, like wrapPoint
+    auto heuristic = [&](Point p) { return dist(p, end, cols, rows); };
+    // Lowest f first, deeper nodes first among equals
+    auto later = [](const JpsScratch::Open& a, const JpsScratch::Open& b) {
+        return a.f > b.f || (a.f == b.f && a.g < b.g);
+    };
+    pmr::vector<JpsScratch::Open>& open = scratch.open;
+    JumpScanner scanner(grid, end, includeWalls);
+
+    scratch.g[at(start)] = 0;
+    open.push_back({heuristic(start), 0, start});
+    while (!open.empty()) {
+        pop_heap(open.begin(), open.end(), later);
+        JpsScratch::Open current = open.back();
+        open.pop_back();
+        size_t index = at(current.pt);
+        if (scratch.closed[index] || current.g > scratch.g[index]) {
+            continue;
+        }
+        scratch.closed[index] = 1;
+        scratch.expanded++;
+
+        if (current.pt == end) {
+            // Fill in the cells between the jump points
+            vector<Point> path;
+            Point pt = end;
+            while (!(pt == start)) {
+                int dir = scratch.arrival[at(pt)];
+                Point from = scratch.parent[at(pt)];
+                while (!(pt == from)) {
+                    path.push_back(pt);
+                    pt = wrapPoint(pt.x - Directions::dx(dir), pt.y - Directions::dy(dir), cols, rows);
+                }
+            }
+            path.push_back(start);
+            reverse(path.begin(), path.end());
+            cout << "Path length: " << path.size() << " steps, " << scratch.expanded << " jump points expanded" << endl;
+            return path;
+        }
+
+        int dirs[Directions::COUNT];
+        int count = scanner.successors(current.pt, scratch.arrival[index], dirs);
+        for (int i = 0; i < count; i++) {
+            Point next;
+            int steps;
+            if (!scanner.jump(current.pt, dirs[i], next, steps)) {
+                continue;
+            }
+            size_t nextIndex = at(next);
+            int g = current.g + steps;
+            if (scratch.closed[nextIndex] || g >= scratch.g[nextIndex]) {
+                continue;
+            }
+            scratch.g[nextIndex] = g;
+            scratch.parent[nextIndex] = current.pt;
+            scratch.arrival[nextIndex] = static_cast<signed char>(dirs[i]);
+            open.push_back({g + heuristic(next), g, next});
+            push_heap(open.begin(), open.end(), later);
+        }
+    }
+
+    cout << "No path found after " << scratch.expanded << " jump points" << endl;
+    if (includeWalls) {
+        return {};
+    }
+    return jumpPointPathfinder(grid, start, end, true, scratch);
+}
+
+namespace {
+    const int UNREACHABLE = INT_MAX / 2;
+}
+
+IncrementalPathFinder::IncrementalPathFinder(pmr::memory_resource* resource)
+    : g(resource), rhs(resource), blocked(resource), queuedKey(resource), queued(resource), queue(resource) {}
+
+int IncrementalPathFinder::heuristic(Point p) const {
+    // dist() wraps x by its first size, like wrapPoint
+    return dist(p, start, cols, rows);
+}
+
+IncrementalPathFinder::Key IncrementalPathFinder::keyOf(size_t cell) const {
+    int best = min(g[cell], rhs[cell]);
+    return {best + heuristic(pointOf(cell)) + keyModifier, best};
+}
+
+void IncrementalPathFinder::push(size_t cell) {
+    queuedKey[cell] = keyOf(cell);
+    queued[cell] = 1;
+    queue.push_back({queuedKey[cell], cell});
+    push_heap(queue.begin(), queue.end(), [](const Entry& a, const Entry& b) { return b.key < a.key; });
+}
+
+bool IncrementalPathFinder::topKey(Key& key) {
+    auto later = [](const Entry& a, const Entry& b) { return b.key < a.key; };
+    while (!queue.empty()) {
+        const Entry& top = queue.front();
+        if (queued[top.cell] && !(top.key < queuedKey[top.cell]) && !(queuedKey[top.cell] < top.key)) {
+            key = top.key;
+            return true;
+        }
+        pop_heap(queue.begin(), queue.end(), later);
+        queue.pop_back();
+    }
+    return false;
+}
+
+void IncrementalPathFinder::updateCell(size_t cell) {
+    if (cell == at(goal)) {
+        rhs[cell] = 0;
+    } else {
+        // One step onto the neighbour closest to the target
+        Point p = pointOf(cell);
+        int best = UNREACHABLE;
+        for (const auto& dir : directions) {
+            size_t next = at(wrapPoint(p.x + dir[1], p.y + dir[0], cols, rows));
+            if (!blocked[next]) {
+                best = min(best, g[next] + 1);
+            }
+        }
+        rhs[cell] = min(best, UNREACHABLE);
+    }
+    if (g[cell] != rhs[cell]) {
+        push(cell);
+    } else {
+        queued[cell] = 0;
+    }
+}
+
+void IncrementalPathFinder::updateNeighbours(size_t cell) {
+    Point p = pointOf(cell);
+    for (const auto& dir : directions) {
+        updateCell(at(wrapPoint(p.x + dir[1], p.y + dir[0], cols, rows)));
+    }
+}
+
+void IncrementalPathFinder::computeShortestPath() {
+    auto later = [](const Entry& a, const Entry& b) { return b.key < a.key; };
+    size_t startCell = at(start);
+    Key top;
+    while (topKey(top) && (top < keyOf(startCell) || rhs[startCell] != g[startCell])) {
+        size_t cell = queue.front().cell;
+        pop_heap(queue.begin(), queue.end(), later);
+        queue.pop_back();
+        Key current = keyOf(cell);
+        if (top < current) {
+            // Queued before the start moved on
+            push(cell);
+            continue;
+        }
+        queued[cell] = 0;
+        expanded++;
+        if (g[cell] > rhs[cell]) {
+            g[cell] = rhs[cell];
+        } else {
+            g[cell] = UNREACHABLE;
+            updateCell(cell);
+        }
+        updateNeighbours(cell);
+    }
+}
+
+vector<Point> IncrementalPathFinder::extractPath() const {
+    if (g[at(start)] >= UNREACHABLE) {
+        return {};
+    }
+    vector<Point> path{start};
+    Point pt = start;
+    while (!(pt == goal)) {
+        Point best{-1, -1};
+        int bestDistance = UNREACHABLE;
+        for (const auto& dir : directions) {
+            Point next = wrapPoint(pt.x + dir[1], pt.y + dir[0], cols, rows);
+            if (!blocked[at(next)] && g[at(next)] < bestDistance) {
+                best = next;
+                bestDistance = g[at(next)];
+            }
+        }
+        if (bestDistance >= UNREACHABLE || path.size() > static_cast<size_t>(rows) * cols) {
+            return {};
+        }
+        pt = best;
+        path.push_back(pt);
+    }
+    return path;
+}
+
+vector<Point> IncrementalPathFinder::plan(const vector<vector<char>>& grid, Point newStart, Point end) {
+    cout << "Planning incremental path from (" << newStart.x << "," << newStart.y << ") to (" << end.x << "," << end.y << ")" << endl;
+    rows = grid.size();
+    cols = grid[0].size();
+    size_t cells = static_cast<size_t>(rows) * cols;
+    g.assign(cells, UNREACHABLE);
+    rhs.assign(cells, UNREACHABLE);
+    blocked.resize(cells);
+    for (int y = 0; y < rows; y++) {
+        for (int x = 0; x < cols; x++) {
+            blocked[at({x, y})] = !isPassable(x, y, grid, false);
+        }
+    }
+    queuedKey.assign(cells, {0, 0});
+    queued.assign(cells, 0);
+    queue.clear();
+    start = lastStart = newStart;
+    goal = end;
+    keyModifier = 0;
+    expanded = 0;
+
+    rhs[at(goal)] = 0;
+    push(at(goal));
+    computeShortestPath();
+    planned = true;
+    vector<Point> path = extractPath();
+    cout << "Path length: " << path.size() << " steps, " << expanded << " cells expanded" << endl;
+    return path;
+}
+
+vector<Point> IncrementalPathFinder::replan(const vector<vector<char>>& grid, Point newStart, Point end) {
+    if (!planned || static_cast<int>(grid.size()) != rows || static_cast<int>(grid[0].size()) != cols) {
+        return plan(grid, newStart, end);
+    }
+    cout << "Repairing path from (" << newStart.x << "," << newStart.y << ") to (" << end.x << "," << end.y << ")" << endl;
+    expanded = 0;
+
+    // Keys already queued were computed against the old start
+    start = newStart;
+    keyModifier += dist(lastStart, start, cols, rows);
+    lastStart = start;
+
+    // The target moved: the new cell becomes the root and the old one an ordinary cell
+    if (!(end == goal)) {
+        Point oldGoal = goal;
+        goal = end;
+        updateCell(at(goal));
+        updateCell(at(oldGoal));
+    }
+
+    // Cells that opened or closed change the cost of stepping onto them
+    for (int y = 0; y < rows; y++) {
+        for (int x = 0; x < cols; x++) {
+            char nowBlocked = !isPassable(x, y, grid, false);
+            if (blocked[at({x, y})] != nowBlocked) {
+                blocked[at({x, y})] = nowBlocked;
+                updateNeighbours(at({x, y}));
+            }
+        }
+    }
+
+    computeShortestPath();
+    vector<Point> path = extractPath();
+    cout << "Path length: " << path.size() << " steps, " << expanded << " cells expanded" << endl;
+    return path;
+}
+
+ClusterPathFinder::ClusterPathFinder(int clusterSize) : clusterSize(max(clusterSize, 2)) {}
+
+int ClusterPathFinder::localIndex(int cluster, Point p) const {
+    int x0 = (cluster % clustersX) * clusterSize;
+    int y0 = (cluster / clustersX) * clusterSize;
+    int width = min(clusterSize, cols - x0);
+    int height = min(clusterSize, rows - y0);
+    if (p.x < x0 || p.x >= x0 + width || p.y < y0 || p.y >= y0 + height) {
+        return -1;
+    }
+    // Local grids have a one-cell frame around the cluster
+    return (p.y - y0 + 1) * (width + 2) + (p.x - x0 + 1);
+}
+
+void ClusterPathFinder::buildBorders(int cluster) {
+    int cx = cluster % clustersX;
+    int cy = cluster / clustersX;
+    int x0 = cx * clusterSize;
+    int y0 = cy * clusterSize;
+    int width = min(clusterSize, cols - x0);
+    int height = min(clusterSize, rows - y0);
+
+    // Runs of crossable cells along a border: one crossing in the middle of a short
+    // run, one at each end of a long one
+    auto addRuns = [](vector<pair<Point, Point>>& border, int length, auto crossing, auto isFree) {
+        border.clear();
+        int runStart = -1;
+        for (int i = 0; i <= length; i++) {
+            if (i < length && isFree(i)) {
+                if (runStart < 0) runStart = i;
+                continue;
+            }
+            if (runStart >= 0) {
+                int runEnd = i - 1;
+                if (runEnd - runStart + 1 < 6) {
+                    border.push_back(crossing((runStart + runEnd) / 2));
+                } else {
+                    border.push_back(crossing(runStart));
+                    border.push_back(crossing(runEnd));
+                }
+                runStart = -1;
+            }
+        }
+    };
+
+    rightBorder[cluster].clear();
+    if (clustersX > 1) {
+        int x1 = x0 + width - 1;
+        int x2 = (x1 + 1) % cols;
+        addRuns(rightBorder[cluster], height,
+                [&](int i) { return make_pair(Point{x1, y0 + i}, Point{x2, y0 + i}); },
+                [&](int i) { return !isBlocked(x1, y0 + i) && !isBlocked(x2, y0 + i); });
+    }
+    downBorder[cluster].clear();
+    if (clustersY > 1) {
+        int y1 = y0 + height - 1;
+        int y2 = (y1 + 1) % rows;
+        addRuns(downBorder[cluster], width,
+                [&](int i) { return make_pair(Point{x0 + i, y1}, Point{x0 + i, y2}); },
+                [&](int i) { return !isBlocked(x0 + i, y1) && !isBlocked(x0 + i, y2); });
+    }
+}
+
+void ClusterPathFinder::buildEntrances(int cluster) {
+    int cx = cluster % clustersX;
+    int cy = cluster / clustersX;
+    int right = cy * clustersX + (cx + 1) % clustersX;
+    int left = cy * clustersX + (cx + clustersX - 1) % clustersX;
+    int down = ((cy + 1) % clustersY) * clustersX + cx;
+    int up = ((cy + clustersY - 1) % clustersY) * clustersX + cx;
+
+    vector<Entrance>& list = entrances[cluster];
+    list.clear();
+    for (const auto& [inside, outside] : rightBorder[cluster]) list.push_back({inside, outside, right});
+    if (clustersX > 1) {
+        for (const auto& [outside, inside] : rightBorder[left]) list.push_back({inside, outside, left});
+    }
+    for (const auto& [inside, outside] : downBorder[cluster]) list.push_back({inside, outside, down});
+    if (clustersY > 1) {
+        for (const auto& [outside, inside] : downBorder[up]) list.push_back({inside, outside, up});
+    }
+}
+
+void ClusterPathFinder::searchCluster(int cluster, Point from) {
+    int x0 = (cluster % clustersX) * clusterSize;
+    int y0 = (cluster / clustersX) * clusterSize;
+    int width = min(clusterSize, cols - x0);
+    int height = min(clusterSize, rows - y0);
+    int stride = width + 2;
+    size_t cells = static_cast<size_t>(stride) * (height + 2);
+    localDistance.assign(cells, -1);
+    localParent.assign(cells, -1);
+    localQueue.clear();
+    int origin = localIndex(cluster, from);
+    localDistance[origin] = 0;
+    localQueue.push_back(origin);
+
+    // A cluster that spans the whole board wraps onto itself; the others are closed
+    // off by a blocked frame, so neighbours are plain offsets
+    if (clustersX > 1 && clustersY > 1) {
+        if (framedCluster != cluster) {
+            localBlocked.assign(cells, 1);
+            for (int y = 0; y < height; y++) {
+                for (int x = 0; x < width; x++) {
+                    localBlocked[(y + 1) * stride + x + 1] = isBlocked(x0 + x, y0 + y);
+                }
+            }
+            framedCluster = cluster;
+        }
+        int offsets[8];
+        for (int i = 0; i < 8; i++) {
+            offsets[i] = directions[i][0] * stride + directions[i][1];
+        }
+        for (size_t head = 0; head < localQueue.size(); head++) {
+            int current = localQueue[head];
+            for (int offset : offsets) {
+                int index = current + offset;
+                if (localBlocked[index] || localDistance[index] >= 0) {
+                    continue;
+                }
+                localDistance[index] = localDistance[current] + 1;
+                localParent[index] = current;
+                localQueue.push_back(index);
+            }
+        }
+        return;
+    }
+
+    for (size_t head = 0; head < localQueue.size(); head++) {
+        int current = localQueue[head];
+        Point pt = {x0 + current % stride - 1, y0 + current / stride - 1};
+        for (const auto& dir : directions) {
+            Point next = wrapPoint(pt.x + dir[1], pt.y + dir[0], cols, rows);
+            int index = localIndex(cluster, next);
+            if (index < 0 || localDistance[index] >= 0 || isBlocked(next.x, next.y)) {
+                continue;
+            }
+            localDistance[index] = localDistance[current] + 1;
+            localParent[index] = current;
+            localQueue.push_back(index);
+        }
+    }
+}
+
+void ClusterPathFinder::buildDistances(int cluster) {
+    const vector<Entrance>& list = entrances[cluster];
+    size_t count = list.size();
+    distances[cluster].assign(count * count, -1);
+    for (size_t i = 0; i < count; i++) {
+        searchCluster(cluster, list[i].cell);
+        for (size_t j = 0; j < count; j++) {
+            distances[cluster][i * count + j] = localDistance[localIndex(cluster, list[j].cell)];
+        }
+    }
+}
+
+void ClusterPathFinder::update(const vector<vector<char>>& grid) {
+    int newRows = grid.size();
+    int newCols = grid[0].size();
+    framedCluster = -1;
+    vector<char> dirty;
+    if (newRows != rows || newCols != cols) {
+        rows = newRows;
+        cols = newCols;
+        clustersX = (cols + clusterSize - 1) / clusterSize;
+        clustersY = (rows + clusterSize - 1) / clusterSize;
+        size_t clusters = static_cast<size_t>(clustersX) * clustersY;
+        rightBorder.assign(clusters, {});
+        downBorder.assign(clusters, {});
+        entrances.assign(clusters, {});
+        distances.assign(clusters, {});
+        blocked.assign(static_cast<size_t>(rows) * cols, 0);
+        for (int y = 0; y < rows; y++) {
+            for (int x = 0; x < cols; x++) {
+                blocked[static_cast<size_t>(y) * cols + x] = !isPassable(x, y, grid, false);
+            }
+        }
+        dirty.assign(clusters, 1);
+    } else {
+        dirty.assign(static_cast<size_t>(clustersX) * clustersY, 0);
+        for (int y = 0; y < rows; y++) {
+            for (int x = 0; x < cols; x++) {
+                char nowBlocked = !isPassable(x, y, grid, false);
+                if (blocked[static_cast<size_t>(y) * cols + x] != nowBlocked) {
+                    blocked[static_cast<size_t>(y) * cols + x] = nowBlocked;
+                    dirty[clusterOf({x, y})] = 1;
+                }
+            }
+        }
+    }
+
+    // A changed cluster changes the borders it shares, and so the entrances of its neighbours
+    int clusters = clustersX * clustersY;
+    vector<char> touched(clusters, 0);
+    for (int c = 0; c < clusters; c++) {
+        if (!dirty[c]) {
+            continue;
+        }
+        int cx = c % clustersX;
+        int cy = c / clustersX;
+        int left = cy * clustersX + (cx + clustersX - 1) % clustersX;
+        int up = ((cy + clustersY - 1) % clustersY) * clustersX + cx;
+        buildBorders(c);
+        buildBorders(left);
+        buildBorders(up);
+        touched[c] = 1;
+        touched[left] = 1;
+        touched[up] = 1;
+        touched[cy * clustersX + (cx + 1) % clustersX] = 1;
+        touched[((cy + 1) % clustersY) * clustersX + cx] = 1;
+    }
+    rebuilt = 0;
+    for (int c = 0; c < clusters; c++) {
+        if (touched[c]) {
+            buildEntrances(c);
+            buildDistances(c);
+            rebuilt++;
+        }
+    }
+
+    firstNode.resize(clusters + 1);
+    firstNode[0] = 0;
+    for (int c = 0; c < clusters; c++) {
+        firstNode[c + 1] = firstNode[c] + entrances[c].size();
+    }
+    size_t nodes = firstNode[clusters] + 2;
+    g.resize(nodes);
+    parent.resize(nodes);
+    seen.resize(nodes, 0);
+    closed.resize(nodes, 0);
+}
+
+Point ClusterPathFinder::nodeCell(int node) const {
+    int cluster = static_cast<int>(upper_bound(firstNode.begin(), firstNode.end(), static_cast<size_t>(node)) - firstNode.begin()) - 1;
+    return entrances[cluster][node - firstNode[cluster]].cell;
+}
+
+vector<Point> ClusterPathFinder::coarseRoute(Point start, Point end, int& length) {
+    length = -1;
+    expanded = 0;
+    if (isBlocked(end.x, end.y)) {
+        return {};
+    }
+    int clusters = clustersX * clustersY;
+    int startNode = static_cast<int>(firstNode[clusters]);
+    int goalNode = startNode + 1;
+    int startCluster = clusterOf(start);
+    int goalCluster = clusterOf(end);
+
+    // Distances from the end to the entrances of its cluster are the same both ways
+    searchCluster(goalCluster, end);
+    vector<int> toGoal(entrances[goalCluster].size());
+    for (size_t j = 0; j < toGoal.size(); j++) {
+        toGoal[j] = localDistance[localIndex(goalCluster, entrances[goalCluster][j].cell)];
+    }
+    searchCluster(startCluster, start);
+
+    if (++stamp == 0) {
+        fill(seen.begin(), seen.end(), 0);
+        fill(closed.begin(), closed.end(), 0);
+        stamp = 1;
+    }
+    // dist() wraps x by its first size, like wrapPoint
+    auto heuristic = [&](int node) { return node == goalNode ? 0 : dist(node == startNode ? start : nodeCell(node), end, cols, rows); };
+    auto later = [](const Open& a, const Open& b) { return a.f > b.f || (a.f == b.f && a.g < b.g); };
+    auto relax = [&](int from, int node, int cost) {
+        int next = g[from] + cost;
+        if (closed[node] == stamp || (seen[node] == stamp && g[node] <= next)) {
+            return;
+        }
+        seen[node] = stamp;
+        g[node] = next;
+        parent[node] = from;
+        open.push_back({next + heuristic(node), next, node});
+        push_heap(open.begin(), open.end(), later);
+    };
+
+    open.clear();
+    seen[startNode] = stamp;
+    g[startNode] = 0;
+    parent[startNode] = -1;
+    open.push_back({heuristic(startNode), 0, startNode});
+    while (!open.empty()) {
+        pop_heap(open.begin(), open.end(), later);
+        Open current = open.back();
+        open.pop_back();
+        if (closed[current.node] == stamp || current.g > g[current.node]) {
+            continue;
+        }
+        closed[current.node] = stamp;
+        expanded++;
+
+        if (current.node == goalNode) {
+            length = current.g;
+            vector<Point> route;
+            for (int node = goalNode; node >= 0; node = parent[node]) {
+                Point cell = node == goalNode ? end : node == startNode ? start : nodeCell(node);
+                if (route.empty() || !(route.back() == cell)) {
+                    route.push_back(cell);
+                }
+            }
+            reverse(route.begin(), route.end());
+            return route;
+        }
+
+        if (current.node == startNode) {
+            const vector<Entrance>& list = entrances[startCluster];
+            for (size_t j = 0; j < list.size(); j++) {
+                int d = localDistance[localIndex(startCluster, list[j].cell)];
+                if (d >= 0) relax(startNode, static_cast<int>(firstNode[startCluster] + j), d);
+            }
+            if (startCluster == goalCluster) {
+                int d = localDistance[localIndex(startCluster, end)];
+                if (d >= 0) relax(startNode, goalNode, d);
+            }
+            continue;
+        }
+
+        int cluster = static_cast<int>(upper_bound(firstNode.begin(), firstNode.end(), static_cast<size_t>(current.node)) - firstNode.begin()) - 1;
+        size_t i = current.node - firstNode[cluster];
+        const vector<Entrance>& list = entrances[cluster];
+        for (size_t j = 0; j < list.size(); j++) {
+            int d = distances[cluster][i * list.size() + j];
+            if (j != i && d >= 0) relax(current.node, static_cast<int>(firstNode[cluster] + j), d);
+        }
+        // Across the border to the matching entrance of the neighbour
+        const Entrance& entrance = list[i];
+        const vector<Entrance>& across = entrances[entrance.partnerCluster];
+        for (size_t k = 0; k < across.size(); k++) {
+            if (across[k].cell == entrance.partner && across[k].partner == entrance.cell) {
+                relax(current.node, static_cast<int>(firstNode[entrance.partnerCluster] + k), 1);
+                break;
+            }
+        }
+        if (cluster == goalCluster && toGoal[i] >= 0) {
+            relax(current.node, goalNode, toGoal[i]);
+        }
+    }
+    return {};
+}
+
+vector<Point> ClusterPathFinder::refineSegment(Point from, Point to) {
+    if (from == to) {
+        return {from};
+    }
+    if (dist(from, to, cols, rows) == 1) {
+        return {from, to};
+    }
+    int cluster = clusterOf(from);
+    int target = localIndex(cluster, to);
+    if (target < 0) {
+        return {};
+    }
+    searchCluster(cluster, from);
+    if (localDistance[target] < 0) {
+        return {};
+    }
+    int x0 = (cluster % clustersX) * clusterSize;
+    int y0 = (cluster / clustersX) * clusterSize;
+    int stride = min(clusterSize, cols - x0) + 2;
+    vector<Point> path;
+    for (int index = target; index >= 0; index = localParent[index]) {
+        path.push_back({x0 + index % stride - 1, y0 + index / stride - 1});
+    }
+    reverse(path.begin(), path.end());
+    return path;
+}
+
+vector<Point> ClusterPathFinder::refineRoute(const vector<Point>& route) {
+    if (route.empty()) {
+        return {};
+    }
+    vector<Point> path{route[0]};
+    for (size_t i = 1; i < route.size(); i++) {
+        vector<Point> segment = refineSegment(route[i - 1], route[i]);
+        if (segment.empty()) {
+            return {};
+        }
+        path.insert(path.end(), segment.begin() + 1, segment.end());
+    }
+    return path;
+}
+
+vector<Point> ClusterPathFinder::findPath(const vector<vector<char>>& grid, Point start, Point end) {
+    cout << "Starting cluster search from (" << start.x << "," << start.y << ") to (" << end.x << "," << end.y << ")" << endl;
+    update(grid);
+    int length;
+    vector<Point> route = coarseRoute(start, end, length);
+    vector<Point> path = refineRoute(route);
+    if (path.empty()) {
+        cout << "No route through the cluster entrances, searching the board" << endl;
+        return jumpPointPathfinder(grid, start, end, false, fallback);
+    }
+    cout << "Path length: " << path.size() << " steps, " << route.size() << " waypoints, "
+         << rebuilt << " clusters rebuilt" << endl;
+    return path;
+}
+
+void PathBuffer::grow() {
+    pmr::vector<Cell> larger(max<size_t>(16, cells.size() * 2), cells.get_allocator());
+    for (size_t i = 0; i < count; i++) {
+        larger[i] = cells[(head + i) & (cells.size() - 1)];
+    }
+    cells.swap(larger);
+    head = 0;
+}
+
+vector<Point> PathBuffer::toVector() const {
+    vector<Point> path;
+    path.reserve(count);
+    for (size_t i = 0; i < count; i++) {
+        path.push_back((*this)[i]);
+    }
+    return path;
 }
 
 int dist(Point p1, Point p2, int rows, int cols) {
@@ -135,7 +1108,7 @@ int distArr(array<int,2> p1, array<int,2> p2, int rows, int cols) {
     return dist({p1[0], p1[1]}, {p2[0], p2[1]}, rows, cols);
 }
 
-void updatePathEnd(vector<Point> &path, Point &newEnd, int rows, int cols) {
+void updatePathEnd(PathBuffer &path, Point &newEnd, int rows, int cols) {
     Point end = path.back();
     path.pop_back();
     if (newEnd == end) {
@@ -166,75 +1139,57 @@ void updatePathEnd(vector<Point> &path, Point &newEnd, int rows, int cols) {
     }
 }
 
-void updatePathStart(vector<Point> &path, Point &newStart, int rows, int cols) {
+void updatePathStart(PathBuffer &path, Point &newStart, int rows, int cols) {
     Point start = path.front();
-    path.erase(path.begin());
+    path.pop_front();
     if (newStart == start) {
-        path.insert(path.begin(), start);
+        path.push_front(start);
     }
     else if (path.size() > 1) {
         Point nearStart = path.front();
-        path.erase(path.begin());
+        path.pop_front();
         if (!(newStart == nearStart)) {
             if (dist(start, newStart, rows, cols) >= dist(nearStart, newStart, rows, cols)) {
                 if (!path.empty()) {
                     Point nearNearStart = path.front();
                     if (dist(newStart, nearNearStart, rows, cols) > 1) {
-                        path.insert(path.begin(), nearStart);
+                        path.push_front(nearStart);
                     }
                 }
             }
             else {
-                path.insert(path.begin(), nearStart);
-                path.insert(path.begin(), start);
+                path.push_front(nearStart);
+                path.push_front(start);
             }
         }
-        path.insert(path.begin(), newStart);
+        path.push_front(newStart);
     } else {
         if(dist(newStart, path.back(), rows, cols) > 1)
-            path.insert(path.begin(), start);
-        path.insert(path.begin(), newStart);
-    }
-}
-
-array<int,2> calcDirection(vector<Point> &path, int rows, int columns) {
-    Point *start = &path[0];
-    Point *next = &path[1];
-    int dx, dy;
-    if (start->x == next->x)
-        dy = 0;
-    else if (start->x == 0 && next->x == rows - 1) 
-        dy = -1;
-    else if (start->x == rows - 1 && next->x == 0)
-        dy = 1;
-    else
-        dy = next->x - start->x;
-
-    if (start->y == next->y)
-        dx = 0;
-    else if (start->y == 0 && next->y == columns - 1) 
-        dx = -1;
-    else if (start->y == columns - 1 && next->y == 0)
-        dx = 1;
-    else
-        dx = next->y - start->y;
-    
-    return {dy, dx};
+            path.push_front(start);
+        path.push_front(newStart);
+    }
+}
+
+array<int,2> calcDirection(const PathBuffer &path, int /*rows*/, int /*columns*/) {
+    // Same convention as directionBetweenPoints: the first entry follows Point::x
+    Point start = path[0];
+    Point next = path[1];
+    return directionBetweenPoints(start, next);
 }
 
-bool isPathStraight(vector<Point> &path, int rows, int columns) {
+bool isPathStraight(const PathBuffer &path, int rows, int columns) {
     if (path.size() == 1) {
         return true;
     }
     array<int,2> dir = calcDirection(path, rows, columns);
 
     for (size_t i = 1; i < path.size() - 1; ++i) {
-        Point *start = &path[i];
-        Point *next = &path[i+1];
-        if (!((next->x - start->x)%columns == dir[0]%columns)) {
+        Point start = path[i];
+        Point next = path[i+1];
+        if (!((next.x - start.x)%columns == dir[0]%columns)) {
             return false;
         }
-        if (!((next->y - start->y)%rows == dir[1]%rows)) {
+        if (!((next.y - start.y)%rows == dir[1]%rows)) {
             return false;
         }
     }
@@ -262,33 +1217,16 @@ void printPath(const vector<Point>& path) {
 
 
 int inverseMap(array<int, 2> d) {
-    for(int i = 0; i < 8; ++i) {
-        if (directions[i][0] == d[0] && directions[i][1] == d[1]) {
-            return i;
-        }
-    }
-    return -1; // Return -1 if direction not found
+    // The search table above lists (row, column) steps clockwise from up, two places
+    // after Directions' clockwise order from right
+    int index = Directions::indexOf(d[1], d[0]);
+    return index < 0 ? -1 : Directions::rotate(index, 2);
 }
 
 
 int getRotation45(array<int, 2> from, array<int, 2> to) {
-    // All 8 directions in clockwise order
-    const vector<array<int, 2>> directions = {
-        {1, 0},   // 0 - right
-        {1, 1},   // 1 - down-right
-        {0, 1},   // 2 - down
-        {-1, 1},  // 3 - down-left
-        {-1, 0},  // 4 - left
-        {-1, -1}, // 5 - up-left
-        {0, -1},  // 6 - up
-        {1, -1}   // 7 - up-right
-    };
-
-    int fromIndex = -1, toIndex = -1;
-    for (int i = 0; i < 8; ++i) {
-        if (directions[i] == from) fromIndex = i;
-        if (directions[i] == to) toIndex = i;
-    }
+    int fromIndex = Directions::indexOf(from);
+    int toIndex = Directions::indexOf(to);
 
     if (fromIndex == -1 || toIndex == -1) {
         throw std::invalid_argument("Invalid direction vector");
@@ -308,15 +1246,7 @@ Turn rotation(array<int,2> currDir, array<int,2> newDir) {
 
 
 array<int,2> directionBetweenPoints(Point &start, Point &end) {
-    int dy = end.x - start.x; //this is not a mistake
-    int dx = end.y - start.y;
-    if (dy > 1) 
-        dy = -1;
-    else if (dy < -1)
-        dy = 1;
-    if (dx > 1) 
-        dx = -1;
-    else if (dx < -1)
-        dx = 1; 
+    int dy = Directions::wrapDelta(end.x - start.x); //this is not a mistake
+    int dx = Directions::wrapDelta(end.y - start.y);
     return {dy, dx};
-}
\ No newline at end of file
+}
@@ -1,6 +1,10 @@
 #pragma once
 
 #include <vector>
+#include <memory_resource>
+#include <atomic>
+#include <cstdint>
+#include <array>
 #include <queue>
 #include <stack>
 #include <algorithm>
@@ -10,6 +14,8 @@
 
 using namespace std;
 
+class WorkStealingPool;
+
 struct Point {
     int x, y;
     bool operator==(const Point& other) const {
@@ -22,6 +28,228 @@ struct Node {
     int dist;
 };
 
+// A path kept as a ring of 16-bit cells, so steps come off and go on at either end in
+// O(1) and the capacity is kept when the path is replaced. Holds the cells of any board
+// BoardReader accepts, whose sides are at most BoardConstants::MAX_SIDE.
+class PathBuffer {
+public:
+    explicit PathBuffer(pmr::memory_resource* resource = pmr::get_default_resource()) : cells(resource) {}
+
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    Point operator[](size_t i) const { return at(head + i); }
+    Point front() const { return at(head); }
+    Point back() const { return at(head + count - 1); }
+
+    void push_front(Point p) {
+        if (count == cells.size()) grow();
+        head = (head + cells.size() - 1) & (cells.size() - 1);
+        cells[head] = {static_cast<uint16_t>(p.x), static_cast<uint16_t>(p.y)};
+        count++;
+    }
+    void push_back(Point p) {
+        if (count == cells.size()) grow();
+        cells[(head + count) & (cells.size() - 1)] = {static_cast<uint16_t>(p.x), static_cast<uint16_t>(p.y)};
+        count++;
+    }
+    void pop_front() { head = (head + 1) & (cells.size() - 1); count--; }
+    void pop_back() { count--; }
+    void clear() { head = 0; count = 0; }
+    void assign(const vector<Point>& path) {
+        clear();
+        for (Point p : path) push_back(p);
+    }
+    vector<Point> toVector() const;
+    void swap(PathBuffer& other) {
+        cells.swap(other.cells);
+        std::swap(head, other.head);
+        std::swap(count, other.count);
+    }
+
+private:
+    struct Cell {
+        uint16_t x, y;
+    };
+    pmr::vector<Cell> cells;  // Capacity is zero or a power of two
+    size_t head = 0;
+    size_t count = 0;
+
+    Point at(size_t i) const {
+        Cell cell = cells[i & (cells.size() - 1)];
+        return {cell.x, cell.y};
+    }
+    void grow();
+};
+
+// Reusable BFS buffers, allocated from the given resource and kept between searches
+// so that repeated searches on the same board do not allocate
+struct BfsScratch {
+    explicit BfsScratch(pmr::memory_resource* resource = pmr::get_default_resource())
+        : visited(resource), parent(resource), frontier(resource) {}
+    pmr::vector<char> visited;   // Row-major
+    pmr::vector<Point> parent;   // Row-major
+    pmr::vector<Node> frontier;  // FIFO queue, consumed from a head index
+};
+
+// Reusable buffers of parallelBfsPathfinder. One search at a time per scratch.
+struct ParallelBfsScratch {
+    vector<atomic<uint64_t>> visited;  // Bitmap over row-major cells
+    vector<atomic<uint32_t>> claim;    // Lowest frontier index that reached each cell in its level
+    vector<uint32_t> parent;           // Row-major, as cell indices
+    vector<uint32_t> frontier;         // The current level, in the order a sequential BFS dequeues it
+    vector<vector<pair<uint32_t, uint32_t>>> reached;  // Per chunk, (frontier index, cell) claims made
+    vector<vector<uint32_t>> next;                     // Per chunk, cells it won, in order
+    size_t levels = 0;                 // Levels expanded by the last search
+};
+
+// Reusable buffers of jumpPointPathfinder, kept between searches like BfsScratch
+struct JpsScratch {
+    struct Open {
+        int f, g;
+        Point pt;
+    };
+    explicit JpsScratch(pmr::memory_resource* resource = pmr::get_default_resource())
+        : g(resource), parent(resource), arrival(resource), closed(resource), open(resource) {}
+    pmr::vector<int> g;               // Row-major best known distance from the start
+    pmr::vector<Point> parent;        // Row-major previous jump point
+    pmr::vector<signed char> arrival; // Row-major direction index the cell was jumped to in, -1 for the start
+    pmr::vector<char> closed;         // Row-major
+    pmr::vector<Open> open;           // Binary heap on f
+    size_t expanded = 0;              // Jump points expanded by the last search
+};
+
+// Shortest path to one target kept between battle-info refreshes (D* Lite). The search
+// is rooted at the target, so after the start moves, the target moves or cells change,
+// only the cells whose distance changed are expanded again. Walls always block.
+class IncrementalPathFinder {
+public:
+    explicit IncrementalPathFinder(pmr::memory_resource* resource = pmr::get_default_resource());
+
+    vector<Point> plan(const vector<vector<char>>& grid, Point start, Point end);    // From scratch
+    vector<Point> replan(const vector<vector<char>>& grid, Point start, Point end);  // Repair the last plan
+    void clear() { planned = false; }
+
+    bool hasPlan() const { return planned; }
+    Point target() const { return goal; }
+    size_t expandedCells() const { return expanded; }  // By the last plan or replan
+
+private:
+    struct Key {
+        int first, second;
+        bool operator<(const Key& other) const {
+            return first < other.first || (first == other.first && second < other.second);
+        }
+    };
+    struct Entry {
+        Key key;
+        size_t cell;
+    };
+
+    pmr::vector<int> g;
+    pmr::vector<int> rhs;
+    pmr::vector<char> blocked;  // Row-major, as in the board of the last plan
+    pmr::vector<Key> queuedKey;
+    pmr::vector<char> queued;
+    pmr::vector<Entry> queue;   // Binary heap; entries whose key is stale are skipped
+    int rows = 0;
+    int cols = 0;
+    Point start{-1, -1};
+    Point lastStart{-1, -1};
+    Point goal{-1, -1};
+    int keyModifier = 0;
+    bool planned = false;
+    size_t expanded = 0;
+
+    size_t at(Point p) const { return static_cast<size_t>(p.y) * cols + p.x; }
+    Point pointOf(size_t cell) const { return {static_cast<int>(cell % cols), static_cast<int>(cell / cols)}; }
+    int heuristic(Point p) const;
+    Key keyOf(size_t cell) const;
+    void push(size_t cell);
+    bool topKey(Key& key);
+    void updateCell(size_t cell);
+    void updateNeighbours(size_t cell);
+    void computeShortestPath();
+    vector<Point> extractPath() const;
+};
+
+// Cluster abstraction for very large boards (HPA*). The board is cut into square
+// clusters; where two neighbouring clusters touch, runs of free cells on both sides
+// become entrances, and the distances between the entrances of each cluster are
+// precomputed. Queries search the small graph of entrances and refine only the
+// segments asked for. Walls always block and borders are only crossed straight, so
+// findPath() falls back to the flat search when the entrances find nothing.
+class ClusterPathFinder {
+public:
+    static constexpr int DEFAULT_CLUSTER_SIZE = 32;
+
+    explicit ClusterPathFinder(int clusterSize = DEFAULT_CLUSTER_SIZE);
+
+    // Build the abstraction for this board, or bring it up to date with it: only the
+    // clusters with cells that opened or closed, and their neighbours, are rebuilt
+    void update(const vector<vector<char>>& grid);
+
+    // Waypoints from start to end, both included, each within one cluster of the
+    // next; empty if none. length is the route's length in steps.
+    vector<Point> coarseRoute(Point start, Point end, int& length);
+    // Every cell from one waypoint of a route to the next, both included
+    vector<Point> refineSegment(Point from, Point to);
+    vector<Point> refineRoute(const vector<Point>& route);
+
+    // Same contract as bfsPathfinder without walls: every cell from start to end
+    vector<Point> findPath(const vector<vector<char>>& grid, Point start, Point end);
+
+    size_t rebuiltClusters() const { return rebuilt; }  // By the last update
+    size_t expandedNodes() const { return expanded; }   // By the last coarse route
+
+private:
+    struct Entrance {
+        Point cell;
+        Point partner;       // Cell across the border
+        int partnerCluster;
+    };
+    struct Open {
+        int f, g, node;
+    };
+
+    int clusterSize;
+    int rows = 0;
+    int cols = 0;
+    int clustersX = 0;
+    int clustersY = 0;
+    vector<char> blocked;                            // Row-major
+    vector<vector<pair<Point, Point>>> rightBorder;  // Per cluster, crossings into the cluster on its right
+    vector<vector<pair<Point, Point>>> downBorder;   // Per cluster, crossings into the cluster below
+    vector<vector<Entrance>> entrances;              // Per cluster
+    vector<vector<int>> distances;                   // Per cluster, entrances x entrances, -1 if unreachable
+    vector<size_t> firstNode;                        // Per cluster, id of its first entrance in the search graph
+
+    // Search buffers, reset by stamp rather than cleared
+    vector<int> g;
+    vector<int> parent;
+    vector<unsigned> seen;
+    vector<unsigned> closed;
+    unsigned stamp = 0;
+    vector<Open> open;
+    vector<int> localDistance;
+    vector<int> localParent;
+    vector<int> localQueue;
+    vector<char> localBlocked;  // Framed copy of one cluster's cells
+    int framedCluster = -1;
+    JpsScratch fallback;
+    size_t rebuilt = 0;
+    size_t expanded = 0;
+
+    int clusterOf(Point p) const { return (p.y / clusterSize) * clustersX + p.x / clusterSize; }
+    bool isBlocked(int x, int y) const { return blocked[static_cast<size_t>(y) * cols + x]; }
+    void buildBorders(int cluster);
+    void buildEntrances(int cluster);
+    void buildDistances(int cluster);
+    // BFS from `from` that stays inside the cluster; distances and parents by local index
+    void searchCluster(int cluster, Point from);
+    int localIndex(int cluster, Point p) const;
+    Point nodeCell(int node) const;
+};
+
 enum Turn {
     RIGHT_90 = 2,
     RIGHT_45 = 1,
@@ -42,11 +270,21 @@ array<int,2> directionBetweenPoints(Point &start, Point &end);
 bool isValid(int x, int y, const vector<vector<char>>& grid, const vector<vector<bool>>& visited, bool includeWalls);
 Point wrapPoint(int x, int y, int rows, int cols);
 vector<Point> bfsPathfinder(const vector<vector<char>>& grid, Point start, Point end, bool includeWalls);
+vector<Point> bfsPathfinder(const vector<vector<char>>& grid, Point start, Point end, bool includeWalls, BfsScratch& scratch);
+// The same into a buffer, built from the end backwards without a reversal; false if no path
+bool bfsPathfinder(const vector<vector<char>>& grid, Point start, Point end, bool includeWalls, BfsScratch& scratch, PathBuffer& path);
+// Level-synchronous BFS with each large frontier split across the pool (one thread when null).
+// A cell's parent is the first frontier cell that reaches it, so the path is the same as bfsPathfinder's.
+vector<Point> parallelBfsPathfinder(const vector<vector<char>>& grid, Point start, Point end, bool includeWalls,
+                                    WorkStealingPool* pool, ParallelBfsScratch& scratch);
+// A* over jump points: same path length as bfsPathfinder, but straight and diagonal runs
+// through open space are skipped over instead of expanded cell by cell
+vector<Point> jumpPointPathfinder(const vector<vector<char>>& grid, Point start, Point end, bool includeWalls, JpsScratch& scratch);
 int dist(Point p1, Point p2, int rows, int cols);
 int distArr(array<int,2> p1, array<int,2> p2, int rows, int cols);
-void updatePathEnd(vector<Point> &path, Point &newEnd, int rows, int cols);
-void updatePathStart(vector<Point> &path, Point &newStart, int rows, int cols);
-bool isPathStraight(vector<Point> &path, int rows, int columns);
+void updatePathEnd(PathBuffer &path, Point &newEnd, int rows, int cols);
+void updatePathStart(PathBuffer &path, Point &newStart, int rows, int cols);
+bool isPathStraight(const PathBuffer &path, int rows, int columns);
 bool isPathClear(vector<Point> &path, const vector<vector<char>>& grid);
-array<int,2> calcDirection(vector<Point> &path, int rows, int columns);
+array<int,2> calcDirection(const PathBuffer &path, int rows, int columns);
 void printPath(const vector<Point>& path);
\ No newline at end of file
@@ -1,84 +1,100 @@
-#pragma once
-#include "BattleInfo.h"
-#include "SatelliteView.h"
-#include <vector>
-
-class SatelliteBattleInfo : public BattleInfo {
-private:
-    SatelliteView* satelliteView;
-    std::vector<std::vector<char>> board;
-    size_t rows;
-    size_t columns;
-    int tankX;
-    int tankY;
-    int playerIndex;
-
-public:
-    SatelliteBattleInfo(SatelliteView* view, int player_index) : satelliteView(view), playerIndex(player_index) {
-        // Initialize board dimensions based on the view
-        rows = 0;
-        columns = 0;
-        tankX = -1;
-        tankY = -1;
-        // We'll populate the board when needed
-    }
-    virtual ~SatelliteBattleInfo() {}
-
-    char getObjectAt(size_t x, size_t y) const {
-        return satelliteView->getObjectAt(x, y);
-    }
-
-    // New methods to access board information
-    const std::vector<std::vector<char>>& getBoard() const { return board; }
-    size_t getRows() const { return rows; }
-    size_t getColumns() const { return columns; }
-    
-    // Tank position getters
-    int getTankX() const { return tankX; }
-    int getTankY() const { return tankY; }
-    
-    // Player index getter
-    int getPlayerIndex() const { return playerIndex; }
-
-    // Method to update the board
-    void updateBoard() {
-        // Find the dimensions by checking the view
-        size_t maxX = 0, maxY = 0;
-        for (size_t y = 0; ; y++) {
-            bool rowHasContent = false;
-            for (size_t x = 0; ; x++) {
-                char obj = satelliteView->getObjectAt(x, y);
-                if (obj == '&') { // '&' indicates out of bounds
-                    break;
-                }
-                rowHasContent = true;
-                maxX = std::max(maxX, x);
-            }
-            if (!rowHasContent) {
-                break;
-            }
-            maxY = y;
-        }
-
-        // Update dimensions
-        rows = maxY + 1;
-        columns = maxX + 1;
-
-        // Reset tank position
-        tankX = -1;
-        tankY = -1;
-
-        // Resize and populate the board
-        board.resize(rows, std::vector<char>(columns));
-        for (size_t y = 0; y < rows; y++) {
-            for (size_t x = 0; x < columns; x++) {
-                board[y][x] = satelliteView->getObjectAt(x, y);
-                // Track tank position
-                if (board[y][x] == '%') {
-                    tankX = x;
-                    tankY = y;
-                }
-            }
-        }
-    }
+#pragma once
+#include "BattleInfo.h"
+#include "SatelliteView.h"
+#include <vector>
+
+class SatelliteBattleInfo : public BattleInfo {
+private:
+    SatelliteView* satelliteView;
+    std::vector<std::vector<char>> board;
+    std::vector<std::vector<int>> shellEta;  // Rounds until a shell arrives per cell, NO_SHELL if none
+    std::vector<std::vector<int>> component; // Connected component per cell, NO_COMPONENT if unknown
+    size_t rows;
+    size_t columns;
+    int tankX;
+    int tankY;
+    int playerIndex;
+
+public:
+    SatelliteBattleInfo(SatelliteView* view, int player_index) : satelliteView(view), playerIndex(player_index) {
+        // Initialize board dimensions based on the view
+        rows = 0;
+        columns = 0;
+        tankX = -1;
+        tankY = -1;
+        // We'll populate the board when needed
+    }
+    virtual ~SatelliteBattleInfo() {}
+
+    char getObjectAt(size_t x, size_t y) const {
+        return satelliteView->getObjectAt(x, y);
+    }
+
+    // New methods to access board information
+    const std::vector<std::vector<char>>& getBoard() const { return board; }
+    size_t getRows() const { return rows; }
+    size_t getColumns() const { return columns; }
+    
+    // Shell arrival predictions, relative to the round the info was delivered in
+    static constexpr int NO_SHELL = SatelliteView::NO_SHELL;
+    const std::vector<std::vector<int>>& getShellEta() const { return shellEta; }
+    int getRoundsUntilShell(size_t x, size_t y) const { return shellEta[y][x]; }
+
+    // Connected components of the cells reachable without shooting walls or driving
+    // onto mines. Cells in different components can't reach each other that way.
+    static constexpr int NO_COMPONENT = SatelliteView::NO_COMPONENT;
+    const std::vector<std::vector<int>>& getComponents() const { return component; }
+
+    // Tank position getters
+    int getTankX() const { return tankX; }
+    int getTankY() const { return tankY; }
+    
+    // Player index getter
+    int getPlayerIndex() const { return playerIndex; }
+
+    // Method to update the board
+    void updateBoard() {
+        // Find the dimensions by checking the view
+        size_t maxX = 0, maxY = 0;
+        for (size_t y = 0; ; y++) {
+            bool rowHasContent = false;
+            for (size_t x = 0; ; x++) {
+                char obj = satelliteView->getObjectAt(x, y);
+                if (obj == '&') { // '&' indicates out of bounds
+                    break;
+                }
+                rowHasContent = true;
+                maxX = std::max(maxX, x);
+            }
+            if (!rowHasContent) {
+                break;
+            }
+            maxY = y;
+        }
+
+        // Update dimensions
+        rows = maxY + 1;
+        columns = maxX + 1;
+
+        // Reset tank position
+        tankX = -1;
+        tankY = -1;
+
+        // Resize and populate the board
+        board.resize(rows, std::vector<char>(columns));
+        shellEta.resize(rows, std::vector<int>(columns, NO_SHELL));
+        component.resize(rows, std::vector<int>(columns, NO_COMPONENT));
+        for (size_t y = 0; y < rows; y++) {
+            for (size_t x = 0; x < columns; x++) {
+                board[y][x] = satelliteView->getObjectAt(x, y);
+                shellEta[y][x] = satelliteView->getRoundsUntilShell(x, y);
+                component[y][x] = satelliteView->getComponent(x, y);
+                // Track tank position
+                if (board[y][x] == '%') {
+                    tankX = x;
+                    tankY = y;
+                }
+            }
+        }
+    }
 }; 
\ No newline at end of file
@@ -7,4 +7,12 @@ class SatelliteView {
 public:
     virtual ~SatelliteView() {}
     virtual char getObjectAt(size_t x, size_t y) const = 0;
+
+    // Predictions a view may carry beyond the cells; a plain view has none
+    static constexpr int NO_SHELL = -1;
+    static constexpr int NO_COMPONENT = -1;
+    // Rounds until the next predicted shell reaches (x, y), or NO_SHELL
+    virtual int getRoundsUntilShell(size_t /*x*/, size_t /*y*/) const { return NO_SHELL; }
+    // Cells of the same component connect without shooting walls, NO_COMPONENT if unknown
+    virtual int getComponent(size_t /*x*/, size_t /*y*/) const { return NO_COMPONENT; }
 };
@@ -1,5 +1,24 @@
 #include "TankAlgorithm.h"
+#include <cstring>
 
 TankAlgorithm::~TankAlgorithm() {
     // Base class destructor implementation
+}
+
+void TankAlgorithm::mixState(uint64_t& hash, uint64_t value) {
+    hash = (hash ^ value) * 0x9E3779B97F4A7C15ULL;
+    hash ^= hash >> 29;
+}
+
+void TankAlgorithm::mixState(uint64_t& hash, const void* data, size_t size) {
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    mixState(hash, size);
+    for (; size >= sizeof(uint64_t); size -= sizeof(uint64_t), bytes += sizeof(uint64_t)) {
+        uint64_t word;
+        std::memcpy(&word, bytes, sizeof(word));
+        mixState(hash, word);
+    }
+    uint64_t tail = 0;
+    std::memcpy(&tail, bytes, size);
+    mixState(hash, tail);
 } 
\ No newline at end of file
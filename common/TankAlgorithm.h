@@ -1,4 +1,6 @@
 #pragma once
+#include <cstddef>
+#include <cstdint>
 #include "ActionRequest.h"
 #include "BattleInfo.h"
 
@@ -8,4 +10,14 @@ public:
     virtual ~TankAlgorithm();
     virtual ActionRequest getAction() = 0;
     virtual void updateBattleInfo(BattleInfo& info) = 0;
+
+    // Mix everything that decides the algorithm's future actions into hash and return true.
+    // Two states with the same hash must act the same from then on, so counters should go
+    // in only as far as they matter (a remainder, a distance to a deadline). The default
+    // returns false: the state is unknown and cycles of the game are not fast-forwarded.
+    virtual bool hashState(uint64_t& /*hash*/) const { return false; }
+
+protected:
+    static void mixState(uint64_t& hash, uint64_t value);
+    static void mixState(uint64_t& hash, const void* data, size_t size);
 };
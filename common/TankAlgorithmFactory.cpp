@@ -2,4 +2,8 @@
 
 TankAlgorithmFactory::TankAlgorithmFactory() {
     // Base class constructor implementation
-} 
\ No newline at end of file
+}
+
+TankAlgorithmPtr TankAlgorithmFactory::createInArena(int player_index, int tank_index, pmr::memory_resource* /*resource*/) const {
+    return TankAlgorithmPtr(create(player_index, tank_index));
+}
@@ -1,11 +1,50 @@
 #pragma once
 #include <memory>
+#include <memory_resource>
+#include <new>
 #include <cstddef>
+#include <string>
 #include "Player.h"
 #include "TankAlgorithm.h"
 
 using namespace std;
 
+// Deleter for tank algorithms that may have been constructed inside a memory resource
+struct TankAlgorithmDeleter {
+    pmr::memory_resource* resource = nullptr;  // nullptr for algorithms allocated with new
+    size_t size = 0;
+    size_t alignment = 0;
+
+    TankAlgorithmDeleter() = default;
+    TankAlgorithmDeleter(pmr::memory_resource* resource, size_t size, size_t alignment)
+        : resource(resource), size(size), alignment(alignment) {}
+    TankAlgorithmDeleter(const default_delete<TankAlgorithm>&) {}
+
+    void operator()(TankAlgorithm* algorithm) const {
+        if (!resource) {
+            delete algorithm;
+            return;
+        }
+        algorithm->~TankAlgorithm();
+        resource->deallocate(algorithm, size, alignment);
+    }
+};
+
+using TankAlgorithmPtr = unique_ptr<TankAlgorithm, TankAlgorithmDeleter>;
+
+// Construct an algorithm of type T inside the given resource
+template <typename T, typename... Args>
+TankAlgorithmPtr makeTankAlgorithm(pmr::memory_resource* resource, Args&&... args) {
+    void* memory = resource->allocate(sizeof(T), alignof(T));
+    try {
+        T* algorithm = new (memory) T(std::forward<Args>(args)...);
+        return TankAlgorithmPtr(algorithm, TankAlgorithmDeleter(resource, sizeof(T), alignof(T)));
+    } catch (...) {
+        resource->deallocate(memory, sizeof(T), alignof(T));
+        throw;
+    }
+}
+
 class TankAlgorithmFactory
 {
 private:
@@ -14,4 +53,12 @@ public:
     TankAlgorithmFactory(/* args */);
     virtual ~TankAlgorithmFactory() {}
     virtual unique_ptr<TankAlgorithm> create(int player_index, int tank_index) const = 0;
+
+    // Create an algorithm whose memory comes from the given resource, which outlives it.
+    // The default falls back to create() and the heap.
+    virtual TankAlgorithmPtr createInArena(int player_index, int tank_index, pmr::memory_resource* resource) const;
+
+    // Identifies the algorithms this factory creates, for caching game results. Must change
+    // whenever their behaviour does. Empty means results are not reproducible and never cached.
+    virtual string versionTag() const { return ""; }
 };
@@ -0,0 +1,200 @@
+#include "WorkStealingPool.h"
+#include <algorithm>
+#include <iostream>
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace {
+    // Pool and worker index of the calling thread, set inside worker threads only
+    thread_local const WorkStealingPool* workerPool = nullptr;
+    thread_local size_t workerIndex = 0;
+}
+
+WorkStealingPool::WorkStealingPool(unsigned threads, bool pinThreads)
+    : pendingTasks(0), nextQueue(0), stopping(false), blockedWaiters(0)
+{
+    if (threads == 0) {
+        threads = std::max(1u, thread::hardware_concurrency());
+    }
+    for (unsigned i = 0; i < threads; i++) {
+        queues.push_back(make_unique<WorkerQueue>());
+    }
+    for (unsigned i = 0; i < threads; i++) {
+        workers.emplace_back(&WorkStealingPool::workerLoop, this, i, pinThreads);
+    }
+}
+
+WorkStealingPool::~WorkStealingPool() {
+    {
+        lock_guard<mutex> guard(sleepLock);
+        stopping = true;
+    }
+    wakeUp.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+int WorkStealingPool::currentWorker() const {
+    return workerPool == this ? static_cast<int>(workerIndex) : -1;
+}
+
+void WorkStealingPool::submit(function<void()> task) {
+    int worker = currentWorker();
+    size_t target = worker >= 0 ? static_cast<size_t>(worker) : nextQueue++ % queues.size();
+    // Counted before the push so a fast pop can never take the count below zero
+    pendingTasks++;
+    {
+        lock_guard<mutex> guard(queues[target]->lock);
+        queues[target]->tasks.push_back(std::move(task));
+    }
+    bool waiters;
+    {
+        // Pairs with the predicate checks in workerLoop and waitForWork so the wake-up cannot be missed
+        lock_guard<mutex> guard(sleepLock);
+        waiters = blockedWaiters > 0;
+    }
+    wakeUp.notify_one();
+    if (waiters) {
+        waiterWakeUp.notify_all();
+    }
+}
+
+void WorkStealingPool::waitForWork(const function<bool()>& ready) {
+    unique_lock<mutex> guard(sleepLock);
+    blockedWaiters++;
+    waiterWakeUp.wait(guard, [this, &ready]() { return ready() || pendingTasks > 0; });
+    blockedWaiters--;
+}
+
+void WorkStealingPool::notifyWaiters() {
+    bool waiters;
+    {
+        lock_guard<mutex> guard(sleepLock);
+        waiters = blockedWaiters > 0;
+    }
+    if (waiters) {
+        waiterWakeUp.notify_all();
+    }
+}
+
+void WorkStealingPool::runTask(function<void()>& task) {
+    try {
+        task();
+    } catch (const exception& e) {
+        std::cerr << "WorkStealingPool: task failed: " << e.what() << std::endl;
+    } catch (...) {
+        std::cerr << "WorkStealingPool: task failed" << std::endl;
+    }
+}
+
+bool WorkStealingPool::popLocal(size_t index, function<void()>& task) {
+    WorkerQueue& queue = *queues[index];
+    lock_guard<mutex> guard(queue.lock);
+    if (queue.tasks.empty()) {
+        return false;
+    }
+    task = std::move(queue.tasks.back());
+    queue.tasks.pop_back();
+    pendingTasks--;
+    return true;
+}
+
+bool WorkStealingPool::steal(size_t thief, function<void()>& task) {
+    // Oldest tasks are stolen first, they tend to be the largest pieces of work
+    for (size_t k = 1; k <= queues.size(); k++) {
+        WorkerQueue& queue = *queues[(thief + k) % queues.size()];
+        lock_guard<mutex> guard(queue.lock);
+        if (!queue.tasks.empty()) {
+            task = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+            pendingTasks--;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool WorkStealingPool::runPendingTask() {
+    function<void()> task;
+    int worker = currentWorker();
+    bool found = worker >= 0 ? (popLocal(worker, task) || steal(worker, task)) : steal(0, task);
+    if (found) {
+        runTask(task);
+    }
+    return found;
+}
+
+void WorkStealingPool::workerLoop(size_t index, bool pin) {
+    workerPool = this;
+    workerIndex = index;
+    if (pin) {
+#ifdef __linux__
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        CPU_SET(index % std::max(1u, thread::hardware_concurrency()), &cpus);
+        if (pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus) != 0) {
+            std::cerr << "WorkStealingPool: Could not pin worker " << index << std::endl;
+        }
+#endif
+    }
+
+    while (true) {
+        function<void()> task;
+        if (popLocal(index, task) || steal(index, task)) {
+            runTask(task);
+            continue;
+        }
+        unique_lock<mutex> guard(sleepLock);
+        wakeUp.wait(guard, [this]() { return stopping || pendingTasks > 0; });
+        if (stopping && pendingTasks == 0) {
+            return;
+        }
+    }
+}
+
+TaskGroup::TaskGroup(WorkStealingPool& pool) : pool(pool), outstanding(0) {}
+
+TaskGroup::~TaskGroup() {
+    // Tasks reference the group, never let it go away under them
+    try {
+        wait();
+    } catch (...) {
+    }
+}
+
+void TaskGroup::run(function<void()> task) {
+    outstanding++;
+    pool.submit([this, &pool = pool, task = std::move(task)]() {
+        try {
+            task();
+        } catch (...) {
+            lock_guard<mutex> guard(errorLock);
+            if (!firstError) {
+                firstError = current_exception();
+            }
+        }
+        // The group may be gone once the count reaches zero, only the pool is left to use
+        if (--outstanding == 0) {
+            pool.notifyWaiters();
+        }
+    });
+}
+
+void TaskGroup::wait() {
+    while (outstanding > 0) {
+        if (!pool.runPendingTask()) {
+            pool.waitForWork([this]() { return outstanding == 0; });
+        }
+    }
+    exception_ptr error;
+    {
+        lock_guard<mutex> guard(errorLock);
+        std::swap(error, firstError);
+    }
+    if (error) {
+        rethrow_exception(error);
+    }
+}
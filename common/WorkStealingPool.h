@@ -0,0 +1,86 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+// Fixed-size thread pool with one task deque per worker. A worker takes its newest
+// task first and, when its own deque is empty, steals the oldest task of another
+// worker. Tasks submitted from inside the pool go to the submitting worker's deque,
+// so nested parallel work stays local until someone is idle.
+class WorkStealingPool {
+public:
+    // threads == 0 uses the hardware concurrency. Pinning binds worker i to core i
+    // where the platform supports it and is ignored elsewhere.
+    explicit WorkStealingPool(unsigned threads = 0, bool pinThreads = false);
+    ~WorkStealingPool();
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    // An exception escaping a task is reported on stderr and dropped; TaskGroup hands
+    // them back to the waiting thread instead
+    void submit(function<void()> task);
+    unsigned size() const { return static_cast<unsigned>(workers.size()); }
+
+    // Run one queued task on the calling thread; false if none was available.
+    // Lets threads that wait on pool work help instead of blocking.
+    bool runPendingTask();
+
+    // Block until ready() holds or a task is queued. Whoever makes ready() true must call
+    // notifyWaiters() afterwards.
+    void waitForWork(const function<bool()>& ready);
+    void notifyWaiters();
+
+private:
+    struct WorkerQueue {
+        mutex lock;
+        deque<function<void()>> tasks;
+    };
+
+    vector<unique_ptr<WorkerQueue>> queues;
+    vector<thread> workers;
+    atomic<size_t> pendingTasks;
+    atomic<size_t> nextQueue;  // Round-robin target for submissions from outside the pool
+    atomic<bool> stopping;
+    mutex sleepLock;
+    condition_variable wakeUp;
+    condition_variable waiterWakeUp;  // Threads in waitForWork()
+    unsigned blockedWaiters;          // Guarded by sleepLock
+
+    int currentWorker() const;  // Index of the calling worker in this pool, -1 if not one
+    bool popLocal(size_t index, function<void()>& task);
+    bool steal(size_t thief, function<void()>& task);
+    void workerLoop(size_t index, bool pin);
+    static void runTask(function<void()>& task);
+};
+
+// Set of tasks that can be waited on together. The waiting thread runs pool tasks
+// while any are queued, so groups can be nested inside pool tasks without
+// deadlocking, and sleeps otherwise.
+// The first exception thrown by a task is rethrown from wait().
+class TaskGroup {
+public:
+    explicit TaskGroup(WorkStealingPool& pool);
+    ~TaskGroup();
+
+    TaskGroup(const TaskGroup&) = delete;
+    TaskGroup& operator=(const TaskGroup&) = delete;
+
+    void run(function<void()> task);
+    void wait();
+
+private:
+    WorkStealingPool& pool;
+    atomic<size_t> outstanding;
+    mutex errorLock;
+    exception_ptr firstError;
+};
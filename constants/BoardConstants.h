@@ -8,9 +8,11 @@ namespace BoardConstants {
     const char EMPTY_SPACE = ' ';
     const char PLAYER1_TANK = '1';
     const char PLAYER2_TANK = '2';
+    const int MAX_TEAMS = 9;  // Tanks of team k are written as the digit k
     const char REQUESTING_TANK = '%';
     const char SHELL = '*';
     const char INVALID_LOCATION = '&';
+    const unsigned MAX_SIDE = 65535;  // Most rows or columns of a board; paths keep cells in 16 bits
 
     // Collision states
     const char TANK_SHELL_COLLISION = 'X';
@@ -20,10 +22,25 @@ namespace BoardConstants {
     const char TANK_MINE_COLLISION = 'T';
     const char TANK_TANK_COLLISION = 'C';
 
+    // Team helpers, valid for teams 1 to MAX_TEAMS
+    inline bool isTankChar(char c) {
+        return c >= '1' && c < '1' + MAX_TEAMS;
+    }
+    inline int teamOf(char tankChar) {
+        return tankChar - '0';
+    }
+    inline char tankChar(int team) {
+        return static_cast<char>('0' + team);
+    }
+    // Odd teams start facing left, even teams right, as players 1 and 2 always did
+    inline int startingDx(int team) {
+        return (team % 2 == 1) ? -1 : 1;
+    }
+
     // Helper function to check if a character represents a collision
     inline bool isCollision(char c) {
         return c != WALL && c != DAMAGED_WALL && c != MINE && 
-               c != EMPTY_SPACE && c != PLAYER1_TANK && c != PLAYER2_TANK && 
+               c != EMPTY_SPACE && !isTankChar(c) && 
                c != SHELL;
     }
 } 
\ No newline at end of file
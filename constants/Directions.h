@@ -0,0 +1,67 @@
+#pragma once
+#include <array>
+#include <cstddef>
+
+// The eight movement directions, indexed clockwise starting from right.
+// Everything that rotates or steps an object goes through these tables.
+namespace Directions {
+    constexpr int COUNT = 8;
+
+    constexpr int RIGHT = 0;
+    constexpr int DOWN_RIGHT = 1;
+    constexpr int DOWN = 2;
+    constexpr int DOWN_LEFT = 3;
+    constexpr int LEFT = 4;
+    constexpr int UP_LEFT = 5;
+    constexpr int UP = 6;
+    constexpr int UP_RIGHT = 7;
+
+    // [dx, dy] per direction index
+    constexpr std::array<std::array<int, 2>, COUNT> VECTORS = {{
+        {1, 0}, {1, 1}, {0, 1}, {-1, 1},
+        {-1, 0}, {-1, -1}, {0, -1}, {1, -1}
+    }};
+
+    // Direction index per [dy + 1][dx + 1], -1 for the zero vector
+    constexpr int INDEX_OF[3][3] = {
+        {UP_LEFT, UP, UP_RIGHT},
+        {LEFT, -1, RIGHT},
+        {DOWN_LEFT, DOWN, DOWN_RIGHT}
+    };
+
+    constexpr int dx(int index) { return VECTORS[index][0]; }
+    constexpr int dy(int index) { return VECTORS[index][1]; }
+
+    // -1 if (dx, dy) is not one of the eight directions
+    constexpr int indexOf(int dx, int dy) {
+        return (dx < -1 || dx > 1 || dy < -1 || dy > 1) ? -1 : INDEX_OF[dy + 1][dx + 1];
+    }
+    constexpr int indexOf(const std::array<int, 2>& direction) {
+        return indexOf(direction[0], direction[1]);
+    }
+
+    // Rotate by a number of 45 degree steps, positive is clockwise
+    constexpr int rotate(int index, int steps) {
+        return (index + steps % COUNT + COUNT) % COUNT;
+    }
+    constexpr int opposite(int index) { return rotate(index, COUNT / 2); }
+
+    // Move one cell along an axis of the given size, wrapping around the edges
+    constexpr size_t wrapStep(size_t position, int delta, size_t size) {
+        if (delta < 0) {
+            return position == 0 ? size - 1 : position - 1;
+        }
+        if (delta > 0) {
+            return position + 1 == size ? 0 : position + 1;
+        }
+        return position;
+    }
+
+    // Collapse a coordinate difference between neighbouring cells of a wrapping
+    // board into -1, 0 or 1. A jump across the edge points the other way.
+    constexpr int wrapDelta(int delta) {
+        if (delta > 1) return -1;
+        if (delta < -1) return 1;
+        return delta;
+    }
+}
@@ -0,0 +1,170 @@
+#include "AllocationStats.h"
+#include "TypeName.h"
+
+#ifdef TANK_ALLOC_STATS
+#include <atomic>
+#include <cstdlib>
+#include <iomanip>
+#include <mutex>
+#include <new>
+#include <string>
+
+namespace AllocationStats {
+namespace {
+    constexpr size_t PHASES = static_cast<size_t>(Phase::Count);
+    constexpr int MAX_ALGORITHMS = 16;
+
+    const char* const PHASE_NAMES[PHASES] = {"other", "snapshot", "shells", "decisions", "apply", "logging", "output"};
+
+    // Plain atomics only: nothing here may allocate, it runs inside operator new
+    struct Counter {
+        std::atomic<unsigned long long> allocations{0};
+        std::atomic<unsigned long long> bytes{0};
+        std::atomic<unsigned long long> frees{0};
+    };
+
+    Counter phaseCounters[PHASES];
+    Counter algorithmCounters[MAX_ALGORITHMS];
+    const std::type_info* algorithmTypes[MAX_ALGORITHMS];
+    std::atomic<int> algorithmCount{0};
+    std::mutex registerMutex;
+
+    thread_local Phase currentPhase = Phase::Other;
+    thread_local int currentAlgorithm = -1;
+
+    void countAllocation(size_t size) {
+        Counter& phase = phaseCounters[static_cast<size_t>(currentPhase)];
+        phase.allocations.fetch_add(1, std::memory_order_relaxed);
+        phase.bytes.fetch_add(size, std::memory_order_relaxed);
+        if (currentAlgorithm >= 0) {
+            Counter& algorithm = algorithmCounters[currentAlgorithm];
+            algorithm.allocations.fetch_add(1, std::memory_order_relaxed);
+            algorithm.bytes.fetch_add(size, std::memory_order_relaxed);
+        }
+    }
+
+    void countFree() {
+        phaseCounters[static_cast<size_t>(currentPhase)].frees.fetch_add(1, std::memory_order_relaxed);
+        if (currentAlgorithm >= 0) {
+            algorithmCounters[currentAlgorithm].frees.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    void* allocate(size_t size) {
+        void* memory = std::malloc(size == 0 ? 1 : size);
+        if (!memory) {
+            throw std::bad_alloc();
+        }
+        countAllocation(size);
+        return memory;
+    }
+
+    void release(void* memory) {
+        if (memory) {
+            countFree();
+            std::free(memory);
+        }
+    }
+
+    void printRow(std::ostream& out, const std::string& name, const Counter& counter) {
+        unsigned long long allocations = counter.allocations.load(std::memory_order_relaxed);
+        unsigned long long bytes = counter.bytes.load(std::memory_order_relaxed);
+        out << std::left << std::setw(32) << name << std::right
+            << std::setw(14) << allocations
+            << std::setw(16) << bytes
+            << std::setw(14) << counter.frees.load(std::memory_order_relaxed)
+            << std::setw(12) << (allocations > 0 ? bytes / allocations : 0) << '\n';
+    }
+
+    void printHeader(std::ostream& out, const char* title) {
+        out << std::left << std::setw(32) << title << std::right
+            << std::setw(14) << "allocations" << std::setw(16) << "bytes"
+            << std::setw(14) << "frees" << std::setw(12) << "avg bytes" << '\n';
+    }
+}
+
+Phase setPhase(Phase phase) {
+    Phase previous = currentPhase;
+    currentPhase = phase;
+    return previous;
+}
+
+int setAlgorithm(int slot) {
+    int previous = currentAlgorithm;
+    currentAlgorithm = slot;
+    return previous;
+}
+
+int algorithmSlot(const std::type_info& type) {
+    int count = algorithmCount.load(std::memory_order_acquire);
+    for (int i = 0; i < count; i++) {
+        if (*algorithmTypes[i] == type) {
+            return i;
+        }
+    }
+    std::lock_guard<std::mutex> lock(registerMutex);
+    count = algorithmCount.load(std::memory_order_relaxed);
+    for (int i = 0; i < count; i++) {
+        if (*algorithmTypes[i] == type) {
+            return i;
+        }
+    }
+    if (count == MAX_ALGORITHMS) {
+        return -1;  // Not broken down any further, still counted per phase
+    }
+    algorithmTypes[count] = &type;
+    algorithmCount.store(count + 1, std::memory_order_release);
+    return count;
+}
+
+void printReport(std::ostream& out) {
+    // Snapshot first, so the report's own allocations don't show up in it
+    Counter total;
+    for (const Counter& counter : phaseCounters) {
+        total.allocations += counter.allocations.load(std::memory_order_relaxed);
+        total.bytes += counter.bytes.load(std::memory_order_relaxed);
+        total.frees += counter.frees.load(std::memory_order_relaxed);
+    }
+
+    out << "\nHeap allocations per phase\n";
+    printHeader(out, "phase");
+    for (size_t i = 0; i < PHASES; i++) {
+        printRow(out, PHASE_NAMES[i], phaseCounters[i]);
+    }
+    printRow(out, "total", total);
+
+    int count = algorithmCount.load(std::memory_order_acquire);
+    if (count > 0) {
+        out << "\nHeap allocations per algorithm (inside getAction and updateBattleInfo)\n";
+        printHeader(out, "algorithm");
+        for (int i = 0; i < count; i++) {
+            printRow(out, demangledName(*algorithmTypes[i]), algorithmCounters[i]);
+        }
+    }
+    out << std::flush;
+}
+}
+
+void* operator new(size_t size) { return AllocationStats::allocate(size); }
+void* operator new[](size_t size) { return AllocationStats::allocate(size); }
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+    try {
+        return AllocationStats::allocate(size);
+    } catch (...) {
+        return nullptr;
+    }
+}
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+    try {
+        return AllocationStats::allocate(size);
+    } catch (...) {
+        return nullptr;
+    }
+}
+void operator delete(void* memory) noexcept { AllocationStats::release(memory); }
+void operator delete[](void* memory) noexcept { AllocationStats::release(memory); }
+void operator delete(void* memory, size_t) noexcept { AllocationStats::release(memory); }
+void operator delete[](void* memory, size_t) noexcept { AllocationStats::release(memory); }
+void operator delete(void* memory, const std::nothrow_t&) noexcept { AllocationStats::release(memory); }
+void operator delete[](void* memory, const std::nothrow_t&) noexcept { AllocationStats::release(memory); }
+#endif
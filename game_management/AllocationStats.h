@@ -0,0 +1,59 @@
+#pragma once
+#include <cstddef>
+#include <ostream>
+#include <typeinfo>
+
+// Heap allocation accounting for instrumentation builds (cmake -DTANK_ALLOC_STATS=ON).
+// The global operator new and delete are replaced to count allocations and bytes under
+// the phase of the game, and the algorithm class, the allocating thread is tagged with.
+// In normal builds the scopes below compile to nothing.
+namespace AllocationStats {
+    enum class Phase { Other, Snapshot, Shells, Decisions, Apply, Logging, Output, Count };
+
+#ifdef TANK_ALLOC_STATS
+    constexpr bool enabled = true;
+
+    Phase setPhase(Phase phase);        // Returns the previous phase of this thread
+    int setAlgorithm(int slot);         // Returns the previous slot of this thread, -1 for none
+    int algorithmSlot(const std::type_info& type);  // Stable slot per algorithm class
+
+    void printReport(std::ostream& out);
+
+    // Tag the allocations of this thread until the end of the scope
+    class PhaseScope {
+    private:
+        Phase previous;
+    public:
+        explicit PhaseScope(Phase phase) : previous(setPhase(phase)) {}
+        ~PhaseScope() { setPhase(previous); }
+        PhaseScope(const PhaseScope&) = delete;
+        PhaseScope& operator=(const PhaseScope&) = delete;
+    };
+
+    class AlgorithmScope {
+    private:
+        int previous;
+    public:
+        template <typename Algorithm>
+        explicit AlgorithmScope(const Algorithm& algorithm) : previous(setAlgorithm(algorithmSlot(typeid(algorithm)))) {}
+        ~AlgorithmScope() { setAlgorithm(previous); }
+        AlgorithmScope(const AlgorithmScope&) = delete;
+        AlgorithmScope& operator=(const AlgorithmScope&) = delete;
+    };
+#else
+    constexpr bool enabled = false;
+
+    inline void printReport(std::ostream&) {}
+
+    class PhaseScope {
+    public:
+        explicit PhaseScope(Phase) {}
+    };
+
+    class AlgorithmScope {
+    public:
+        template <typename Algorithm>
+        explicit AlgorithmScope(const Algorithm&) {}
+    };
+#endif
+}
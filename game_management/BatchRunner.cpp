@@ -0,0 +1,383 @@
+#include "BatchRunner.h"
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <thread>
+#ifdef __unix__
+#include <csignal>
+#include <cerrno>
+#include <poll.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+BatchRunner::BatchRunner(PlayerFactory& playerFactory, TankAlgorithmFactory& algorithmFactory, WorkStealingPool& pool)
+    : playerFactory(playerFactory), algorithmFactory(algorithmFactory), pool(&pool), cycleFastForward(false), statsOutput(false),
+      latencyOutput(false), boardCache(false), slowDecisionLimit(0), replaceSlowActions(false), cache(nullptr), liveExport(nullptr),
+      gameTimeout(0)
+{
+}
+
+BatchRunner::BatchRunner(PlayerFactory& playerFactory, TankAlgorithmFactory& algorithmFactory)
+    : playerFactory(playerFactory), algorithmFactory(algorithmFactory), pool(nullptr), cycleFastForward(false), statsOutput(false),
+      latencyOutput(false), boardCache(false), slowDecisionLimit(0), replaceSlowActions(false), cache(nullptr), liveExport(nullptr),
+      gameTimeout(0)
+{
+}
+
+void BatchRunner::playGame(BatchEntry& entry) {
+    try {
+        GameManager game(playerFactory, algorithmFactory);
+        game.setCycleFastForward(cycleFastForward);
+        game.setStatsOutput(statsOutput);
+        game.setLatencyOutput(latencyOutput);
+        game.setSlowDecisionReport(slowDecisionLimit, replaceSlowActions);
+        game.setBoardCache(boardCache);
+        game.setLiveExport(liveExport);
+        game.readBoard(entry.boardFile);
+        bool useCache = cache && !versionTag.empty();
+        uint64_t key = useCache ? ResultCache::key(game.getGameData(), versionTag) : 0;
+        if (useCache && cache->lookup(key, entry.result)) {
+            entry.cached = true;
+            return;
+        }
+        game.run();
+        entry.result = game.getResult();
+        if (useCache && entry.result.reason != GameResult::Reason::NotFinished) {
+            cache->store(key, entry.result);
+        }
+    } catch (const exception& e) {
+        entry.failed = true;
+        entry.error = e.what();
+    }
+}
+
+vector<BatchEntry> BatchRunner::run(const vector<string>& boardFiles) {
+    if (!pool) {
+        throw runtime_error("BatchRunner: run() needs a thread pool");
+    }
+    vector<BatchEntry> entries(boardFiles.size());
+    TaskGroup games(*pool);
+    for (size_t i = 0; i < boardFiles.size(); i++) {
+        entries[i].boardFile = boardFiles[i];
+        games.run([this, &entry = entries[i]]() {
+            playGame(entry);
+        });
+    }
+    games.wait();
+    return entries;
+}
+
+vector<BatchEntry> BatchRunner::runLockstep(const vector<string>& boardFiles) {
+    vector<BatchEntry> entries(boardFiles.size());
+    vector<BoardData> boards(boardFiles.size());
+    vector<uint64_t> keys(boardFiles.size(), 0);
+    vector<size_t> toPlay;
+    bool useCache = cache && !versionTag.empty();
+    for (size_t i = 0; i < boardFiles.size(); i++) {
+        entries[i].boardFile = boardFiles[i];
+        try {
+            boards[i] = BoardReader::readBoard(boardFiles[i], boardCache);
+        } catch (const exception& e) {
+            entries[i].failed = true;
+            entries[i].error = e.what();
+            continue;
+        }
+        if (useCache) {
+            keys[i] = ResultCache::key(boards[i], versionTag);
+            if (cache->lookup(keys[i], entries[i].result)) {
+                entries[i].cached = true;
+                continue;
+            }
+        }
+        toPlay.push_back(i);
+    }
+
+    // Deal the games out evenly, one batch per thread
+    size_t batches = pool ? min<size_t>(pool->size(), toPlay.size()) : min<size_t>(1, toPlay.size());
+    auto playBatch = [&](size_t batchIndex) {
+        LockstepBatch batch;
+        vector<size_t> played;
+        for (size_t k = batchIndex; k < toPlay.size(); k += batches) {
+            BatchEntry& entry = entries[toPlay[k]];
+            try {
+                batch.addGame(boards[toPlay[k]], playerFactory, algorithmFactory);
+                played.push_back(toPlay[k]);
+            } catch (const exception& e) {
+                entry.failed = true;
+                entry.error = e.what();
+            }
+        }
+        batch.run();
+        for (size_t game = 0; game < played.size(); game++) {
+            BatchEntry& entry = entries[played[game]];
+            if (!batch.getError(game).empty()) {
+                entry.failed = true;
+                entry.error = batch.getError(game);
+                continue;
+            }
+            entry.result = batch.getResult(game);
+            if (useCache) {
+                cache->store(keys[played[game]], entry.result);
+            }
+        }
+    };
+    if (pool && batches > 1) {
+        TaskGroup group(*pool);
+        for (size_t b = 0; b < batches; b++) {
+            group.run([&playBatch, b]() { playBatch(b); });
+        }
+        group.wait();
+    } else if (batches == 1) {
+        playBatch(0);
+    }
+    return entries;
+}
+
+#ifdef __unix__
+namespace {
+    // Fixed-size record a worker sends back for every game
+    struct WireResult {
+        int32_t failed;
+        int32_t cached;
+        int32_t reason;
+        int32_t winner;
+        int32_t numTeams;
+        uint64_t rounds;
+        uint64_t teamTanks[BoardConstants::MAX_TEAMS + 1];
+        char error[256];
+    };
+
+    struct Worker {
+        pid_t pid = -1;
+        int toWorker = -1;    // Parent writes game indices here
+        int fromWorker = -1;  // Parent reads WireResults here
+        long job = -1;        // Index of the game in progress, -1 when idle
+        chrono::steady_clock::time_point started;  // Of the game in progress
+    };
+
+    bool writeAll(int fd, const void* data, size_t size) {
+        const char* bytes = static_cast<const char*>(data);
+        while (size > 0) {
+            ssize_t written = write(fd, bytes, size);
+            if (written < 0 && errno == EINTR) continue;
+            if (written <= 0) return false;
+            bytes += written;
+            size -= static_cast<size_t>(written);
+        }
+        return true;
+    }
+
+    bool readAll(int fd, void* data, size_t size) {
+        char* bytes = static_cast<char*>(data);
+        while (size > 0) {
+            ssize_t got = read(fd, bytes, size);
+            if (got < 0 && errno == EINTR) continue;
+            if (got <= 0) return false;
+            bytes += got;
+            size -= static_cast<size_t>(got);
+        }
+        return true;
+    }
+
+    void closeWorker(Worker& worker) {
+        if (worker.toWorker >= 0) close(worker.toWorker);
+        if (worker.fromWorker >= 0) close(worker.fromWorker);
+        worker.toWorker = worker.fromWorker = -1;
+    }
+
+    string describeExit(int status) {
+        if (WIFSIGNALED(status)) {
+            return "crashed with signal " + to_string(WTERMSIG(status)) + " (" + strsignal(WTERMSIG(status)) + ")";
+        }
+        if (WIFEXITED(status)) {
+            return "worker exited with status " + to_string(WEXITSTATUS(status));
+        }
+        return "worker stopped unexpectedly";
+    }
+}
+#endif
+
+vector<BatchEntry> BatchRunner::runIsolated(const vector<string>& boardFiles, unsigned workerCount) {
+    vector<BatchEntry> entries(boardFiles.size());
+    for (size_t i = 0; i < boardFiles.size(); i++) {
+        entries[i].boardFile = boardFiles[i];
+    }
+#ifndef __unix__
+    (void)workerCount;
+    throw runtime_error("BatchRunner: process isolation is only available on POSIX systems");
+#else
+    if (workerCount == 0) {
+        workerCount = max(1u, thread::hardware_concurrency());
+    }
+    vector<Worker> workers(min<size_t>(workerCount, boardFiles.size()));
+    // A write to a worker that just died must fail instead of killing the runner
+    auto previousPipeHandler = signal(SIGPIPE, SIG_IGN);
+
+    auto workerLoop = [&](int in, int out) {
+        uint32_t index;
+        while (readAll(in, &index, sizeof(index))) {
+            BatchEntry entry;
+            entry.boardFile = boardFiles[index];
+            playGame(entry);
+            WireResult wire{};
+            wire.failed = entry.failed;
+            wire.cached = entry.cached;
+            wire.reason = static_cast<int32_t>(entry.result.reason);
+            wire.winner = entry.result.winner;
+            wire.numTeams = entry.result.numTeams;
+            wire.rounds = entry.result.rounds;
+            for (size_t team = 0; team < entry.result.teamTanks.size(); team++) {
+                wire.teamTanks[team] = entry.result.teamTanks[team];
+            }
+            strncpy(wire.error, entry.error.c_str(), sizeof(wire.error) - 1);
+            std::cout.flush();
+            if (!writeAll(out, &wire, sizeof(wire))) {
+                break;
+            }
+        }
+        std::cout.flush();
+        std::cerr.flush();
+        _exit(0);
+    };
+
+    auto spawn = [&](Worker& worker) {
+        int request[2], response[2];
+        if (pipe(request) != 0 || pipe(response) != 0) {
+            throw runtime_error(string("BatchRunner: pipe failed: ") + strerror(errno));
+        }
+        // Buffered output would otherwise be written again by the child
+        std::cout.flush();
+        std::cerr.flush();
+        pid_t pid = fork();
+        if (pid < 0) {
+            throw runtime_error(string("BatchRunner: fork failed: ") + strerror(errno));
+        }
+        if (pid == 0) {
+            // Keep only this worker's ends, so other workers see their pipes close
+            for (Worker& other : workers) {
+                closeWorker(other);
+            }
+            close(request[1]);
+            close(response[0]);
+            workerLoop(request[0], response[1]);
+        }
+        close(request[0]);
+        close(response[1]);
+        worker.pid = pid;
+        worker.toWorker = request[1];
+        worker.fromWorker = response[0];
+        worker.job = -1;
+    };
+
+    size_t next = 0;
+    auto dispatch = [&](Worker& worker) {
+        worker.job = -1;
+        if (next < boardFiles.size()) {
+            worker.job = static_cast<long>(next);
+            worker.started = chrono::steady_clock::now();
+            uint32_t index = static_cast<uint32_t>(next++);
+            // A failed write shows up as a closed result pipe below
+            writeAll(worker.toWorker, &index, sizeof(index));
+        }
+    };
+
+    for (Worker& worker : workers) {
+        spawn(worker);
+        dispatch(worker);
+    }
+
+    // Wait for results, but no longer than until the oldest game in progress runs out of time
+    auto pollTimeout = [&]() {
+        if (gameTimeout.count() <= 0) {
+            return -1;
+        }
+        auto now = chrono::steady_clock::now();
+        chrono::milliseconds wait = gameTimeout;
+        for (const Worker& worker : workers) {
+            if (worker.job >= 0) {
+                auto left = chrono::duration_cast<chrono::milliseconds>(worker.started + gameTimeout - now);
+                // Round up, so the game is over its time when poll returns
+                wait = min(wait, max(left + chrono::milliseconds(1), chrono::milliseconds(0)));
+            }
+        }
+        return static_cast<int>(min<long long>(wait.count(), INT_MAX));
+    };
+
+    size_t done = 0;
+    while (done < boardFiles.size()) {
+        vector<pollfd> fds;
+        vector<Worker*> polled;
+        for (Worker& worker : workers) {
+            if (worker.job >= 0) {
+                fds.push_back({worker.fromWorker, POLLIN, 0});
+                polled.push_back(&worker);
+            }
+        }
+        if (poll(fds.data(), fds.size(), pollTimeout()) < 0) {
+            if (errno == EINTR) continue;
+            throw runtime_error(string("BatchRunner: poll failed: ") + strerror(errno));
+        }
+
+        auto now = chrono::steady_clock::now();
+        for (size_t i = 0; i < fds.size(); i++) {
+            Worker& worker = *polled[i];
+            BatchEntry& entry = entries[worker.job];
+            if (fds[i].revents == 0) {
+                if (gameTimeout.count() > 0 && now - worker.started >= gameTimeout) {
+                    // The game is stuck or too slow: kill its worker and start a fresh one
+                    kill(worker.pid, SIGKILL);
+                    closeWorker(worker);
+                    waitpid(worker.pid, nullptr, 0);
+                    entry.failed = true;
+                    entry.crashed = true;
+                    entry.error = "timed out after " + to_string(gameTimeout.count()) + " ms";
+                    std::cerr << "BatchRunner: " << entry.boardFile << " " << entry.error << std::endl;
+                    spawn(worker);
+                    done++;
+                    dispatch(worker);
+                }
+                continue;
+            }
+            WireResult wire;
+            if (readAll(worker.fromWorker, &wire, sizeof(wire))) {
+                entry.failed = wire.failed != 0;
+                entry.cached = wire.cached != 0;
+                entry.result.reason = static_cast<GameResult::Reason>(wire.reason);
+                entry.result.winner = wire.winner;
+                entry.result.numTeams = wire.numTeams;
+                entry.result.rounds = wire.rounds;
+                for (size_t team = 0; team < entry.result.teamTanks.size(); team++) {
+                    entry.result.teamTanks[team] = wire.teamTanks[team];
+                }
+                wire.error[sizeof(wire.error) - 1] = '\0';
+                entry.error = wire.error;
+            } else {
+                // The worker died mid-game: record the crash and start a fresh one
+                int status = 0;
+                closeWorker(worker);
+                waitpid(worker.pid, &status, 0);
+                entry.failed = true;
+                entry.crashed = true;
+                entry.error = describeExit(status);
+                std::cerr << "BatchRunner: " << entry.boardFile << " " << entry.error << std::endl;
+                spawn(worker);
+            }
+            done++;
+            dispatch(worker);
+        }
+    }
+
+    // Closing the request pipes lets the workers exit
+    for (Worker& worker : workers) {
+        closeWorker(worker);
+    }
+    for (Worker& worker : workers) {
+        waitpid(worker.pid, nullptr, 0);
+    }
+    signal(SIGPIPE, previousPipeHandler);
+    return entries;
+#endif
+}
@@ -0,0 +1,73 @@
+#pragma once
+#include <string>
+#include <vector>
+#include "GameManager.h"
+#include "ResultCache.h"
+#include "LockstepBatch.h"
+#include "../common/WorkStealingPool.h"
+
+using namespace std;
+
+struct BatchEntry {
+    string boardFile;
+    GameResult result;
+    bool failed = false;
+    bool cached = false;  // Result came from the cache, the game was not played
+    bool crashed = false;  // The worker process playing the game died
+    string error;  // Why the game could not be run, when failed
+};
+
+// Runs one game per board file, either on a shared pool of threads or on a pool of
+// forked worker processes. Every game gets its own GameManager; with threads the
+// factories are shared and must be safe to call concurrently.
+class BatchRunner {
+public:
+    BatchRunner(PlayerFactory& playerFactory, TankAlgorithmFactory& algorithmFactory, WorkStealingPool& pool);
+    // Without a pool only runIsolated() can be used
+    BatchRunner(PlayerFactory& playerFactory, TankAlgorithmFactory& algorithmFactory);
+
+    void setCycleFastForward(bool enabled) { cycleFastForward = enabled; }
+    void setStatsOutput(bool enabled) { statsOutput = enabled; }
+    void setLatencyOutput(bool enabled) { latencyOutput = enabled; }
+    void setBoardCache(bool enabled) { boardCache = enabled; }
+    void setSlowDecisionReport(chrono::nanoseconds limit, bool replaceSlow) { slowDecisionLimit = limit; replaceSlowActions = replaceSlow; }
+    // Skip games whose result is cached under this tag, and cache the results of played ones.
+    // An empty tag disables the cache.
+    void setResultCache(ResultCache* resultCache, const string& tag) { cache = resultCache; versionTag = tag; }
+    // Stream games to a live viewer, one at a time; lockstep batches publish nothing
+    void setLiveExport(LiveStateExport* exporter) { liveExport = exporter; }
+    // Wall-clock limit of one game in runIsolated(); 0 for none. Threads cannot be
+    // stopped, so run() and runLockstep() ignore it.
+    void setGameTimeout(chrono::milliseconds timeout) { gameTimeout = timeout; }
+
+    // Results are returned in the order of boardFiles
+    vector<BatchEntry> run(const vector<string>& boardFiles);
+
+    // Same, but every game runs in one of `workers` forked processes (0 for one per core).
+    // A worker that crashes only loses its current game, which is recorded as crashed,
+    // and is replaced by a fresh one. So does a worker still playing a game when the game
+    // timeout runs out: it is killed and the game recorded as crashed, timed out.
+    // POSIX only. Must be called while no other threads run.
+    vector<BatchEntry> runIsolated(const vector<string>& boardFiles, unsigned workers);
+
+    // Same results as run(), but the games are played in lockstep by one LockstepBatch per
+    // pool thread (one in all without a pool). Writes no output or statistics files.
+    vector<BatchEntry> runLockstep(const vector<string>& boardFiles);
+
+private:
+    PlayerFactory& playerFactory;
+    TankAlgorithmFactory& algorithmFactory;
+    WorkStealingPool* pool;
+    bool cycleFastForward;
+    bool statsOutput;
+    bool latencyOutput;
+    bool boardCache;
+    chrono::nanoseconds slowDecisionLimit;
+    bool replaceSlowActions;
+    ResultCache* cache;
+    string versionTag;
+    LiveStateExport* liveExport;
+    chrono::milliseconds gameTimeout;
+
+    void playGame(BatchEntry& entry);  // Fill in the entry from the cache or by playing it
+};
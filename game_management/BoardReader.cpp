@@ -1,9 +1,96 @@
 #include "BoardReader.h"
 #include <iostream>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <sstream>
+#include <thread>
+#ifdef __unix__
+#include <unistd.h>
+#endif
 
 using namespace std;
 using namespace BoardConstants;
 
+namespace {
+    // 64-bit FNV-1a, taking eight bytes at a time as boards can be megabytes
+    const uint64_t FNV_OFFSET = 0xCBF29CE484222325ULL;
+    const uint64_t FNV_PRIME = 0x100000001B3ULL;
+
+    uint64_t hashBytes(const void* data, size_t size) {
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+        uint64_t hash = FNV_OFFSET;
+        size_t i = 0;
+        for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+            uint64_t word;
+            memcpy(&word, bytes + i, sizeof(word));
+            hash = (hash ^ word) * FNV_PRIME;
+        }
+        for (; i < size; i++) {
+            hash = (hash ^ bytes[i]) * FNV_PRIME;
+        }
+        return hash;
+    }
+
+    // The whole file in one read
+    bool readFile(ifstream& file, string& contents) {
+        file.seekg(0, ios::end);
+        streamoff size = file.tellg();
+        if (size < 0) {
+            return false;
+        }
+        contents.resize(static_cast<size_t>(size));
+        file.seekg(0, ios::beg);
+        return static_cast<bool>(file.read(&contents[0], size));
+    }
+
+    // Sidecar layout: header, map name (32-bit length, then the bytes), tanks, the grid
+    // at two cells per byte (low half first), then the hash of everything before it
+    const char CACHE_MAGIC[4] = {'T', 'K', 'B', 'C'};
+    const uint32_t CACHE_VERSION = 2;
+
+    struct CacheHeader {
+        char magic[4];
+        uint32_t version;
+        uint64_t sourceSize;
+        int64_t sourceTime;
+        uint64_t sourceHash;
+        uint64_t maxStep;
+        uint64_t numShells;
+        uint64_t rows;
+        uint64_t columns;
+        int32_t numTeams;
+        uint32_t tankCount;
+    };
+
+    struct CacheTank {
+        uint32_t x, y;
+        int32_t team;
+        int32_t tankIndex;
+    };
+
+    // Cells left after validation: empty, wall, mine and the tank digits
+    const char CELL_CODES[] = {EMPTY_SPACE, WALL, MINE, '1', '2', '3', '4', '5', '6', '7', '8', '9'};
+    const unsigned NUM_CELL_CODES = sizeof(CELL_CODES);
+
+    unsigned cellCode(char cell) {
+        if (isTankChar(cell)) return 3 + (cell - '1');
+        if (cell == WALL) return 1;
+        if (cell == MINE) return 2;
+        return 0;
+    }
+
+    // In ticks of the file clock, whose epoch is up to the library; false if unavailable
+    bool modificationTime(const string& fileName, int64_t& time) {
+        error_code error;
+        auto written = filesystem::last_write_time(fileName, error);
+        time = static_cast<int64_t>(written.time_since_epoch().count());
+        return !error;
+    }
+}
+
 void BoardReader::logError(const string& errorMessage) {
     ofstream errorFile("board_errors.txt", ios::app);
     if (errorFile.is_open()) {
@@ -38,7 +125,7 @@ size_t BoardReader::parseValue(const string& value, const string& param, const s
     }
 }
 
-size_t BoardReader::extractVal(ifstream &f, const string& param) {
+size_t BoardReader::extractVal(istream &f, const string& param) {
     string line;
     if (!getline(f, line)) {
         logError("Error: " + param + " not specified");
@@ -49,7 +136,7 @@ size_t BoardReader::extractVal(ifstream &f, const string& param) {
 }
 
 char BoardReader::validateAndProcessChar(char c, int line_number, size_t position) {
-    if (c != WALL && c != MINE && c != PLAYER1_TANK && c != PLAYER2_TANK && c != EMPTY_SPACE) {
+    if (c != WALL && c != MINE && !isTankChar(c) && c != EMPTY_SPACE) {
         logError("Warning: Invalid character '" + string(1, c) + "' at line " + 
                 to_string(line_number) + ", position " + to_string(position) + 
                 ". Replacing with empty space.");
@@ -64,11 +151,12 @@ void BoardReader::processBoardLine(const string& line, int line_number, BoardDat
         char c;
         if (i < line.length()) {
             c = validateAndProcessChar(line[i], line_number, i);
-            // Count tanks while processing
-            if (c == PLAYER1_TANK) {
-                data.player1TankCount++;
-            } else if (c == PLAYER2_TANK) {
-                data.player2TankCount++;
+            // Count and list tanks while processing
+            if (isTankChar(c)) {
+                int team = teamOf(c);
+                data.tanks.push_back({i, data.board.size(), team, static_cast<int>(data.teamTankCounts[team])});
+                data.teamTankCounts[team]++;
+                data.numTeams = max(data.numTeams, team);
             }
         } else {
             c = EMPTY_SPACE;
@@ -88,7 +176,7 @@ void BoardReader::fillMissingRows(BoardData& data) {
     }
 }
 
-void BoardReader::buildBoard(ifstream &f, BoardData& data) {
+void BoardReader::buildBoard(istream &f, BoardData& data) {
     int line_number = 6;
     string s;
 
@@ -112,38 +200,219 @@ void BoardReader::buildBoard(ifstream &f, BoardData& data) {
 
 void BoardReader::validateTanks(BoardData& data) {
     // Only validate and warn about tank counts
-    if (data.player1TankCount == 0 && data.player2TankCount == 0) {
-        logError("Warning: No tanks found for either player. This will result in an immediate tie.");
-    } else if (data.player1TankCount == 0) {
-        logError("Warning: No tanks found for Player 1. Player 1 will lose immediately.");
-    } else if (data.player2TankCount == 0) {
-        logError("Warning: No tanks found for Player 2. Player 2 will lose immediately.");
+    size_t totalTanks = 0;
+    for (int team = 1; team <= data.numTeams; team++) {
+        totalTanks += data.tankCount(team);
+    }
+    if (totalTanks == 0) {
+        logError(string("Warning: No tanks found for ") + (data.numTeams == 2 ? "either" : "any") +
+                 " player. This will result in an immediate tie.");
+        return;
+    }
+    for (int team = 1; team <= data.numTeams; team++) {
+        if (data.tankCount(team) == 0) {
+            string player = "Player " + to_string(team);
+            logError("Warning: No tanks found for " + player + ". " + player + " will lose immediately.");
+        }
     }
 }
 
-BoardData BoardReader::readBoard(const string& fileName) {
-    BoardData data;
-    // Initialize tank counts
-    data.player1TankCount = 0;
-    data.player2TankCount = 0;
-    
-    ifstream f(fileName);
-    if (!f.is_open()) {
-        logError("Error: Could not open file: " + fileName);
-        throw runtime_error("Could not open file: " + fileName);
+string BoardReader::cacheFileName(const string& fileName) {
+    return fileName + ".cache";
+}
+
+bool BoardReader::loadCache(const string& fileName, const string& source, BoardData& data) {
+    ifstream file(cacheFileName(fileName), ios::binary);
+    string bytes;
+    if (!file.is_open() || !readFile(file, bytes)) {
+        return false;
+    }
+    CacheHeader header;
+    if (bytes.size() < sizeof(header) + sizeof(uint64_t)) {
+        return false;
+    }
+    memcpy(&header, bytes.data(), sizeof(header));
+    if (memcmp(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) != 0 || header.version != CACHE_VERSION ||
+        header.rows == 0 || header.columns == 0 || header.rows > MAX_SIDE || header.columns > MAX_SIDE || header.numTeams < 2 || header.numTeams > MAX_TEAMS) {
+        return false;
+    }
+    uint32_t nameLength;
+    if (bytes.size() < sizeof(header) + sizeof(nameLength) + sizeof(uint64_t)) {
+        return false;
+    }
+    memcpy(&nameLength, bytes.data() + sizeof(header), sizeof(nameLength));
+    size_t nameStart = sizeof(header) + sizeof(nameLength);
+    if (nameLength > bytes.size() - nameStart - sizeof(uint64_t)) {
+        return false;
+    }
+    size_t tanksStart = nameStart + nameLength;
+    size_t cells = header.rows * header.columns;
+    size_t tanksSize = header.tankCount * sizeof(CacheTank);
+    size_t gridSize = (cells + 1) / 2;
+    if (cells / header.columns != header.rows || bytes.size() != tanksStart + tanksSize + gridSize + sizeof(uint64_t)) {
+        return false;
+    }
+    uint64_t checksum;
+    memcpy(&checksum, bytes.data() + bytes.size() - sizeof(checksum), sizeof(checksum));
+    if (checksum != hashBytes(bytes.data(), bytes.size() - sizeof(checksum))) {
+        return false;
+    }
+    // The board file must be the one the sidecar was written from
+    int64_t sourceTime;
+    if (!modificationTime(fileName, sourceTime) || header.sourceSize != source.size() || header.sourceTime != sourceTime ||
+        header.sourceHash != hashBytes(source.data(), source.size())) {
+        return false;
     }
 
+    data.mapName.assign(bytes.data() + nameStart, nameLength);
+    data.maxStep = header.maxStep;
+    data.numShells = header.numShells;
+    data.rows = header.rows;
+    data.columns = header.columns;
+    data.numTeams = header.numTeams;
+    data.board.assign(data.rows, vector<char>(data.columns));
+    const unsigned char* grid = reinterpret_cast<const unsigned char*>(bytes.data()) + tanksStart + tanksSize;
+    size_t tankCells = 0;
+    size_t cell = 0;
+    for (vector<char>& row : data.board) {
+        for (char& c : row) {
+            unsigned code = (grid[cell / 2] >> (cell % 2 * 4)) & 0xF;
+            if (code >= NUM_CELL_CODES) {
+                return false;
+            }
+            tankCells += code >= 3;
+            c = CELL_CODES[code];
+            cell++;
+        }
+    }
+    if (tankCells != header.tankCount) {
+        return false;
+    }
+    data.tanks.clear();
+    data.teamTankCounts.fill(0);
+    for (uint32_t i = 0; i < header.tankCount; i++) {
+        CacheTank tank;
+        memcpy(&tank, bytes.data() + tanksStart + i * sizeof(tank), sizeof(tank));
+        if (tank.x >= data.columns || tank.y >= data.rows || tank.team < 1 || tank.team > data.numTeams ||
+            data.board[tank.y][tank.x] != tankChar(tank.team)) {
+            return false;
+        }
+        data.tanks.push_back({tank.x, tank.y, tank.team, tank.tankIndex});
+        data.teamTankCounts[tank.team]++;
+    }
+    return true;
+}
+
+void BoardReader::storeCache(const string& fileName, const string& source, const BoardData& data) {
+    CacheHeader header{};
+    memcpy(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+    header.version = CACHE_VERSION;
+    header.sourceSize = source.size();
+    header.sourceHash = hashBytes(source.data(), source.size());
+    header.maxStep = data.maxStep;
+    header.numShells = data.numShells;
+    header.rows = data.rows;
+    header.columns = data.columns;
+    header.numTeams = data.numTeams;
+    header.tankCount = static_cast<uint32_t>(data.tanks.size());
+    if (data.rows == 0 || data.columns == 0 || !modificationTime(fileName, header.sourceTime)) {
+        return;  // Nothing a sidecar can be checked against
+    }
+
+    string bytes(reinterpret_cast<const char*>(&header), sizeof(header));
+    uint32_t nameLength = static_cast<uint32_t>(data.mapName.size());
+    bytes.append(reinterpret_cast<const char*>(&nameLength), sizeof(nameLength));
+    bytes.append(data.mapName);
+    for (const TankPosition& position : data.tanks) {
+        CacheTank tank{static_cast<uint32_t>(position.x), static_cast<uint32_t>(position.y), position.playerId, position.tankIndex};
+        bytes.append(reinterpret_cast<const char*>(&tank), sizeof(tank));
+    }
+    size_t gridStart = bytes.size();
+    bytes.resize(gridStart + (data.rows * data.columns + 1) / 2, '\0');
+    for (size_t y = 0; y < data.rows; y++) {
+        for (size_t x = 0; x < data.columns; x++) {
+            size_t cell = y * data.columns + x;
+            bytes[gridStart + cell / 2] |= static_cast<char>(cellCode(data.board[y][x]) << (cell % 2 * 4));
+        }
+    }
+    uint64_t checksum = hashBytes(bytes.data(), bytes.size());
+    bytes.append(reinterpret_cast<const char*>(&checksum), sizeof(checksum));
+
+    // Write aside and rename, so that games reading the same board never see half a sidecar
+    string cacheFile = cacheFileName(fileName);
+    // Unique to this thread of this process, as forked workers can share thread ids
+    string writer = to_string(hash<thread::id>()(this_thread::get_id()));
+#ifdef __unix__
+    writer = to_string(getpid()) + "." + writer;
+#endif
+    string tempFile = cacheFile + "." + writer + ".tmp";
+    {
+        ofstream out(tempFile, ios::binary | ios::trunc);
+        if (!out.write(bytes.data(), bytes.size())) {
+            logError("Warning: Could not write board cache " + tempFile);
+            return;
+        }
+    }
+    error_code error;
+    filesystem::rename(tempFile, cacheFile, error);
+    if (error) {
+        filesystem::remove(tempFile, error);
+        logError("Warning: Could not write board cache " + cacheFile);
+    }
+}
+
+void BoardReader::parseBoard(istream& f, const string& fileName, BoardData& data) {
     string firstLine;
     if (!getline(f, firstLine)) {
         logError("Error: File is empty: " + fileName);
         throw runtime_error("File is empty: " + fileName);
     }
-    // First line is map name/description - we ignore it as per guidelines
+    // First line is the map name/description; it is only shown to viewers
+    if (!firstLine.empty() && firstLine.back() == '\r') {
+        firstLine.pop_back();
+    }
+    data.mapName = firstLine;
     data.maxStep = extractVal(f, "MaxSteps");
     data.numShells = extractVal(f, "NumShells");
     data.rows = extractVal(f, "Rows");
     data.columns = extractVal(f, "Columns");
+    if (data.rows > MAX_SIDE || data.columns > MAX_SIDE) {
+        logError("Error: Board is " + to_string(data.rows) + "x" + to_string(data.columns) +
+                 ", sides must be at most " + to_string(MAX_SIDE));
+        throw runtime_error("Board sides must be at most " + to_string(MAX_SIDE) + ": " + fileName);
+    }
     buildBoard(f, data);
     validateTanks(data);
+}
+
+BoardData BoardReader::readBoard(const string& fileName, bool useCache) {
+    BoardData data;
+    // Initialize tank counts
+    data.numTeams = 2;
+    data.teamTankCounts.fill(0);
+    
+    ifstream f(fileName);
+    if (!f.is_open()) {
+        logError("Error: Could not open file: " + fileName);
+        throw runtime_error("Could not open file: " + fileName);
+    }
+    if (!useCache) {
+        parseBoard(f, fileName, data);
+        return data;
+    }
+
+    string source;
+    if (!readFile(f, source)) {
+        logError("Error: Could not read file: " + fileName);
+        throw runtime_error("Could not read file: " + fileName);
+    }
+    BoardData cached = data;
+    if (loadCache(fileName, source, cached)) {
+        cout << "Loaded board from " << cacheFileName(fileName) << endl;
+        return cached;
+    }
+    istringstream text(source);
+    parseBoard(text, fileName, data);
+    storeCache(fileName, source, data);
     return data;
-} 
\ No newline at end of file
+}
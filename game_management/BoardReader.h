@@ -1,10 +1,17 @@
 #pragma once
+#include <array>
 #include <string>
 #include <vector>
 #include <fstream>
 #include <stdexcept>
 #include "../constants/BoardConstants.h"
 
+struct TankPosition {
+    size_t x, y;
+    int playerId;
+    int tankIndex;  // Among the tanks of its player, in board order
+};
+
 struct BoardData {
     std::string mapName;
     size_t maxStep;
@@ -12,15 +19,19 @@ struct BoardData {
     size_t rows;
     size_t columns;
     std::vector<std::vector<char>> board;
-    size_t player1TankCount;
-    size_t player2TankCount;
+    int numTeams;  // Highest team digit on the board, at least 2
+    std::array<size_t, BoardConstants::MAX_TEAMS + 1> teamTankCounts;  // Indexed by team, entry 0 unused
+    std::vector<TankPosition> tanks;  // In board order, row by row
+
+    size_t tankCount(int team) const { return teamTankCounts[team]; }
 };
 
 class BoardReader {
 private:
     static void logError(const std::string& errorMessage);
-    static size_t extractVal(std::ifstream &f, const std::string& param);
-    static void buildBoard(std::ifstream &f, BoardData& data);
+    static size_t extractVal(std::istream &f, const std::string& param);
+    static void buildBoard(std::istream &f, BoardData& data);
+    static void parseBoard(std::istream &f, const std::string& fileName, BoardData& data);
     static void validateTanks(BoardData& data);
     
     // Helper functions for buildBoard
@@ -32,6 +43,14 @@ private:
     static std::string getValueAfterEquals(const std::string& line);
     static size_t parseValue(const std::string& value, const std::string& param, const std::string& line);
 
+    // Binary sidecar of a parsed board, next to the board file
+    static std::string cacheFileName(const std::string& fileName);
+    static bool loadCache(const std::string& fileName, const std::string& source, BoardData& data);
+    static void storeCache(const std::string& fileName, const std::string& source, const BoardData& data);
+
 public:
-    static BoardData readBoard(const std::string& fileName);
+    // With useCache, a board that was read before is loaded from its sidecar instead of
+    // parsed; the sidecar is written after parsing and replaced when the board changes.
+    // Warnings about the board are only logged when it is parsed.
+    static BoardData readBoard(const std::string& fileName, bool useCache = false);
 }; 
\ No newline at end of file
@@ -0,0 +1,138 @@
+#include "DecisionLatency.h"
+#include "MatchStats.h"
+#include <fstream>
+#include <stdexcept>
+
+size_t LatencyHistogram::bucketOf(uint64_t nanos) {
+    if (nanos < 16) {
+        return static_cast<size_t>(nanos);
+    }
+    int exponent = 63 - __builtin_clzll(nanos);  // At least 4
+    size_t sub = static_cast<size_t>(nanos >> (exponent - 3)) & (SUB_BUCKETS - 1);
+    return 16 + static_cast<size_t>(exponent - 4) * SUB_BUCKETS + sub;
+}
+
+uint64_t LatencyHistogram::bucketUpperBound(size_t bucket) {
+    if (bucket < 16) {
+        return bucket;
+    }
+    int exponent = static_cast<int>((bucket - 16) / SUB_BUCKETS) + 4;
+    uint64_t sub = (bucket - 16) % SUB_BUCKETS;
+    uint64_t width = 1ULL << (exponent - 3);
+    return (1ULL << exponent) + (sub + 1) * width - 1;
+}
+
+void LatencyHistogram::record(uint64_t nanos) {
+    counts[bucketOf(nanos)]++;
+    total++;
+    if (nanos > maximum) {
+        maximum = nanos;
+    }
+}
+
+void LatencyHistogram::merge(const LatencyHistogram& other) {
+    for (size_t i = 0; i < BUCKETS; i++) {
+        counts[i] += other.counts[i];
+    }
+    total += other.total;
+    if (other.maximum > maximum) {
+        maximum = other.maximum;
+    }
+}
+
+uint64_t LatencyHistogram::percentile(double fraction) const {
+    if (total == 0) {
+        return 0;
+    }
+    // Smallest value with at least fraction * total samples at or below it
+    uint64_t rank = static_cast<uint64_t>(fraction * static_cast<double>(total));
+    if (rank < 1) rank = 1;
+    if (rank > total) rank = total;
+    uint64_t seen = 0;
+    for (size_t i = 0; i < BUCKETS; i++) {
+        seen += counts[i];
+        if (seen >= rank) {
+            uint64_t bound = bucketUpperBound(i);
+            return bound < maximum ? bound : maximum;
+        }
+    }
+    return maximum;
+}
+
+void DecisionLatency::reset() {
+    tanks.clear();
+}
+
+void DecisionLatency::addTank(int player, const TankAlgorithm& algorithm) {
+    TankLatency tank;
+    tank.player = player;
+    tank.algorithm = algorithmName(algorithm);
+    tanks.push_back(std::move(tank));
+}
+
+void DecisionLatency::record(int tank, Call call, chrono::nanoseconds elapsed) {
+    if (tank < 0 || tank >= static_cast<int>(tanks.size())) {
+        return;
+    }
+    uint64_t nanos = elapsed.count() > 0 ? static_cast<uint64_t>(elapsed.count()) : 0;
+    if (call == Call::GetAction) {
+        tanks[tank].getAction.record(nanos);
+    } else {
+        tanks[tank].battleInfo.record(nanos);
+    }
+}
+
+void DecisionLatency::recordSlowCall(int tank) {
+    if (tank >= 0 && tank < static_cast<int>(tanks.size())) {
+        tanks[tank].slowCalls++;
+    }
+}
+
+map<string, DecisionLatency::TankLatency> DecisionLatency::byAlgorithm() const {
+    map<string, TankLatency> sums;
+    for (const TankLatency& t : tanks) {
+        TankLatency& sum = sums[t.algorithm];
+        sum.algorithm = t.algorithm;
+        sum.getAction.merge(t.getAction);
+        sum.battleInfo.merge(t.battleInfo);
+        sum.slowCalls += t.slowCalls;
+    }
+    return sums;
+}
+
+namespace {
+    // count,p50,p99,max with the durations in microseconds
+    void writeHistogram(ofstream& file, const LatencyHistogram& histogram) {
+        auto micros = [](uint64_t nanos) { return to_string(nanos / 1000) + "." + to_string(nanos % 1000 / 100); };
+        file << histogram.count() << ',' << micros(histogram.percentile(0.5)) << ','
+             << micros(histogram.percentile(0.99)) << ',' << micros(histogram.max());
+    }
+}
+
+void DecisionLatency::write(const string& fileName) const {
+    ofstream file(fileName);
+    if (!file.is_open()) {
+        throw runtime_error("Could not open latency file: " + fileName);
+    }
+    const char* columns = "get_action_calls,get_action_p50_us,get_action_p99_us,get_action_max_us,"
+                          "battle_info_calls,battle_info_p50_us,battle_info_p99_us,battle_info_max_us,slow_calls\n";
+
+    file << "tank,player,algorithm," << columns;
+    for (size_t i = 0; i < tanks.size(); i++) {
+        const TankLatency& t = tanks[i];
+        file << i << ',' << t.player << ',' << t.algorithm << ',';
+        writeHistogram(file, t.getAction);
+        file << ',';
+        writeHistogram(file, t.battleInfo);
+        file << ',' << t.slowCalls << '\n';
+    }
+
+    file << "\nalgorithm," << columns;
+    for (const auto& [name, t] : byAlgorithm()) {
+        file << name << ',';
+        writeHistogram(file, t.getAction);
+        file << ',';
+        writeHistogram(file, t.battleInfo);
+        file << ',' << t.slowCalls << '\n';
+    }
+}
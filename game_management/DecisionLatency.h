@@ -0,0 +1,64 @@
+#pragma once
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+#include "../common/TankAlgorithm.h"
+
+using namespace std;
+
+// Log-linear histogram of durations in nanoseconds: exact below 16ns, then eight
+// buckets per power of two, so any percentile is within 12.5% of the true value.
+class LatencyHistogram {
+private:
+    static constexpr int SUB_BUCKETS = 8;
+    static constexpr size_t BUCKETS = 16 + (64 - 4) * SUB_BUCKETS;
+
+    array<uint64_t, BUCKETS> counts{};
+    uint64_t total = 0;
+    uint64_t maximum = 0;
+
+    static size_t bucketOf(uint64_t nanos);
+    static uint64_t bucketUpperBound(size_t bucket);
+
+public:
+    void record(uint64_t nanos);
+    void merge(const LatencyHistogram& other);
+
+    uint64_t count() const { return total; }
+    uint64_t max() const { return maximum; }
+    uint64_t percentile(double fraction) const;  // Upper bound of the bucket holding that rank, at most max()
+};
+
+// Wall-clock time spent in the algorithms' getAction() and updateBattleInfo(),
+// kept per tank and summed per algorithm class, plus the decisions slower than the
+// reporting limit.
+class DecisionLatency {
+public:
+    enum class Call { GetAction, UpdateBattleInfo };
+
+    struct TankLatency {
+        int player = 0;
+        string algorithm;
+        LatencyHistogram getAction;
+        LatencyHistogram battleInfo;
+        int slowCalls = 0;  // Calls that took longer than the limit
+    };
+
+    void reset();
+    void addTank(int player, const TankAlgorithm& algorithm);  // Register tanks in creation order
+    void record(int tank, Call call, chrono::nanoseconds elapsed);
+    void recordSlowCall(int tank);
+
+    const vector<TankLatency>& getTanks() const { return tanks; }
+    // Histograms of all tanks with the same algorithm class merged
+    map<string, TankLatency> byAlgorithm() const;
+
+    void write(const string& fileName) const;
+
+private:
+    vector<TankLatency> tanks;  // Indexed by creation order
+};
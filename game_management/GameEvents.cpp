@@ -0,0 +1,6 @@
+#include "GameEvents.h"
+#include <algorithm>
+
+void GameEventBus::unsubscribe(GameEventListener* listener) {
+    listeners.erase(remove(listeners.begin(), listeners.end(), listener), listeners.end());
+}
@@ -0,0 +1,47 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+
+using namespace std;
+
+// Something that happened while a round was resolved
+struct GameEvent {
+    enum class Type {
+        ShellFired, TankKilled, WallDamaged, WallDestroyed, MineTriggered, ShellsCollided,
+        TanksCollided,   // A tank drove onto another tank
+        TanksSwapped,    // Two tanks swapped cells, both are killed right after
+        ActionTaken,     // A living tank played its action, count holds the ActionRequest
+        ActionIgnored    // The action was not legal and had no effect
+    };
+
+    Type type;
+    int round;
+    size_t x, y;      // Cell the event happened on
+    int tank = -1;    // Creation order of the tank involved, -1 if none
+    int player = 0;   // Player of that tank, 0 if none
+    int count = 0;    // Shells left on a killed tank, or shells that collided
+    int otherTank = -1;  // Tank whose shell hit the target, or the other tank of a swap
+};
+
+class GameEventListener {
+public:
+    virtual ~GameEventListener() {}
+    virtual void onGameEvent(const GameEvent& event) = 0;
+};
+
+// Hands every event to the subscribed listeners, in subscription order, as it is
+// published. Listeners are not owned and must outlive the bus or unsubscribe.
+class GameEventBus {
+private:
+    vector<GameEventListener*> listeners;
+
+public:
+    void subscribe(GameEventListener* listener) { listeners.push_back(listener); }
+    void unsubscribe(GameEventListener* listener);
+
+    void publish(const GameEvent& event) const {
+        for (GameEventListener* listener : listeners) {
+            listener->onGameEvent(event);
+        }
+    }
+};
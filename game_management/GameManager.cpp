@@ -8,44 +8,89 @@ using namespace BoardConstants;
 
 
 GameManager::GameManager(PlayerFactory &player_factory, TankAlgorithmFactory &algorithmFactory)
-    : playerFactory(player_factory), algorithmFactory(algorithmFactory), creationOrderCounter(0),
-      allTanksOutOfShells(false), roundsSinceNoShells(0)
+    : roundArena(roundBuffer.data(), roundBuffer.size()),
+      playerFactory(player_factory), algorithmFactory(algorithmFactory), creationOrderCounter(0), boardCache(false),
+      tankTable(&matchArena), activeShells(&matchArena),
+      currentRound(0), seenStates(&matchArena), roundHashes(&matchArena), cycleFastForward(false), cycleReported(false), algorithmStateKnown(false), statsEnabled(false),
+      latencyEnabled(false), slowDecisionLimit(0), replaceSlowActions(false), liveExport(nullptr), liveStream(nullptr), terminalView(nullptr), allTanksOutOfShells(false), roundsSinceNoShells(0)
 {
+    events.subscribe(&teamTally);
 }
 
 void GameManager::readBoard(string fileName) {
     inputFileName = fileName;  // Store the input filename
-    gameData = BoardReader::readBoard(fileName);
+    gameData = BoardReader::readBoard(fileName, boardCache);
     std::cout << "Game data: " << gameData.rows << " " << gameData.columns << std::endl;
 }
 
 void GameManager::setOutputFile() {
     // Create output filename based on input filename
     string outputFileName = "output_" + inputFileName;
-    outputWriter = make_unique<OutputWriter>(outputFileName);
+    outputWriter = make_unique<OutputWriter>(outputFileName, gameData.numTeams);
 }
 
 bool GameManager::checkAllTanksOutOfShells() {
-    // Check player 1 tanks
-    for (const auto& tank : player1Tanks) {
-        std::cout << "Tank " << tank.getCreationOrder() << " has " << tank.getNumShells() << " shells" << " and is alive: " << tank.getIsAlive() << std::endl;
-        if (tank.getIsAlive() && tank.getNumShells() > 0) {
-            return false;
-        }
+    return teamTally.allOutOfShells();
+}
+
+void GameManager::publish(GameEvent::Type type, size_t x, size_t y, int tank, int player, int count, int otherTank) {
+    events.publish(GameEvent{type, currentRound, x, y, tank, player, count, otherTank});
+}
+
+void GameManager::setStatsOutput(bool enabled) {
+    if (enabled == statsEnabled) {
+        return;
     }
-    // Check player 2 tanks
-    for (const auto& tank : player2Tanks) {
-        if (tank.getIsAlive() && tank.getNumShells() > 0) {
-            return false;
-        }
+    statsEnabled = enabled;
+    if (enabled) {
+        events.subscribe(&matchStats);
+    } else {
+        events.unsubscribe(&matchStats);
     }
+}
+
+void GameManager::writeStats() {
+    if (!statsEnabled) {
+        return;
+    }
+    string statsFileName = "stats_" + inputFileName;
+    std::cout << "Writing match statistics to " << statsFileName << std::endl;
+    matchStats.write(statsFileName);
+}
+
+void GameManager::setSlowDecisionReport(chrono::nanoseconds limit, bool replaceSlow) {
+    slowDecisionLimit = limit;
+    replaceSlowActions = replaceSlow;
+}
+
+bool GameManager::recordDecision(const TankInfo& tank, DecisionLatency::Call call, chrono::nanoseconds elapsed) {
+    decisionLatency.record(tank.getCreationOrder(), call, elapsed);
+    if (slowDecisionLimit.count() <= 0 || elapsed <= slowDecisionLimit) {
+        return false;
+    }
+    decisionLatency.recordSlowCall(tank.getCreationOrder());
+    std::cerr << "Tank " << tank.getCreationOrder() << " (Player " << tank.getPlayerId() << ") took "
+              << chrono::duration_cast<chrono::microseconds>(elapsed).count() << "us in "
+              << (call == DecisionLatency::Call::GetAction ? "getAction" : "updateBattleInfo")
+              << " in round " << currentRound << ", limit is "
+              << chrono::duration_cast<chrono::microseconds>(slowDecisionLimit).count() << "us" << std::endl;
     return true;
 }
 
+void GameManager::writeLatency() {
+    if (!latencyEnabled) {
+        return;
+    }
+    string latencyFileName = "latency_" + inputFileName;
+    std::cout << "Writing decision latency to " << latencyFileName << std::endl;
+    decisionLatency.write(latencyFileName);
+}
+
 bool GameManager::checkImmediateGameEnd() {
     std::cout << "Checking immediate game end conditions:" << std::endl;
-    std::cout << "Player 1 tanks: " << gameData.player1TankCount << std::endl;
-    std::cout << "Player 2 tanks: " << gameData.player2TankCount << std::endl;
+    for (int team = 1; team <= gameData.numTeams; team++) {
+        std::cout << "Player " << team << " tanks: " << teamTally.aliveCount(team) << std::endl;
+    }
     
     // Check if all tanks are out of shells
     if (!allTanksOutOfShells && checkAllTanksOutOfShells()) {
@@ -63,21 +108,23 @@ bool GameManager::checkImmediateGameEnd() {
         if (roundsSinceNoShells >= OutputWriter::ZERO_SHELLS_STEPS) {
             std::cout << "Game end: 40 rounds have passed since all tanks ran out of shells" << std::endl;
             outputWriter->writeZeroShellsTie();
+            setResult(GameResult::Reason::ZeroShells, 0);
             return true;
         }
     }
     
-    if (gameData.player1TankCount == 0 && gameData.player2TankCount == 0) {
-        std::cout << "Game end: Both players have no tanks remaining - Tie" << std::endl;
+    int teamsAlive = teamTally.teamsWithTanks();
+    if (teamsAlive == 0) {
+        std::cout << "Game end: No player has tanks remaining - Tie" << std::endl;
         outputWriter->writeGameEnd(0, 0); // Tie
+        setResult(GameResult::Reason::AllTanksDead, 0);
         return true;
-    } else if (gameData.player1TankCount == 0) {
-        std::cout << "Game end: Player 1 has no tanks remaining - Player 2 wins" << std::endl;
-        outputWriter->writeGameEnd(2, gameData.player2TankCount);
-        return true;
-    } else if (gameData.player2TankCount == 0) {
-        std::cout << "Game end: Player 2 has no tanks remaining - Player 1 wins" << std::endl;
-        outputWriter->writeGameEnd(1, gameData.player1TankCount);
+    } else if (teamsAlive == 1) {
+        int lastTeamAlive = teamTally.lastTeamWithTanks();
+        std::cout << "Game end: Only Player " << lastTeamAlive << " has tanks remaining - Player "
+                  << lastTeamAlive << " wins" << std::endl;
+        outputWriter->writeGameEnd(lastTeamAlive, teamTally.aliveCount(lastTeamAlive));
+        setResult(GameResult::Reason::AllTanksDead, lastTeamAlive);
         return true;
     }
     
@@ -85,77 +132,74 @@ bool GameManager::checkImmediateGameEnd() {
     return false;
 }
 
-vector<TankPosition> GameManager::collectTankPositions() {
-    vector<TankPosition> tankPositions;
-    
-    // Collect player 1 tank positions
-    int tankIndex1 = 0;
-    for (size_t y = 0; y < gameData.rows; y++) {
-        for (size_t x = 0; x < gameData.columns; x++) {
-            if (gameData.board[y][x] == PLAYER1_TANK) {
-                tankPositions.push_back({x, y, 1, tankIndex1++});
-            }
-        }
-    }
-    
-    // Collect player 2 tank positions
-    int tankIndex2 = 0;
-    for (size_t y = 0; y < gameData.rows; y++) {
-        for (size_t x = 0; x < gameData.columns; x++) {
-            if (gameData.board[y][x] == PLAYER2_TANK) {
-                tankPositions.push_back({x, y, 2, tankIndex2++});
-            }
-        }
+void GameManager::setResult(GameResult::Reason reason, int winner) {
+    result.reason = reason;
+    result.winner = winner;
+    result.rounds = static_cast<size_t>(currentRound);
+    result.numTeams = gameData.numTeams;
+    for (int team = 1; team <= gameData.numTeams; team++) {
+        result.teamTanks[team] = static_cast<size_t>(teamTally.aliveCount(team));
     }
-    
-    return tankPositions;
-}
-
-void GameManager::sortTankPositions(vector<TankPosition>& positions) {
-    sort(positions.begin(), positions.end(), 
-        [](const TankPosition& a, const TankPosition& b) {
-            if (a.y != b.y) return a.y < b.y;
-            return a.x < b.x;
-        });
 }
 
 void GameManager::createTanksFromPositions(const vector<TankPosition>& positions) {
     for (const auto& pos : positions) {
-        int dx = (pos.playerId == 1) ? -1 : 1;  // Player 1 faces left (-1,0), Player 2 faces right (1,0)
-        int dy = 0;  // Both players start with horizontal direction
+        int dx = startingDx(pos.playerId);  // Player 1 faces left (-1,0), Player 2 faces right (1,0)
+        int dy = 0;  // All players start with horizontal direction
         
-        auto algorithm = algorithmFactory.create(pos.playerId, pos.tankIndex);
-        if (pos.playerId == 1) {
-            player1Tanks.emplace_back(pos.x, pos.y, dx, dy, std::move(algorithm), 
-                                    gameData.columns, gameData.rows, pos.playerId, creationOrderCounter++, gameData.numShells);
-        } else {
-            player2Tanks.emplace_back(pos.x, pos.y, dx, dy, std::move(algorithm), 
-                                    gameData.columns, gameData.rows, pos.playerId, creationOrderCounter++, gameData.numShells);
+        auto algorithm = algorithmFactory.createInArena(pos.playerId, pos.tankIndex, &matchArena);
+        if (statsEnabled) {
+            matchStats.addTank(pos.playerId, *algorithm);
+        }
+        if (timingDecisions()) {
+            decisionLatency.addTank(pos.playerId, *algorithm);
         }
+        size_t index = tankTable.add(pos.x, pos.y, dx, dy, std::move(algorithm), pos.playerId, gameData.numShells);
+        creationOrderCounter++;
+        std::cout << "Tank " << index << " has " << gameData.numShells << " shells" << std::endl;
     }
 }
 
+void GameManager::releaseMatchArena() {
+    // Containers give their memory back before the arena is released under them
+    tankTable.clear();
+    activeShells = pmr::vector<Shell>(&matchArena);
+    seenStates = pmr::unordered_map<uint64_t, pmr::vector<size_t>>(&matchArena);
+    roundHashes = pmr::vector<uint64_t>(&matchArena);
+    matchArena.release();
+}
+
 void GameManager::initializePlayersAndTanks() {
-    // Clear any existing tanks
-    player1Tanks.clear();
-    player2Tanks.clear();
+    // Clear any existing tanks, along with everything else of a previous match
+    releaseMatchArena();
     
     // Create players with board dimensions
-    playerOne = playerFactory.create(1, gameData.columns, gameData.rows, gameData.maxStep, gameData.numShells);
-    playerTwo = playerFactory.create(2, gameData.columns, gameData.rows, gameData.maxStep, gameData.numShells);
+    players.clear();
+    for (int team = 1; team <= gameData.numTeams; team++) {
+        players.push_back(playerFactory.create(team, gameData.columns, gameData.rows, gameData.maxStep, gameData.numShells));
+    }
     
     // Reset creation order counter
     creationOrderCounter = 0;
+    matchStats.reset();
+    decisionLatency.reset();
+    tankTable.setBoardSize(gameData.columns, gameData.rows);
     
-    // Collect and sort tank positions
-    auto tankPositions = collectTankPositions();
-    sortTankPositions(tankPositions);
-    
-    // Create tanks in sorted order
-    createTanksFromPositions(tankPositions);
+    // Create tanks in board order, as the board lists them
+    createTanksFromPositions(gameData.tanks);
+    teamTally.reset(gameData);
+
+    // No shells in flight yet
+    shellDangerMap.reset(gameData.rows, gameData.columns);
+    reachability.reset(gameData.board);
+
+    // Hash the initial state
+    stateHash.reset(gameData.board, tankTable, activeShells);
+    cycleReported = false;
+    algorithmStateKnown = cycleFastForward;
 }
 
-void GameManager::detectShellCrossings(vector<bool>& shellsToRemove, map<pair<size_t, size_t>, vector<size_t>>& nextPositions) {
+void GameManager::detectShellCrossings(pmr::vector<bool>& shellsToRemove, PositionShellsMap& nextPositions) {
     // First pass: collect all potential moves and detect crossings
     for (size_t i = 0; i < activeShells.size(); i++) {
         auto nextPos = activeShells[i].getPotentialMove();
@@ -177,6 +221,7 @@ void GameManager::detectShellCrossings(vector<bool>& shellsToRemove, map<pair<si
                     // Shells are crossing - mark both for removal
                     shellsToRemove[i] = true;
                     shellsToRemove[otherShell] = true;
+                    publish(GameEvent::Type::ShellsCollided, currentPos.first, currentPos.second, -1, 0, 2);
                     break;
                 }
             }
@@ -189,84 +234,88 @@ void GameManager::detectShellCrossings(vector<bool>& shellsToRemove, map<pair<si
     }
 }
 
-void GameManager::removeMarkedShells(const vector<bool>& shellsToRemove) {
+void GameManager::removeMarkedShells(const pmr::vector<bool>& shellsToRemove) {
     // Remove shells that are crossing
     for (int i = activeShells.size() - 1; i >= 0; i--) {
         if (shellsToRemove[i]) {
+            shellDangerMap.markShellPath(activeShells[i], gameData.board);
             activeShells.erase(activeShells.begin() + i);
         }
     }
 }
 
-void GameManager::findAndKillTank(size_t x, size_t y) {
-    // Check player 1 tanks
-    for (auto& tank : player1Tanks) {
-        if (tank.getX() == x && tank.getY() == y && tank.getIsAlive()) {
-            tank.killTank();
-            gameData.player1TankCount--;
-            return;
-        }
-    }
-    // Check player 2 tanks
-    for (auto& tank : player2Tanks) {
+void GameManager::findAndKillTank(size_t x, size_t y, int shooter) {
+    // The first living tank on the cell in team order is hit
+    for (size_t index : tankTable.teamOrder()) {
+        TankInfo tank(tankTable, index);
         if (tank.getX() == x && tank.getY() == y && tank.getIsAlive()) {
+            stateHash.toggleTank(tank);
             tank.killTank();
-            gameData.player2TankCount--;
+            stateHash.toggleTank(tank);
+            publish(GameEvent::Type::TankKilled, x, y, tank.getCreationOrder(), tank.getPlayerId(), tank.getNumShells(), shooter);
             return;
         }
     }
 }
 
-void GameManager::handleTankCollision(const pair<size_t, size_t>& pos) {
+void GameManager::handleTankCollision(const pair<size_t, size_t>& pos, int shooter) {
     // Kill the tank
-    findAndKillTank(pos.first, pos.second);
+    findAndKillTank(pos.first, pos.second, shooter);
     
     // Mark position as empty
-    gameData.board[pos.second][pos.first] = EMPTY_SPACE;
+    setCell(pos.first, pos.second, EMPTY_SPACE);
 }
 
-void GameManager::handleWallCollision(const pair<size_t, size_t>& pos) {
+void GameManager::handleWallCollision(const pair<size_t, size_t>& pos, int shooter) {
     // we their is only one shell, so we can just destroy the wall
-    gameData.board[pos.second][pos.first] = DAMAGED_WALL;
+    setCell(pos.first, pos.second, DAMAGED_WALL);
+    publish(GameEvent::Type::WallDamaged, pos.first, pos.second, -1, 0, 1, shooter);
 }
 
-void GameManager::handleDamagedWallCollision(const pair<size_t, size_t>& pos) {
+void GameManager::handleDamagedWallCollision(const pair<size_t, size_t>& pos, int shooter) {
     // Any number of shells destroys a damaged wall
-    gameData.board[pos.second][pos.first] = EMPTY_SPACE;
+    setCell(pos.first, pos.second, EMPTY_SPACE);
+    publish(GameEvent::Type::WallDestroyed, pos.first, pos.second, -1, 0, 1, shooter);
+    // Shells that were heading into this wall now fly further
+    shellDangerMap.markAll();
 }
 
 void GameManager::handleMineCollision(const pair<size_t, size_t>& pos) {
-    gameData.board[pos.second][pos.first] = MINE_SHELL_COLLISION;
+    setCell(pos.first, pos.second, MINE_SHELL_COLLISION);
 }
 
 void GameManager::handleMultipleShellCollision(const pair<size_t, size_t>& pos) {
     // Check what's at this position and handle accordingly
     char currentCell = gameData.board[pos.second][pos.first];
     switch (currentCell) {
-        case PLAYER1_TANK:
-        case PLAYER2_TANK:
+        case '1': case '2': case '3': case '4': case '5': case '6': case '7': case '8': case '9':
             // Kill the tank
             findAndKillTank(pos.first, pos.second);
             break;
         case WALL:
         case DAMAGED_WALL:
             // Walls are destroyed by multiple shells
+            shellDangerMap.markAll();
+            publish(GameEvent::Type::WallDestroyed, pos.first, pos.second);
             break;
         case MINE:
             // Mine is destroyed by multiple shells
+            publish(GameEvent::Type::MineTriggered, pos.first, pos.second);
             break;
         // For other cases (empty, shell, collision states) we just clear the position
     }
     
     // Multiple shells destroy everything
-    gameData.board[pos.second][pos.first] = EMPTY_SPACE;
+    setCell(pos.first, pos.second, EMPTY_SPACE);
 }
 
-std::vector<std::pair<size_t, size_t>> GameManager::handleShellPositions(const map<pair<size_t, size_t>, vector<size_t>>& nextPositions) {
-    std::vector<std::pair<size_t, size_t>> collisionPositions;
+pmr::vector<pair<size_t, size_t>> GameManager::handleShellPositions(const PositionShellsMap& nextPositions,
+                                                                    const pmr::vector<int>& shellOwners) {
+    pmr::vector<pair<size_t, size_t>> collisionPositions(&roundArena);
     for (const auto& [pos, shellIndices] : nextPositions) {
         if (shellIndices.size() > 1) {
             // Multiple shells in same position - destroy everything
+            publish(GameEvent::Type::ShellsCollided, pos.first, pos.second, -1, 0, static_cast<int>(shellIndices.size()));
             handleMultipleShellCollision(pos);
             collisionPositions.push_back(pos);
             continue;
@@ -274,25 +323,27 @@ std::vector<std::pair<size_t, size_t>> GameManager::handleShellPositions(const m
 
         // Single shell - check what's in the target position
         char nextCell = gameData.board[pos.second][pos.first];
-        switch (nextCell) {
-            case PLAYER1_TANK:
-            case PLAYER2_TANK:
-                handleTankCollision(pos);
+        int shooter = shellOwners[shellIndices.front()];
+        switch (GameRules::singleShellHit(nextCell)) {
+            case GameRules::ShellHit::Tank:
+                handleTankCollision(pos, shooter);
                 collisionPositions.push_back(pos);
                 break;
-            case WALL:
-                handleWallCollision(pos);
+            case GameRules::ShellHit::Wall:
+                handleWallCollision(pos, shooter);
                 collisionPositions.push_back(pos);
                 break;
-            case DAMAGED_WALL:
-                handleDamagedWallCollision(pos);
+            case GameRules::ShellHit::DamagedWall:
+                handleDamagedWallCollision(pos, shooter);
                 collisionPositions.push_back(pos);
                 break;
-            case MINE:
+            case GameRules::ShellHit::Mine:
                 handleMineCollision(pos);
                 break;
-            case EMPTY_SPACE:
-                gameData.board[pos.second][pos.first] = SHELL;
+            case GameRules::ShellHit::Empty:
+                setCell(pos.first, pos.second, SHELL);
+                break;
+            case GameRules::ShellHit::PassThrough:
                 break;
         }
     }
@@ -300,19 +351,29 @@ std::vector<std::pair<size_t, size_t>> GameManager::handleShellPositions(const m
 }
 
 void GameManager::moveShells() {
-    vector<bool> shellsToRemove(activeShells.size(), false);
-    map<pair<size_t, size_t>, vector<size_t>> nextPositions;  // Map of position to shell indices
+    // Take all shells out of the state hash, the survivors are added back once moved
+    for (const auto& shell : activeShells) {
+        stateHash.toggleShell(shell);
+    }
+
+    pmr::vector<bool> shellsToRemove(activeShells.size(), false, &roundArena);
+    PositionShellsMap nextPositions(&roundArena);  // Map of position to shell indices
     
     // Detect crossings and collect next positions
     detectShellCrossings(shellsToRemove, nextPositions);
+
+    // Owners by the indices in nextPositions, which removing crossing shells shifts
+    pmr::vector<int> shellOwners(&roundArena);
+    for (const auto& shell : activeShells) {
+        shellOwners.push_back(shell.getOwner());
+    }
     
     // First clear all current shell positions, but only if there isn't a tank there
     for (const auto& shell : activeShells) {
         char currentCell = gameData.board[shell.getY()][shell.getX()];
-        if (currentCell == SHELL) {  // Only clear if it's a shell (not a tank)
-            gameData.board[shell.getY()][shell.getX()] = EMPTY_SPACE;
-        } else if (currentCell == MINE_SHELL_COLLISION) {  // If it was a mine-shell collision, change back to mine
-            gameData.board[shell.getY()][shell.getX()] = MINE;
+        char leftCell = GameRules::cellLeftByShell(currentCell);  // Shells clear, mines come back, tanks stay
+        if (leftCell != currentCell) {
+            setCell(shell.getX(), shell.getY(), leftCell);
         }
     }
     
@@ -320,13 +381,14 @@ void GameManager::moveShells() {
     removeMarkedShells(shellsToRemove);
     
     // Handle shell positions and collisions
-    auto collisionPositions = handleShellPositions(nextPositions);
+    auto collisionPositions = handleShellPositions(nextPositions, shellOwners);
 
     // Remove shells whose next position is in collisionPositions
-    std::set<std::pair<size_t, size_t>> collisionSet(collisionPositions.begin(), collisionPositions.end());
+    pmr::set<pair<size_t, size_t>> collisionSet(collisionPositions.begin(), collisionPositions.end(), &roundArena);
     for (int i = static_cast<int>(activeShells.size()) - 1; i >= 0; --i) {
         auto nextPos = activeShells[i].getPotentialMove();
         if (collisionSet.count(nextPos)) {
+            shellDangerMap.markShellPath(activeShells[i], gameData.board);
             activeShells.erase(activeShells.begin() + i);
         }
     }
@@ -334,6 +396,8 @@ void GameManager::moveShells() {
     // Move remaining shells
     for (auto& shell : activeShells) {
         shell.move();
+        shellDangerMap.markCell(shell.getX(), shell.getY());  // The predicted arrival here has now happened
+        stateHash.toggleShell(shell);
     }
 }
 
@@ -348,22 +412,27 @@ void GameManager::checkCollisions() {
 }
 
 void GameManager::updateTanks() {
-    std::cout << "\nUpdating Player 1 tanks..." << std::endl;
-    // Process player 1 tanks
-    updateTankVector(player1Tanks);
-    
-    std::cout << "Updating Player 2 tanks..." << std::endl;
-    // Process player 2 tanks
-    updateTankVector(player2Tanks);
+    // Teams act in order, each team's tanks in creation order
+    for (int team = 1; team <= gameData.numTeams; team++) {
+        std::cout << (team == 1 ? "\n" : "") << "Updating Player " << team << " tanks..." << std::endl;
+        updateTeam(team);
+    }
     
     std::cout << "Checking for tank swapping..." << std::endl;
     // Check for tank swapping after all moves are made
     checkTankSwapping();
 }
 
-void GameManager::updateTankVector(vector<TankInfo>& tanks) {
-    for (size_t i = 0; i < tanks.size(); i++) {
-        auto& tank = tanks[i];
+ActionRequest GameManager::decide(TankInfo& tank) {
+    AllocationStats::PhaseScope phase(AllocationStats::Phase::Decisions);
+    AllocationStats::AlgorithmScope algorithm(*tank.getAlgorithm());
+    return tank.getAlgorithm()->getAction();
+}
+
+void GameManager::updateTeam(int team) {
+    size_t first = tankTable.teamBegin(team);
+    for (size_t i = 0; first + i < tankTable.teamEnd(team); i++) {
+        TankInfo tank(tankTable, tankTable.teamOrder()[first + i]);
         
         if (!tank.getIsAlive() && !tank.getRoundWasKilled()) {
             std::cout << "Tank " << i << " (Player " << tank.getPlayerId() << ") is dead, skipping..." << std::endl;
@@ -374,7 +443,18 @@ void GameManager::updateTankVector(vector<TankInfo>& tanks) {
                   << tank.getX() << "," << tank.getY() << ")" << std::endl;
         
         // Get action from tank's algorithm
-        auto action = tank.getAlgorithm()->getAction();
+        ActionRequest action;
+        if (timingDecisions()) {
+            auto start = chrono::steady_clock::now();
+            action = decide(tank);
+            bool slow = recordDecision(tank, DecisionLatency::Call::GetAction, chrono::steady_clock::now() - start);
+            if (slow && replaceSlowActions) {
+                std::cout << "Tank " << i << " decided too slowly, playing DoNothing" << std::endl;
+                action = ActionRequest::DoNothing;
+            }
+        } else {
+            action = decide(tank);
+        }
         std::cout << "Tank " << i << " chose action: " << static_cast<int>(action) << std::endl;
         
         // Store the action in tank's round info
@@ -383,6 +463,14 @@ void GameManager::updateTankVector(vector<TankInfo>& tanks) {
         
         // Process the action
         processTankAction(tank, action);
+        if (tank.getRoundIsAlive()) {
+            publish(GameEvent::Type::ActionTaken, tank.getX(), tank.getY(), tank.getCreationOrder(), tank.getPlayerId(),
+                    static_cast<int>(action));
+            if (tank.getRoundWasActionIgnored()) {
+                publish(GameEvent::Type::ActionIgnored, tank.getX(), tank.getY(), tank.getCreationOrder(), tank.getPlayerId(),
+                        static_cast<int>(action));
+            }
+        }
         
         if (tank.getRoundWasActionIgnored()) {
             std::cout << "Tank " << i << "'s action was ignored" << std::endl;
@@ -393,59 +481,6 @@ void GameManager::updateTankVector(vector<TankInfo>& tanks) {
     }
 }
 
-map<pair<size_t, size_t>, TankInfo*> GameManager::createTankPositionMap() {
-    map<pair<size_t, size_t>, TankInfo*> currentPositions;
-    
-    // Add all alive tanks to the map
-    for (auto& tank : player1Tanks) {
-        if (tank.getIsAlive()) {
-            currentPositions[{tank.getX(), tank.getY()}] = &tank;
-        }
-    }
-    for (auto& tank : player2Tanks) {
-        if (tank.getIsAlive()) {
-            currentPositions[{tank.getX(), tank.getY()}] = &tank;
-        }
-    }
-    
-    return currentPositions;
-}
-
-bool GameManager::tanksSwappedPlaces(TankInfo* tank1, TankInfo* tank2) {
-    if (!tank1 || !tank2) {
-        std::cout << "Invalid tank pointer in swap check" << std::endl;
-        return false;
-    }
-    if (!tank1->getIsAlive() || !tank2->getIsAlive()) {
-        std::cout << "One or both tanks are dead in swap check" << std::endl;
-        return false;
-    }
-    
-    // Get the tanks' previous positions
-    auto prevPos1 = tank1->getPreviousPosition();
-    auto prevPos2 = tank2->getPreviousPosition();
-    
-    if (!prevPos1 || !prevPos2) {
-        std::cout << "One or both tanks have no previous position" << std::endl;
-        return false;
-    }
-    
-    // Check if tanks swapped places
-    bool swapped = (prevPos1->first == tank2->getX() && prevPos1->second == tank2->getY() &&
-                   prevPos2->first == tank1->getX() && prevPos2->second == tank1->getY());
-    
-    if (swapped) {
-        std::cout << "Confirmed swap: Tank " << tank1->getCreationOrder() << " moved from ("
-                  << prevPos1->first << "," << prevPos1->second << ") to (" 
-                  << tank1->getX() << "," << tank1->getY() << ")" << std::endl;
-        std::cout << "              Tank " << tank2->getCreationOrder() << " moved from ("
-                  << prevPos2->first << "," << prevPos2->second << ") to (" 
-                  << tank2->getX() << "," << tank2->getY() << ")" << std::endl;
-    }
-    
-    return swapped;
-}
-
 void GameManager::handleTankSwap(TankInfo* tank1, TankInfo* tank2) {
     std::cout << "\nHandling tank swap collision:" << std::endl;
     std::cout << "Tank " << tank1->getCreationOrder() << " (Player " << tank1->getPlayerId() 
@@ -453,70 +488,39 @@ void GameManager::handleTankSwap(TankInfo* tank1, TankInfo* tank2) {
     std::cout << "Tank " << tank2->getCreationOrder() << " (Player " << tank2->getPlayerId() 
               << ") at (" << tank2->getX() << "," << tank2->getY() << ")" << std::endl;
     
+    publish(GameEvent::Type::TanksSwapped, tank1->getX(), tank1->getY(), tank1->getCreationOrder(), tank1->getPlayerId(),
+            0, tank2->getCreationOrder());
+
     // Kill both tanks
+    stateHash.toggleTank(*tank1);
+    stateHash.toggleTank(*tank2);
     tank1->killTank();
     tank1->setRoundWasKilled(true);
-    gameData.board[tank1->getY()][tank1->getX()] = EMPTY_SPACE;
+    setCell(tank1->getX(), tank1->getY(), EMPTY_SPACE);
     
     tank2->killTank();
     tank2->setRoundWasKilled(true);
-    gameData.board[tank2->getY()][tank2->getX()] = EMPTY_SPACE;
+    setCell(tank2->getX(), tank2->getY(), EMPTY_SPACE);
+    stateHash.toggleTank(*tank1);
+    stateHash.toggleTank(*tank2);
+    publish(GameEvent::Type::TankKilled, tank1->getX(), tank1->getY(), tank1->getCreationOrder(), tank1->getPlayerId(), tank1->getNumShells());
+    publish(GameEvent::Type::TankKilled, tank2->getX(), tank2->getY(), tank2->getCreationOrder(), tank2->getPlayerId(), tank2->getNumShells());
     
-    // Update tank counts
-    if (tank1->getPlayerId() == 1) {
-        gameData.player1TankCount--;
-    } else {
-        gameData.player2TankCount--;
-    }
-    if (tank2->getPlayerId() == 1) {
-        gameData.player1TankCount--;
-    } else {
-        gameData.player2TankCount--;
-    }
-    
-    std::cout << "Both tanks destroyed. Remaining tanks - Player 1: " 
-              << gameData.player1TankCount << ", Player 2: " << gameData.player2TankCount << std::endl;
+    std::cout << "Both tanks destroyed. Remaining tanks - Player " << tank1->getPlayerId() << ": "
+              << teamTally.aliveCount(tank1->getPlayerId()) << ", Player " << tank2->getPlayerId() << ": "
+              << teamTally.aliveCount(tank2->getPlayerId()) << std::endl;
 }
 
 void GameManager::checkTankSwapping() {
     std::cout << "\nChecking for tank swapping..." << std::endl;
-    // Create a map of current positions to tank pointers
-    auto currentPositions = createTankPositionMap();
-    
-    // Check for tanks that swapped places
-    for (auto& [pos, tank] : currentPositions) {
-        if (!tank->getIsAlive()) {
-            std::cout << "Skipping dead tank at position (" << pos.first << "," << pos.second << ")" << std::endl;
-            continue;  // Skip if tank was already killed
-        }
-        
-        // Get the tank's previous position
-        auto prevPos = tank->getPreviousPosition();
-        if (!prevPos) {
-            std::cout << "Tank " << tank->getCreationOrder() << " (Player " << tank->getPlayerId() 
-                      << ") has no previous position, skipping" << std::endl;
-            continue;  // Skip if no previous position (tank didn't move)
-        }
-        
-        std::cout << "Checking tank " << tank->getCreationOrder() << " (Player " << tank->getPlayerId() 
-                  << ") at (" << pos.first << "," << pos.second << ") with previous position ("
-                  << prevPos->first << "," << prevPos->second << ")" << std::endl;
-        
-        // Check if there's another tank at the previous position
-        auto otherTankIt = currentPositions.find(*prevPos);
-        if (otherTankIt != currentPositions.end()) {
-            TankInfo* otherTank = otherTankIt->second;
-            
-            std::cout << "Found another tank " << otherTank->getCreationOrder() << " (Player " 
-                      << otherTank->getPlayerId() << ") at previous position" << std::endl;
-            
-            // Check if tanks swapped places
-            if (tanksSwappedPlaces(tank, otherTank)) {
-                std::cout << "Tanks " << tank->getCreationOrder() << " and " << otherTank->getCreationOrder() 
-                          << " swapped places - handling collision" << std::endl;
-                handleTankSwap(tank, otherTank);
-            }
-        }
+    pmr::vector<pair<size_t, size_t>> swappedPairs(&roundArena);
+    tankTable.findSwappedPairs(swappedPairs);
+
+    for (const auto& [first, second] : swappedPairs) {
+        TankInfo tank(tankTable, first);
+        TankInfo otherTank(tankTable, second);
+        std::cout << "Tanks " << first << " and " << second << " swapped places - handling collision" << std::endl;
+        handleTankSwap(&tank, &otherTank);
     }
 }
 
@@ -539,7 +543,7 @@ bool GameManager::isValidTankAction(const TankInfo& tank, ActionRequest action)
             
             // Check if the move is valid (not into a wall or damaged wall)
             char nextCell = gameData.board[nextY][nextX];
-            return nextCell != WALL && nextCell != DAMAGED_WALL;
+            return !GameRules::blocksTank(nextCell);
         }
             
         case ActionRequest::Shoot:
@@ -559,7 +563,7 @@ bool GameManager::isValidTankAction(const TankInfo& tank, ActionRequest action)
             
             // Check if the move is valid (not into a wall or damaged wall)
             char nextCell = gameData.board[nextY][nextX];
-            return nextCell != WALL && nextCell != DAMAGED_WALL;
+            return !GameRules::blocksTank(nextCell);
             }
             return true;
         }
@@ -569,6 +573,13 @@ bool GameManager::isValidTankAction(const TankInfo& tank, ActionRequest action)
 }
 
 void GameManager::processTankAction(TankInfo& tank, ActionRequest action) {
+    // Swap the tank's old state for its new one in the state hash
+    stateHash.toggleTank(tank);
+    applyTankAction(tank, action);
+    stateHash.toggleTank(tank);
+}
+
+void GameManager::applyTankAction(TankInfo& tank, ActionRequest action) {
     // If tank is dead, mark action as ignored
     if (!tank.getIsAlive()) {
         std::cout << "Tank " << tank.getCreationOrder() << " (Player " << tank.getPlayerId() 
@@ -607,7 +618,7 @@ void GameManager::processTankAction(TankInfo& tank, ActionRequest action) {
             std::cout << "Tank " << tank.getCreationOrder() << " (Player " << tank.getPlayerId() 
                       << ") attempting to move forward to (" << nextX << "," << nextY << ")" << std::endl;
             
-            if (nextCell == WALL || nextCell == DAMAGED_WALL) {
+            if (GameRules::blocksTank(nextCell)) {
                 // Move was invalid - mark as ignored
                 std::cout << "Tank " << tank.getCreationOrder() << " (Player " << tank.getPlayerId() 
                           << ") cannot move forward - blocked by " << nextCell << std::endl;
@@ -627,8 +638,13 @@ void GameManager::processTankAction(TankInfo& tank, ActionRequest action) {
                       << tank.getX() << "," << tank.getY() << ")" << std::endl;
             
             // Update both current and next positions
-            gameData.board[prevY][prevX] = getCurrentCellState(prevX, prevY);
-            gameData.board[tank.getY()][tank.getX()] = getNextCellState(nextCell, tank);
+            setCell(prevX, prevY, getCurrentCellState(prevX, prevY));
+            setCell(tank.getX(), tank.getY(), getNextCellState(nextCell, tank));
+            if (nextCell == MINE) {
+                publish(GameEvent::Type::MineTriggered, tank.getX(), tank.getY(), tank.getCreationOrder(), tank.getPlayerId());
+            } else if (isTankChar(nextCell) || nextCell == TANK_TANK_COLLISION) {
+                publish(GameEvent::Type::TanksCollided, tank.getX(), tank.getY(), tank.getCreationOrder(), tank.getPlayerId());
+            }
             break;
         }
             
@@ -651,7 +667,7 @@ void GameManager::processTankAction(TankInfo& tank, ActionRequest action) {
                 std::cout << "Tank " << tank.getCreationOrder() << " (Player " << tank.getPlayerId() 
                           << ") attempting to complete backward move to (" << nextX << "," << nextY << ")" << std::endl;
                 
-                if (nextCell == WALL || nextCell == DAMAGED_WALL) {
+                if (GameRules::blocksTank(nextCell)) {
                     // Move was invalid - mark as ignored
                     std::cout << "Tank " << tank.getCreationOrder() << " (Player " << tank.getPlayerId() 
                               << ") cannot complete backward move - blocked by " << nextCell << std::endl;
@@ -671,8 +687,13 @@ void GameManager::processTankAction(TankInfo& tank, ActionRequest action) {
                           << tank.getX() << "," << tank.getY() << ")" << std::endl;
                 
                 // Update both current and next positions
-                gameData.board[prevY][prevX] = getCurrentCellState(prevX, prevY);
-                gameData.board[tank.getY()][tank.getX()] = getNextCellState(nextCell, tank);
+                setCell(prevX, prevY, getCurrentCellState(prevX, prevY));
+                setCell(tank.getX(), tank.getY(), getNextCellState(nextCell, tank));
+                if (nextCell == MINE) {
+                    publish(GameEvent::Type::MineTriggered, tank.getX(), tank.getY(), tank.getCreationOrder(), tank.getPlayerId());
+                } else if (isTankChar(nextCell) || nextCell == TANK_TANK_COLLISION) {
+                    publish(GameEvent::Type::TanksCollided, tank.getX(), tank.getY(), tank.getCreationOrder(), tank.getPlayerId());
+                }
             }
             break;
         }
@@ -709,13 +730,22 @@ void GameManager::processTankAction(TankInfo& tank, ActionRequest action) {
             std::cout << "Tank " << tank.getCreationOrder() << " (Player " << tank.getPlayerId() 
                       << ") requesting battle info" << std::endl;
             // Create a GameSatelliteView with the board state from the start of the round
-            GameSatelliteView satelliteView(roundStartBoard, gameData.rows, gameData.columns, tank.getX(), tank.getY());
+            GameSatelliteView satelliteView(roundStartBoard, gameData.rows, gameData.columns, tank.getX(), tank.getY(),
+                                            &shellDangerMap, currentRound, &reachability);
             
             // Get the appropriate player based on tank's player ID
-            Player* player = (tank.getPlayerId() == 1) ? playerOne.get() : playerTwo.get();
+            Player* player = players[tank.getPlayerId() - 1].get();
             
             // Update the tank's algorithm with battle info
-            player->updateTankWithBattleInfo(*tank.getAlgorithm(), satelliteView);
+            auto start = chrono::steady_clock::now();
+            {
+                AllocationStats::PhaseScope phase(AllocationStats::Phase::Decisions);
+                AllocationStats::AlgorithmScope algorithm(*tank.getAlgorithm());
+                player->updateTankWithBattleInfo(*tank.getAlgorithm(), satelliteView);
+            }
+            if (timingDecisions()) {
+                recordDecision(tank, DecisionLatency::Call::UpdateBattleInfo, chrono::steady_clock::now() - start);
+            }
             break;
         }
             
@@ -733,62 +763,48 @@ void GameManager::processTankAction(TankInfo& tank, ActionRequest action) {
 
 void GameManager::addShell(const TankInfo& tank) {
     // Create a new shell at the tank's position with the tank's direction
-    Shell shell(tank.getX(), tank.getY(), tank.getDirection()[0], tank.getDirection()[1], gameData.columns, gameData.rows);
+    Shell shell(tank.getX(), tank.getY(), tank.getDirection()[0], tank.getDirection()[1], gameData.columns, gameData.rows,
+                tank.getCreationOrder());
     activeShells.push_back(shell);
+    stateHash.toggleShell(shell);
+    shellDangerMap.addShell(shell, currentRound, gameData.board);
+    publish(GameEvent::Type::ShellFired, tank.getX(), tank.getY(), tank.getCreationOrder(), tank.getPlayerId());
 }
 
 char GameManager::getNextCellState(char currentCell, const TankInfo& tank) {
-    switch (currentCell) {
-        case MINE:
-            return TANK_MINE_COLLISION;
-        case PLAYER1_TANK:
-        case PLAYER2_TANK:
-            return TANK_TANK_COLLISION;
-        case SHELL:
-            return TANK_SHELL_COLLISION;
-        case EMPTY_SPACE:
-            return (tank.getPlayerId() == 1) ? PLAYER1_TANK : PLAYER2_TANK;
-        default:
-            // For any other collision state, keep it as is
-            return currentCell;
-    }
+    return GameRules::cellEnteredByTank(currentCell, tank.getPlayerId());
+}
+
+void GameManager::setCell(size_t x, size_t y, char cell) {
+    stateHash.toggleCell(x, y, gameData.board[y][x]);
+    reachability.cellChanged(x, y, gameData.board[y][x], cell);
+    gameData.board[y][x] = cell;
+    stateHash.toggleCell(x, y, cell);
 }
 
 char GameManager::getCurrentCellState(size_t x, size_t y) {
     char currentCell = gameData.board[y][x];
     switch (currentCell) {
-        case PLAYER1_TANK:
-        case PLAYER2_TANK:
+        case '1': case '2': case '3': case '4': case '5': case '6': case '7': case '8': case '9':
             return EMPTY_SPACE;
         case TANK_TANK_COLLISION: {
-            // Count how many tanks are at this position
+            // Count how many tanks are at this position, remembering the first in team order
             int tankCount = 0;
-            for (const auto& t : player1Tanks) {
-                if (t.getIsAlive() && t.getX() == x && t.getY() == y) {
-                    tankCount++;
-                }
-            }
-            for (const auto& t : player2Tanks) {
+            int firstTeam = 0;
+            for (size_t index : tankTable.teamOrder()) {
+                TankInfo t(tankTable, index);
                 if (t.getIsAlive() && t.getX() == x && t.getY() == y) {
-                    tankCount++;
+                    if (tankCount++ == 0) {
+                        firstTeam = t.getPlayerId();
+                    }
                 }
             }
             
             // If more than one tank, keep collision state, otherwise set to remaining tank
             if (tankCount > 1) {
                 return TANK_TANK_COLLISION;
-            } else {
-                // Find the remaining tank and return its character
-                for (const auto& t : player1Tanks) {
-                    if (t.getIsAlive() && t.getX() == x && t.getY() == y) {
-                        return PLAYER1_TANK;
-                    }
-                }
-                for (const auto& t : player2Tanks) {
-                    if (t.getIsAlive() && t.getX() == x && t.getY() == y) {
-                        return PLAYER2_TANK;
-                    }
-                }
+            } else if (tankCount == 1) {
+                return tankChar(firstTeam);
             }
             return EMPTY_SPACE;  // Should never reach here
         }
@@ -800,31 +816,23 @@ char GameManager::getCurrentCellState(size_t x, size_t y) {
 void GameManager::logRound() {
     std::cout << "\nLogging round information..." << std::endl;
     
-    // Get all tanks in a single vector using references
-    vector<reference_wrapper<TankInfo>> allTanks;
-    for (auto& tank : player1Tanks) {
-        allTanks.push_back(ref(tank));  // Log all tanks, including dead ones
-    }
-    for (auto& tank : player2Tanks) {
-        allTanks.push_back(ref(tank));  // Log all tanks, including dead ones
-    }
-    
-    // Log all tanks
-    for (const auto& tank : allTanks) {
+    // Log all tanks in team order, including dead ones
+    for (size_t index : tankTable.teamOrder()) {
+        TankInfo tank(tankTable, index);
         try {
-            std::cout << "Tank " << tank.get().getCreationOrder() 
-                      << " (P" << tank.get().getPlayerId() << "): "
-                      << (tank.get().getRoundIsAlive() ? "Alive" : "Dead") << " | "
-                      << "Action: " << static_cast<int>(tank.get().getRoundAction())
-                      << (tank.get().getRoundWasActionIgnored() ? " (Ignored)" : "")
-                      << (tank.get().getRoundWasKilled() ? " (Killed)" : "") << std::endl;
+            std::cout << "Tank " << tank.getCreationOrder() 
+                      << " (P" << tank.getPlayerId() << "): "
+                      << (tank.getRoundIsAlive() ? "Alive" : "Dead") << " | "
+                      << "Action: " << static_cast<int>(tank.getRoundAction())
+                      << (tank.getRoundWasActionIgnored() ? " (Ignored)" : "")
+                      << (tank.getRoundWasKilled() ? " (Killed)" : "") << std::endl;
             
             RoundInfo info;
-            info.isAlive = tank.get().getRoundIsAlive();
-            info.action = tank.get().getRoundAction();
-            info.wasActionIgnored = tank.get().getRoundWasActionIgnored();
-            info.wasKilled = tank.get().getRoundWasKilled();
-            outputWriter->addRoundForTank(tank.get().getCreationOrder(), info);
+            info.isAlive = tank.getRoundIsAlive();
+            info.action = tank.getRoundAction();
+            info.wasActionIgnored = tank.getRoundWasActionIgnored();
+            info.wasKilled = tank.getRoundWasKilled();
+            outputWriter->addRoundForTank(tank.getCreationOrder(), info);
         } catch (const std::exception& e) {
             std::cerr << "Error logging tank info: " << e.what() << std::endl;
         }
@@ -832,6 +840,10 @@ void GameManager::logRound() {
 }
 
 void GameManager::printBoard() {
+    if (terminalView) {
+        terminalView->draw(inputFileName, currentRound, gameData.board);
+        return;
+    }
     std::cout << "\nCurrent Board State:" << std::endl;
     for (size_t y = 0; y < gameData.rows; y++) {
         for (size_t x = 0; x < gameData.columns; x++) {
@@ -842,51 +854,180 @@ void GameManager::printBoard() {
     std::cout << std::endl;
 }
 
+void GameManager::publishLiveState(int round) {
+    if (!liveStream || !liveStream->hasViewers()) {
+        return;
+    }
+    liveTanks.resize(tankTable.size());
+    for (size_t i = 0; i < tankTable.size(); i++) {
+        TankInfo tank(tankTable, i);
+        liveTanks[i] = LiveTank{static_cast<uint32_t>(tank.getX()), static_cast<uint32_t>(tank.getY()),
+                                tank.getNumShells(), static_cast<uint8_t>(tank.getPlayerId()),
+                                static_cast<uint8_t>(tank.getDirectionIndex()), tank.getIsAlive(), 0};
+    }
+    liveStream->publish(gameData.mapName, round, gameData.board, liveTanks.data(), liveTanks.size());
+}
+
+uint64_t GameManager::algorithmStateHash() {
+    uint64_t combined = 0;
+    for (size_t i = 0; i < tankTable.size() && algorithmStateKnown; i++) {
+        TankInfo tank(tankTable, i);
+        if (!tank.getIsAlive()) {
+            continue;  // Never asked again
+        }
+        uint64_t hash = i;
+        algorithmStateKnown = tank.getAlgorithm()->hashState(hash);
+        combined = combined * 0x100000001B3ULL ^ hash;
+    }
+    return combined;
+}
+
+const char* GameManager::fastForwardBlocker() const {
+    if (!algorithmStateKnown) {
+        return "an algorithm does not hash its state";
+    }
+    if (statsEnabled || timingDecisions()) {
+        return "statistics and latency need every round played";
+    }
+    if (liveStream || terminalView) {
+        return "the board is being watched";
+    }
+    return nullptr;
+}
+
+size_t GameManager::detectStateCycle(size_t step) {
+    // Once an algorithm can't tell its state the cycle is only reported, on the game state alone
+    uint64_t hash = stateHash.value();
+    if (algorithmStateKnown) {
+        uint64_t algorithms = algorithmStateHash();
+        if (algorithmStateKnown) {
+            hash ^= algorithms;
+        }
+    }
+    roundHashes.push_back(hash);
+
+    pmr::vector<size_t>& occurrences = seenStates[hash];
+    size_t period = 0;
+
+    // Without the algorithms' state the same game state can recur at irregular gaps.
+    // Accept a period only if the last two periods repeat both the states and the
+    // logged actions, trying the shortest candidate first.
+    for (auto it = occurrences.rbegin(); it != occurrences.rend() && period == 0; ++it) {
+        size_t candidate = step - *it;
+        if (step + 1 < 2 * candidate) {
+            break;
+        }
+        bool repeats = true;
+        for (size_t round = step + 1 - candidate; round <= step && repeats; round++) {
+            repeats = roundHashes[round] == roundHashes[round - candidate] &&
+                      outputWriter->roundsMatch(round, round - candidate);
+        }
+        if (repeats) {
+            period = candidate;
+        }
+    }
+    occurrences.push_back(step);
+
+    if (period > 0 && !cycleReported) {
+        std::cout << "State cycle detected: round " << step + 1 << " repeats round " << step + 1 - period
+                  << " (period " << period << ")" << std::endl;
+        if (cycleFastForward && fastForwardBlocker()) {
+            std::cout << "Not fast-forwarding the cycle: " << fastForwardBlocker() << std::endl;
+        }
+        cycleReported = true;
+    }
+    return period;
+}
+
+bool GameManager::fastForwardCycle(size_t step, size_t period) {
+    std::cout << "Fast-forwarding cycle of period " << period << " from round " << step + 2 << std::endl;
+    for (size_t next = step + 1; next < gameData.maxStep; next++) {
+        // The round played one period earlier is exactly what this round would log
+        currentRound = static_cast<int>(next) + 1;
+        outputWriter->repeatRound(next - period);
+        outputWriter->writeCurrentRound();
+        if (checkImmediateGameEnd()) {
+            std::cout << "Game ended after round " << next + 1 << std::endl;
+            return true;
+        }
+    }
+    return false;
+}
+
 void GameManager::runGameLoop() {
     // Main game loop
     for (size_t step = 0; step < gameData.maxStep; step++) {
         std::cout << "\n==================== Round " << step + 1 << " ====================" << std::endl;
+        currentRound = static_cast<int>(step) + 1;
         
-        // Save the current board state before any movements
-        std::cout << "Saving current board state..." << std::endl;
-        roundStartBoard = gameData.board;
-        
-        // Begin new round for all tanks
-        std::cout << "Starting new round for all tanks..." << std::endl;
-        for (auto& tank : player1Tanks) {
-            tank.beginRound();
-        }
-        for (auto& tank : player2Tanks) {
-            tank.beginRound();
+        // Scratch of the previous round is no longer referenced
+        roundArena.release();
+
+        {
+            AllocationStats::PhaseScope phase(AllocationStats::Phase::Snapshot);
+            // Save the current board state before any movements
+            std::cout << "Saving current board state..." << std::endl;
+            roundStartBoard = gameData.board;
+            
+            // Begin new round for all tanks
+            std::cout << "Starting new round for all tanks..." << std::endl;
+            for (size_t i = 0; i < tankTable.size(); i++) {
+                stateHash.toggleTank(TankInfo(tankTable, i));
+            }
+            tankTable.beginRound();
+            for (size_t i = 0; i < tankTable.size(); i++) {
+                stateHash.toggleTank(TankInfo(tankTable, i));
+            }
         }
         
-        // First shell movement
-        std::cout << "First shell movement phase..." << std::endl;
-        moveShells();
-        
-        // Second shell movement
-        std::cout << "Second shell movement phase..." << std::endl;
-        moveShells();
+        {
+            AllocationStats::PhaseScope phase(AllocationStats::Phase::Shells);
+            // First shell movement
+            std::cout << "First shell movement phase..." << std::endl;
+            moveShells();
+            
+            // Second shell movement
+            std::cout << "Second shell movement phase..." << std::endl;
+            moveShells();
+
+            // Re-predict shell arrivals for the cells touched by this round's shell movement
+            shellDangerMap.refresh(activeShells, currentRound, gameData.board);
+        }
         
-        // Update tanks and check collisions
-        std::cout << "Updating tanks and checking collisions..." << std::endl;
-        updateTanks();
+        {
+            // Decisions are tagged separately inside
+            AllocationStats::PhaseScope phase(AllocationStats::Phase::Apply);
+            // Update tanks and check collisions
+            std::cout << "Updating tanks and checking collisions..." << std::endl;
+            updateTanks();
+        }
         
-        // Log the round information
-        std::cout << "Logging round information..." << std::endl;
-        logRound();
+        {
+            AllocationStats::PhaseScope phase(AllocationStats::Phase::Logging);
+            // Log the round information
+            std::cout << "Logging round information..." << std::endl;
+            logRound();
+        }
 
-        // Write the current round to the output file
-        std::cout << "Writing round to output file..." << std::endl;
-        outputWriter->writeCurrentRound();
+        {
+            AllocationStats::PhaseScope phase(AllocationStats::Phase::Output);
+            // Write the current round to the output file
+            std::cout << "Writing round to output file..." << std::endl;
+            outputWriter->writeCurrentRound();
+            publishLiveState(currentRound);
+        }
 
-        // Print current board state
-        std::cout << "Current board state after round " << step + 1 << ":" << std::endl;
-        printBoard();
+        {
+            AllocationStats::PhaseScope phase(AllocationStats::Phase::Logging);
+            // Print current board state
+            std::cout << "Current board state after round " << step + 1 << ":" << std::endl;
+            printBoard();
+        }
         
         // Print tank counts
-        std::cout << "Player 1 tanks remaining: " << gameData.player1TankCount << std::endl;
-        std::cout << "Player 2 tanks remaining: " << gameData.player2TankCount << std::endl;
+        for (int team = 1; team <= gameData.numTeams; team++) {
+            std::cout << "Player " << team << " tanks remaining: " << teamTally.aliveCount(team) << std::endl;
+        }
 
         // Check if game should end
         std::cout << "Checking for game end conditions..." << std::endl;
@@ -894,19 +1035,32 @@ void GameManager::runGameLoop() {
             std::cout << "Game ended after round " << step + 1 << std::endl;
             return;  // Exit immediately after writing the game end message
         }
+
+        // Check whether the game entered a cycle of repeated states
+        size_t period = detectStateCycle(step);
+        if (period > 0 && cycleFastForward && !fastForwardBlocker()) {
+            if (fastForwardCycle(step, period)) {
+                return;
+            }
+            break;
+        }
         
         std::cout << "Round " << step + 1 << " completed successfully" << std::endl;
     }
 
     // If we reach here, we hit max steps
     std::cout << "Game reached maximum steps (" << gameData.maxStep << ")" << std::endl;
-    outputWriter->writeMaxStepsTie(gameData.maxStep, 
-        gameData.player1TankCount, 
-        gameData.player2TankCount);
+    vector<int> playerTanks;
+    for (int team = 1; team <= gameData.numTeams; team++) {
+        playerTanks.push_back(teamTally.aliveCount(team));
+    }
+    outputWriter->writeMaxStepsTie(gameData.maxStep, playerTanks);
+    setResult(GameResult::Reason::MaxSteps, 0);
 }
 
 void GameManager::run() {
     std::cout << "\nStarting game..." << std::endl;
+    currentRound = 0;
     std::cout << "Initial board state:" << std::endl;
     printBoard();
     setOutputFile();  // Empty string since we use input filename
@@ -914,13 +1068,34 @@ void GameManager::run() {
     std::cout << "Initializing players and tanks..." << std::endl;
     initializePlayersAndTanks();
 
+    // Hold the live stream for the whole run, and give it back even if an algorithm throws
+    struct LiveClaim {
+        LiveStateExport*& stream;
+        ~LiveClaim() {
+            if (stream) {
+                stream->release();
+                stream = nullptr;
+            }
+        }
+    } liveClaim{liveStream};
+    liveStream = liveExport && liveExport->claim() ? liveExport : nullptr;
+    publishLiveState(0);
+
     if (checkImmediateGameEnd()) {
         std::cout << "Game ended immediately due to initial conditions." << std::endl;
+        writeStats();
+        writeLatency();
         return;
     }
     
     std::cout << "Starting game loop..." << std::endl;
     runGameLoop();
+    if (terminalView) {
+        // The frame rate limit may have skipped the last round
+        terminalView->draw(inputFileName, currentRound, gameData.board, true);
+    }
+    writeStats();
+    writeLatency();
     
     std::cout << "Game finished." << std::endl;
 }
@@ -1,5 +1,8 @@
 #pragma once
 #include <memory>
+#include <memory_resource>
+#include <array>
+#include <set>
 #include <cstddef>
 #include <string>
 #include <vector>
@@ -13,17 +16,35 @@
 #include "../constants/BoardConstants.h"
 #include "BoardReader.h"
 #include "OutputWriter.h"
+#include "TankTable.h"
 #include "TankInfo.h"
 #include "Shell.h"
+#include "ShellDangerMap.h"
+#include "ReachabilityMap.h"
+#include "GameRules.h"
+#include "ZobristHash.h"
+#include "GameEvents.h"
+#include "TeamTally.h"
+#include "MatchStats.h"
+#include "DecisionLatency.h"
+#include "AllocationStats.h"
+#include "LiveStateExport.h"
+#include "TerminalRenderer.h"
+#include <chrono>
 #include <map>
+#include <unordered_map>
 #include <utility>
 
 using namespace std;
 
-struct TankPosition {
-    size_t x, y;
-    int playerId;
-    int tankIndex;
+// How a finished game ended
+struct GameResult {
+    enum class Reason { NotFinished, AllTanksDead, MaxSteps, ZeroShells };
+    Reason reason = Reason::NotFinished;
+    int winner = 0;  // Winning player, 0 for a tie
+    size_t rounds = 0;
+    int numTeams = 0;
+    array<size_t, BoardConstants::MAX_TEAMS + 1> teamTanks{};  // Living tanks per team, entry 0 unused
 };
 
 struct TankRoundInfo {
@@ -32,24 +53,80 @@ struct TankRoundInfo {
     bool wasKilled;
 };
 
+// Containers of per-round scratch data, allocated from the round arena
+using PositionShellsMap = pmr::map<pair<size_t, size_t>, pmr::vector<size_t>>;
+
 class GameManager
 {
 private:
+    // Everything owned by a match (tanks and their algorithms, shells, cycle bookkeeping)
+    // is allocated here and given back in one release when the next match starts
+    pmr::monotonic_buffer_resource matchArena;
+    // Scratch for the maps and sets built while resolving a round, released every round
+    static constexpr size_t ROUND_ARENA_BYTES = 16 * 1024;
+    array<byte, ROUND_ARENA_BYTES> roundBuffer;
+    pmr::monotonic_buffer_resource roundArena;
+
     BoardData gameData;
-    unique_ptr<Player> playerOne;
-    unique_ptr<Player> playerTwo;
+    vector<unique_ptr<Player>> players;  // Player of team k at k - 1
     PlayerFactory& playerFactory;
     TankAlgorithmFactory& algorithmFactory;
     unique_ptr<OutputWriter> outputWriter;
-    int creationOrderCounter;  // Added to track tank creation order across both players
+    int creationOrderCounter;  // Added to track tank creation order across all players
     string inputFileName;  // Store the input filename
+    bool boardCache;       // Load boards from their binary sidecar when it is up to date
     
-    // Store tank information for each player
-    vector<TankInfo> player1Tanks;
-    vector<TankInfo> player2Tanks;
+    // All tanks by creation order, also indexed by team
+    TankTable tankTable;
     
     // Store active shells in the game
-    vector<Shell> activeShells;
+    pmr::vector<Shell> activeShells;
+
+    // Predicted shell arrival round per cell, shared with the algorithms through battle info
+    ShellDangerMap shellDangerMap;
+    // Which cells can reach which without shooting, also shared through battle info
+    ReachabilityMap reachability;
+    int currentRound;  // 1-based number of the round being played
+
+    // Incremental hash of the game state, used to detect repeated states
+    ZobristHash stateHash;
+    pmr::unordered_map<uint64_t, pmr::vector<size_t>> seenStates;  // State hash -> rounds (0-based) it was seen after
+    pmr::vector<uint64_t> roundHashes;           // State hash after each round
+    bool cycleFastForward;  // Skip the remaining rounds once a cycle is confirmed
+    bool cycleReported;
+    bool algorithmStateKnown;  // Every algorithm hashes its state into the cycle check
+
+    GameResult result;
+    void setResult(GameResult::Reason reason, int winner);
+
+    // Events of the match as they happen; the tally is always subscribed and feeds the end checks
+    GameEventBus events;
+    TeamTally teamTally;
+    void publish(GameEvent::Type type, size_t x, size_t y, int tank = -1, int player = 0, int count = 0,
+                 int otherTank = -1);
+
+    // Combat statistics, only subscribed and written when enabled
+    MatchStats matchStats;
+    bool statsEnabled;
+    void writeStats();
+
+    // Time spent in the algorithms, measured only while written out or checked for slow calls
+    DecisionLatency decisionLatency;
+    bool latencyEnabled;
+    chrono::nanoseconds slowDecisionLimit;  // Zero for no slow call report
+    bool replaceSlowActions;
+    bool timingDecisions() const { return latencyEnabled || slowDecisionLimit.count() > 0; }
+    bool recordDecision(const TankInfo& tank, DecisionLatency::Call call, chrono::nanoseconds elapsed);  // True when slow
+    void writeLatency();
+
+    // Frames for an external viewer, published only while this run holds the stream
+    LiveStateExport* liveExport;
+    LiveStateExport* liveStream;  // liveExport while claimed, otherwise null
+    vector<LiveTank> liveTanks;
+    void publishLiveState(int round);
+
+    // Draws the board in place of printBoard() when set
+    TerminalRenderer* terminalView;
 
     // Store the board state at the start of each round
     vector<vector<char>> roundStartBoard;
@@ -57,44 +134,53 @@ private:
     // Helper functions for game management
     bool checkImmediateGameEnd();
     void initializePlayersAndTanks();
+    void releaseMatchArena();  // Drop all per-match containers and release their memory
     void runGameLoop();
     void logRound();  // Added to log round information for all tanks
     
     // Tank initialization helper functions
-    vector<TankPosition> collectTankPositions();
-    void sortTankPositions(vector<TankPosition>& positions);
     void createTanksFromPositions(const vector<TankPosition>& positions);
 
     // Game loop helper functions
     void moveShells();  // Move all active shells once
     void checkCollisions();  // Check for collisions between all game objects
     void updateTanks();   // Get and process tank actions
-    void updateTankVector(vector<TankInfo>& tanks);  // Helper to update a vector of tanks
+    void updateTeam(int team);  // Helper to update the tanks of one team
+    ActionRequest decide(TankInfo& tank);  // Ask the tank's algorithm for its action
     void checkTankSwapping();  // Check for tanks that swapped places
     
     // Tank swapping helper functions
-    map<pair<size_t, size_t>, TankInfo*> createTankPositionMap();  // Create map of current positions to tank pointers
     void handleTankSwap(TankInfo* tank1, TankInfo* tank2);  // Handle the case where two tanks swapped places
-    bool tanksSwappedPlaces(TankInfo* tank1, TankInfo* tank2);  // Check if two tanks swapped places
     
     void processTankAction(TankInfo& tank, ActionRequest action);  // Process a single tank's action
+    void applyTankAction(TankInfo& tank, ActionRequest action);    // Apply the action rules to a tank
     bool isValidTankAction(const TankInfo& tank, ActionRequest action) const;  // Validate if a tank action is legal
     void addShell(const TankInfo& tank);  // Create and add a new shell from a tank's position and direction
     char getNextCellState(char currentCell, const TankInfo& tank);  // Get the next cell state based on current cell and tank
     char getCurrentCellState(size_t x, size_t y);  // Get the current cell state after tank moves
+    void setCell(size_t x, size_t y, char cell);  // Write a board cell, keeping the state hash in sync
+
+    // Cycle detection
+    size_t detectStateCycle(size_t step);  // Returns the confirmed cycle period ending at this round, or 0
+    bool fastForwardCycle(size_t step, size_t period);  // Replay the cycle until the game ends
+    uint64_t algorithmStateHash();  // Combined state of the living tanks' algorithms, clears algorithmStateKnown if one can't tell
+    const char* fastForwardBlocker() const;  // Why a confirmed cycle can't be skipped, null if it can
 
     // Shell management
-    void detectShellCrossings(vector<bool>& shellsToRemove, map<pair<size_t, size_t>, vector<size_t>>& nextPositions);
-    void removeMarkedShells(const vector<bool>& shellsToRemove);
-    std::vector<std::pair<size_t, size_t>> handleShellPositions(const map<pair<size_t, size_t>, vector<size_t>>& nextPositions);
+    void detectShellCrossings(pmr::vector<bool>& shellsToRemove, PositionShellsMap& nextPositions);
+    void removeMarkedShells(const pmr::vector<bool>& shellsToRemove);
+    // shellOwners holds the owner of every shell as indexed by nextPositions
+    pmr::vector<pair<size_t, size_t>> handleShellPositions(const PositionShellsMap& nextPositions,
+                                                           const pmr::vector<int>& shellOwners);
 
     // Collision handling helpers
-    void handleTankCollision(const pair<size_t, size_t>& pos);
-    void handleWallCollision(const pair<size_t, size_t>& pos);
-    void handleDamagedWallCollision(const pair<size_t, size_t>& pos);
+    // shooter is the tank that fired the shell, -1 if unknown
+    void handleTankCollision(const pair<size_t, size_t>& pos, int shooter);
+    void handleWallCollision(const pair<size_t, size_t>& pos, int shooter);
+    void handleDamagedWallCollision(const pair<size_t, size_t>& pos, int shooter);
     void handleMineCollision(const pair<size_t, size_t>& pos);
     void handleMultipleShellCollision(const pair<size_t, size_t>& pos);
-    void findAndKillTank(size_t x, size_t y);
+    void findAndKillTank(size_t x, size_t y, int shooter = -1);
     void printBoard();  // Added to print the current board state
 
     bool allTanksOutOfShells;  // Track if all tanks have run out of shells
@@ -106,9 +192,45 @@ public:
     GameManager(PlayerFactory &player_factory, TankAlgorithmFactory &algorithmFactory);
     ~GameManager() {}
     void readBoard(string fileName);
+    // Keep a parsed copy of every board read next to it, see BoardReader::readBoard
+    void setBoardCache(bool enabled) { boardCache = enabled; }
     void setOutputFile();
     void run();
+
+    // When enabled, a confirmed repetition of states and actions ends the simulation early
+    // by replaying the cycle into the output. A cycle is only skipped when every algorithm
+    // hashes its own state into the check (TankAlgorithm::hashState) and no statistics,
+    // latency or views need the skipped rounds, so the result is that of the full run.
+    void setCycleFastForward(bool enabled) { cycleFastForward = enabled; }
+
+    // Receive every game event of the following runs. The listener is not owned.
+    void addEventListener(GameEventListener* listener) { events.subscribe(listener); }
+
+    // Write per-tank and per-algorithm combat statistics to stats_<board file> after each run
+    void setStatsOutput(bool enabled);
+    const MatchStats& getStats() const { return matchStats; }
+
+    // Write getAction()/updateBattleInfo() latency percentiles per tank and per algorithm
+    // class to latency_<board file> after each run
+    void setLatencyOutput(bool enabled) { latencyEnabled = enabled; }
+    // Report every call slower than limit (zero disables it). Calls are timed once they
+    // return, so this reports slow algorithms but cannot stop one that never returns; the
+    // isolated batch game timeout does that. With replaceSlow a slow getAction() is played
+    // as DoNothing; the algorithm is not told, and results then depend on the machine.
+    void setSlowDecisionReport(chrono::nanoseconds limit, bool replaceSlow);
+    const DecisionLatency& getLatency() const { return decisionLatency; }
+
+    // Publish the board and tanks after every round to a shared memory segment, unless
+    // another game is already streaming there. The export is not owned.
+    void setLiveExport(LiveStateExport* exporter) { liveExport = exporter; }
+
+    // Redraw the changed cells on a terminal every round instead of printing the whole
+    // board to cout. The renderer is not owned; the logs still go to cout.
+    void setTerminalView(TerminalRenderer* renderer) { terminalView = renderer; }
     
     // Added method to access game data
     const BoardData& getGameData() const { return gameData; }
+
+    // Outcome of the last run
+    const GameResult& getResult() const { return result; }
 };
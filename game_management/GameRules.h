@@ -0,0 +1,60 @@
+#pragma once
+#include "../constants/BoardConstants.h"
+
+// Cell transitions of the game rules that do not depend on who else is on the board.
+// GameManager and the lockstep engine both resolve rounds through these.
+namespace GameRules {
+    // Walls stop tanks; everything else can be driven onto
+    inline bool blocksTank(char cell) {
+        return cell == BoardConstants::WALL || cell == BoardConstants::DAMAGED_WALL;
+    }
+
+    // What a cell shows once a tank of `team` has driven onto it
+    inline char cellEnteredByTank(char cell, int team) {
+        switch (cell) {
+            case BoardConstants::MINE:
+                return BoardConstants::TANK_MINE_COLLISION;
+            case '1': case '2': case '3': case '4': case '5': case '6': case '7': case '8': case '9':
+                return BoardConstants::TANK_TANK_COLLISION;
+            case BoardConstants::SHELL:
+                return BoardConstants::TANK_SHELL_COLLISION;
+            case BoardConstants::EMPTY_SPACE:
+                return BoardConstants::tankChar(team);
+            default:
+                // For any other collision state, keep it as is
+                return cell;
+        }
+    }
+
+    // What a cell shows once the shells on it have moved on; tanks sharing the cell stay
+    inline char cellLeftByShell(char cell) {
+        if (cell == BoardConstants::SHELL) {
+            return BoardConstants::EMPTY_SPACE;
+        }
+        if (cell == BoardConstants::MINE_SHELL_COLLISION) {
+            return BoardConstants::MINE;
+        }
+        return cell;
+    }
+
+    // What a single shell does to the cell it flies into
+    enum class ShellHit {
+        Tank,         // The first living tank on the cell dies and the shell with it
+        Wall,         // The wall is damaged and the shell destroyed
+        DamagedWall,  // The wall falls and the shell is destroyed
+        Mine,         // The shell flies over the mine
+        Empty,        // The shell is now on the cell
+        PassThrough   // Collision states are left alone and the shell flies on
+    };
+
+    inline ShellHit singleShellHit(char cell) {
+        if (BoardConstants::isTankChar(cell)) return ShellHit::Tank;
+        switch (cell) {
+            case BoardConstants::WALL: return ShellHit::Wall;
+            case BoardConstants::DAMAGED_WALL: return ShellHit::DamagedWall;
+            case BoardConstants::MINE: return ShellHit::Mine;
+            case BoardConstants::EMPTY_SPACE: return ShellHit::Empty;
+            default: return ShellHit::PassThrough;
+        }
+    }
+}
@@ -0,0 +1,333 @@
+#include "LiveStateExport.h"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <iostream>
+#include <new>
+#include <stdexcept>
+#ifdef __unix__
+#include <cerrno>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+    const uint32_t SEGMENT_MAGIC = 0x564C4B54;  // "TKLV"
+    const uint32_t SEGMENT_VERSION = 1;
+    const size_t MAP_NAME_SIZE = 64;
+    const int READ_ATTEMPTS = 8;
+
+    // Start of the segment. The atomics are shared between processes, which only works lock-free.
+    struct SegmentHeader {
+        uint32_t magic;    // Written last, a viewer ignores the segment until then
+        uint32_t version;
+        uint32_t slots;
+        uint32_t tankCapacity;
+        uint64_t cellCapacity;
+        uint64_t slotBytes;
+        int64_t writerPid;
+        atomic<uint32_t> writerOpen;
+        atomic<uint32_t> viewers;
+        atomic<uint32_t> claimed;  // Pid of the process whose game holds the stream, 0 for none
+        atomic<uint32_t> games;
+        atomic<uint64_t> published;  // Frames published, the latest is in slot published % slots
+    };
+    static_assert(atomic<uint32_t>::is_always_lock_free && atomic<uint64_t>::is_always_lock_free,
+                  "shared counters must be lock-free");
+
+    // Followed by cellCapacity cells and tankCapacity LiveTanks. The sequence is odd while
+    // the frame is written; a read is good if it saw the same even sequence before and after.
+    struct SlotHeader {
+        atomic<uint64_t> sequence;
+        uint64_t frame;
+        uint32_t game;
+        int32_t round;
+        uint32_t rows;
+        uint32_t columns;
+        uint32_t tankCount;
+        char mapName[MAP_NAME_SIZE];
+    };
+
+    size_t roundUp(size_t size) {
+        return (size + 63) & ~size_t(63);
+    }
+
+    size_t headerBytes() {
+        return roundUp(sizeof(SegmentHeader));
+    }
+
+    size_t slotBytes(size_t cellCapacity) {
+        return roundUp(sizeof(SlotHeader) + cellCapacity + LiveStateExport::TANK_CAPACITY * sizeof(LiveTank));
+    }
+
+    SegmentHeader* headerOf(void* memory) {
+        return static_cast<SegmentHeader*>(memory);
+    }
+
+    SlotHeader* slotOf(void* memory, uint64_t frame) {
+        SegmentHeader* header = headerOf(memory);
+        char* base = static_cast<char*>(memory) + headerBytes();
+        return reinterpret_cast<SlotHeader*>(base + (frame % header->slots) * header->slotBytes);
+    }
+
+    char* cellsOf(SlotHeader* slot) {
+        return reinterpret_cast<char*>(slot) + sizeof(SlotHeader);
+    }
+
+    LiveTank* tanksOf(SlotHeader* slot, size_t cellCapacity) {
+        return reinterpret_cast<LiveTank*>(cellsOf(slot) + cellCapacity);
+    }
+}
+
+#ifdef __unix__
+
+LiveStateExport::LiveStateExport(const string& name, size_t cellCapacity)
+    : name(name), memory(nullptr), size(0), cellCapacity(cellCapacity), game(0), warnedTooLarge(false)
+{
+    // Tank records follow the cells, keep them aligned
+    this->cellCapacity = (cellCapacity + alignof(LiveTank) - 1) & ~(alignof(LiveTank) - 1);
+    size = headerBytes() + SLOTS * slotBytes(this->cellCapacity);
+
+    shm_unlink(name.c_str());
+    int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0) {
+        throw runtime_error("LiveStateExport: cannot create " + name + ": " + strerror(errno));
+    }
+    if (ftruncate(fd, static_cast<off_t>(size)) != 0) {
+        int error = errno;
+        close(fd);
+        shm_unlink(name.c_str());
+        throw runtime_error("LiveStateExport: cannot size " + name + ": " + strerror(error));
+    }
+    memory = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (memory == MAP_FAILED) {
+        memory = nullptr;
+        shm_unlink(name.c_str());
+        throw runtime_error("LiveStateExport: cannot map " + name);
+    }
+
+    // The new segment is zeroed, which is a valid state for every field
+    SegmentHeader* header = new (memory) SegmentHeader();
+    header->version = SEGMENT_VERSION;
+    header->slots = SLOTS;
+    header->tankCapacity = TANK_CAPACITY;
+    header->cellCapacity = this->cellCapacity;
+    header->slotBytes = slotBytes(this->cellCapacity);
+    header->writerPid = getpid();
+    for (uint32_t slot = 0; slot < SLOTS; slot++) {
+        new (slotOf(memory, slot)) SlotHeader();
+    }
+    header->writerOpen.store(1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    header->magic = SEGMENT_MAGIC;
+    std::cout << "Publishing live state to shared memory " << name << std::endl;
+}
+
+LiveStateExport::~LiveStateExport() {
+    if (!memory) {
+        return;
+    }
+    // Viewers keep their mapping and see the last frame; the name is free for the next run
+    headerOf(memory)->writerOpen.store(0, memory_order_release);
+    munmap(memory, size);
+    shm_unlink(name.c_str());
+}
+
+bool LiveStateExport::claim() {
+    SegmentHeader* header = headerOf(memory);
+    uint32_t self = static_cast<uint32_t>(getpid());
+    uint32_t expected = 0;
+    if (!header->claimed.compare_exchange_strong(expected, self, memory_order_acq_rel)) {
+        // A worker process that crashed or was killed mid-game never released its claim
+        bool claimantGone = expected != self && kill(static_cast<pid_t>(expected), 0) != 0 && errno == ESRCH;
+        if (!claimantGone || !header->claimed.compare_exchange_strong(expected, self, memory_order_acq_rel)) {
+            return false;
+        }
+    }
+    game = header->games.fetch_add(1, memory_order_relaxed) + 1;
+    return true;
+}
+
+void LiveStateExport::release() {
+    headerOf(memory)->claimed.store(0, memory_order_release);
+}
+
+bool LiveStateExport::hasViewers() const {
+    return headerOf(memory)->viewers.load(memory_order_relaxed) != 0;
+}
+
+bool LiveStateExport::publish(const string& mapName, int round, const vector<vector<char>>& board,
+                              const LiveTank* tanks, size_t tankCount) {
+    if (!hasViewers()) {
+        return false;
+    }
+    size_t rows = board.size();
+    size_t columns = rows == 0 ? 0 : board[0].size();
+    if (rows * columns > cellCapacity || tankCount > TANK_CAPACITY) {
+        if (!warnedTooLarge) {
+            std::cerr << "LiveStateExport: " << mapName << " does not fit in " << name << ", not publishing it" << std::endl;
+            warnedTooLarge = true;
+        }
+        return false;
+    }
+
+    // Only the claiming game writes, so the counter cannot move under us
+    SegmentHeader* header = headerOf(memory);
+    uint64_t frame = header->published.load(memory_order_relaxed) + 1;
+    SlotHeader* slot = slotOf(memory, frame);
+    uint64_t sequence = slot->sequence.load(memory_order_relaxed);
+    slot->sequence.store(sequence + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+
+    slot->frame = frame;
+    slot->game = game;
+    slot->round = round;
+    slot->rows = static_cast<uint32_t>(rows);
+    slot->columns = static_cast<uint32_t>(columns);
+    slot->tankCount = static_cast<uint32_t>(tankCount);
+    size_t nameLength = min(mapName.size(), MAP_NAME_SIZE - 1);
+    memcpy(slot->mapName, mapName.data(), nameLength);
+    slot->mapName[nameLength] = '\0';
+    char* cells = cellsOf(slot);
+    for (size_t y = 0; y < rows; y++) {
+        memcpy(cells + y * columns, board[y].data(), columns);
+    }
+    memcpy(tanksOf(slot, cellCapacity), tanks, tankCount * sizeof(LiveTank));
+
+    slot->sequence.store(sequence + 2, memory_order_release);
+    header->published.store(frame, memory_order_release);
+    return true;
+}
+
+LiveStateView::LiveStateView(const string& name) : name(name), memory(nullptr), size(0) {
+}
+
+bool LiveStateView::attach() {
+    if (memory) {
+        return true;
+    }
+    int fd = shm_open(name.c_str(), O_RDWR, 0);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < headerBytes()) {
+        close(fd);
+        return false;
+    }
+    size_t mappedSize = static_cast<size_t>(info.st_size);
+    void* mapped = mmap(nullptr, mappedSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapped == MAP_FAILED) {
+        return false;
+    }
+    SegmentHeader* header = headerOf(mapped);
+    bool ready = header->magic == SEGMENT_MAGIC;
+    atomic_thread_fence(memory_order_acquire);
+    if (!ready || header->version != SEGMENT_VERSION || header->slots == 0 ||
+        mappedSize < headerBytes() + header->slots * header->slotBytes) {
+        munmap(mapped, mappedSize);
+        return false;
+    }
+    header->viewers.fetch_add(1, memory_order_relaxed);
+    memory = mapped;
+    size = mappedSize;
+    // Left behind by a writer that crashed, wait for the next one to replace it
+    if (writerClosed()) {
+        detach();
+        return false;
+    }
+    return true;
+}
+
+void LiveStateView::detach() {
+    if (!memory) {
+        return;
+    }
+    headerOf(memory)->viewers.fetch_sub(1, memory_order_relaxed);
+    munmap(memory, size);
+    memory = nullptr;
+    size = 0;
+}
+
+bool LiveStateView::writerClosed() const {
+    if (!memory) {
+        return true;
+    }
+    const SegmentHeader* header = headerOf(memory);
+    // A writer that crashed never cleared the flag
+    return header->writerOpen.load(memory_order_acquire) == 0 ||
+           (kill(static_cast<pid_t>(header->writerPid), 0) != 0 && errno == ESRCH);
+}
+
+bool LiveStateView::poll(LiveFrame& frame) {
+    if (!memory) {
+        return false;
+    }
+    SegmentHeader* header = headerOf(memory);
+    LiveFrame next;
+    for (int attempt = 0; attempt < READ_ATTEMPTS; attempt++) {
+        uint64_t latest = header->published.load(memory_order_acquire);
+        if (latest == 0 || latest <= frame.frame) {
+            return false;
+        }
+        SlotHeader* slot = slotOf(memory, latest);
+        uint64_t sequence = slot->sequence.load(memory_order_acquire);
+        if (sequence & 1) {
+            continue;
+        }
+        // Fields may be torn until the sequence is checked again, so bound them first
+        size_t rows = slot->rows;
+        size_t columns = slot->columns;
+        size_t tankCount = slot->tankCount;
+        if (rows * columns > header->cellCapacity || tankCount > header->tankCapacity) {
+            continue;
+        }
+        next.frame = slot->frame;
+        next.game = slot->game;
+        next.round = slot->round;
+        next.rows = rows;
+        next.columns = columns;
+        char mapName[MAP_NAME_SIZE];
+        memcpy(mapName, slot->mapName, MAP_NAME_SIZE);
+        mapName[MAP_NAME_SIZE - 1] = '\0';
+        next.cells.resize(rows * columns);
+        memcpy(next.cells.data(), cellsOf(slot), rows * columns);
+        next.tanks.resize(tankCount);
+        memcpy(next.tanks.data(), tanksOf(slot, header->cellCapacity), tankCount * sizeof(LiveTank));
+        atomic_thread_fence(memory_order_acquire);
+        if (slot->sequence.load(memory_order_relaxed) != sequence) {
+            continue;
+        }
+        next.mapName = mapName;
+        swap(frame, next);
+        return true;
+    }
+    return false;  // The writer kept overtaking us, try on the next poll
+}
+
+#else
+
+LiveStateExport::LiveStateExport(const string& name, size_t cellCapacity)
+    : name(name), memory(nullptr), size(0), cellCapacity(cellCapacity), game(0), warnedTooLarge(false)
+{
+    throw runtime_error("LiveStateExport: shared memory export is only available on POSIX systems");
+}
+
+LiveStateExport::~LiveStateExport() {}
+bool LiveStateExport::claim() { return false; }
+void LiveStateExport::release() {}
+bool LiveStateExport::hasViewers() const { return false; }
+bool LiveStateExport::publish(const string&, int, const vector<vector<char>>&, const LiveTank*, size_t) { return false; }
+
+LiveStateView::LiveStateView(const string& name) : name(name), memory(nullptr), size(0) {}
+bool LiveStateView::attach() { return false; }
+void LiveStateView::detach() {}
+bool LiveStateView::writerClosed() const { return true; }
+bool LiveStateView::poll(LiveFrame&) { return false; }
+
+#endif
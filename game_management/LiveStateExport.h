@@ -0,0 +1,91 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// State of one tank in a published frame
+struct LiveTank {
+    uint32_t x;
+    uint32_t y;
+    int32_t shells;
+    uint8_t player;
+    uint8_t direction;  // Index into Directions::VECTORS
+    uint8_t alive;
+    uint8_t reserved;
+};
+
+// A round as a viewer sees it, copied out of the shared segment
+struct LiveFrame {
+    uint64_t frame = 0;  // Frames published so far, including this one; 0 for none
+    uint32_t game = 0;   // Games that claimed the stream so far, including this one
+    int round = 0;       // 0 for the state before the first round
+    size_t rows = 0;
+    size_t columns = 0;
+    string mapName;
+    vector<char> cells;  // Row-major
+    vector<LiveTank> tanks;  // In creation order
+};
+
+// Publishes the state of a running game to a POSIX shared memory segment, so a
+// viewer process on the same machine can watch it at its own pace. The segment
+// holds a small ring of frames, each guarded by a sequence counter: the engine
+// never waits for a viewer, and a viewer that reads a frame while it is being
+// rewritten just reads it again. Nothing is copied while no viewer is attached.
+// One game streams at a time, whichever claimed the stream first; the claim sits
+// in the segment, so it also holds across forked worker processes. A claim left by
+// a process that died is taken over by the next game to claim the stream.
+// POSIX only; the constructor throws elsewhere or when the segment cannot be made.
+class LiveStateExport {
+public:
+    static constexpr uint32_t SLOTS = 4;
+    static constexpr size_t DEFAULT_CELL_CAPACITY = 1 << 20;
+    static constexpr size_t TANK_CAPACITY = 1 << 12;
+
+    // name is the shm object name, "/tank_live" style. A segment of that name left over
+    // from an earlier run is replaced.
+    explicit LiveStateExport(const string& name, size_t cellCapacity = DEFAULT_CELL_CAPACITY);
+    ~LiveStateExport();
+    LiveStateExport(const LiveStateExport&) = delete;
+    LiveStateExport& operator=(const LiveStateExport&) = delete;
+
+    bool claim();    // True if the calling game now owns the stream
+    void release();  // Called by the owner when its game is over
+    bool hasViewers() const;
+
+    // Write the next frame; false if nobody watches or the board does not fit
+    bool publish(const string& mapName, int round, const vector<vector<char>>& board,
+                 const LiveTank* tanks, size_t tankCount);
+
+private:
+    string name;
+    void* memory;
+    size_t size;
+    size_t cellCapacity;
+    uint32_t game;  // Serial of the game holding the claim
+    bool warnedTooLarge;
+};
+
+// Reader side of a LiveStateExport segment
+class LiveStateView {
+public:
+    explicit LiveStateView(const string& name);
+    ~LiveStateView() { detach(); }
+    LiveStateView(const LiveStateView&) = delete;
+    LiveStateView& operator=(const LiveStateView&) = delete;
+
+    bool attach();  // False while there is no segment with a running writer
+    void detach();
+    bool attached() const { return memory != nullptr; }
+    bool writerClosed() const;  // The exporting process is gone and will publish nothing more
+
+    // Copy the latest frame if it is newer than frame.frame; false if there is none
+    bool poll(LiveFrame& frame);
+
+private:
+    string name;
+    void* memory;
+    size_t size;
+};
@@ -0,0 +1,632 @@
+#include "LockstepBatch.h"
+#include "GameRules.h"
+#include "OutputWriter.h"
+#include "TankTable.h"
+#include "../common/GameSatelliteView.h"
+#include "../constants/Directions.h"
+#include <algorithm>
+#include <exception>
+#include <stdexcept>
+
+using namespace BoardConstants;
+
+LockstepBatch::LockstepBatch() {}
+
+size_t LockstepBatch::addGame(const BoardData& board, PlayerFactory& playerFactory, TankAlgorithmFactory& algorithmFactory,
+                              uint32_t externalTeams) {
+    Game game;
+    game.playerFactory = &playerFactory;
+    game.algorithmFactory = &algorithmFactory;
+    game.externalTeams = externalTeams;
+    Setup setup = prepareGame(board, game);
+
+    size_t index = games.size();
+    game.firstTank = tankX.size();
+    games.push_back(std::move(game));
+
+    gameCellBase.push_back(cells.size());
+    gameColumns.push_back(static_cast<uint32_t>(board.columns));
+    gameRows.push_back(static_cast<uint32_t>(board.rows));
+    size_t cellCount = cells.size() + board.rows * board.columns;
+    cells.resize(cellCount);
+    roundStartCells.resize(cellCount);
+    cellHits.resize(cellCount, 0);
+    cellResolved.resize(cellCount, 0);
+    cellCollided.resize(cellCount, 0);
+    cellOwner.resize(cellCount, -1);
+
+    size_t tankCount = tankX.size() + setup.tanks.size();
+    tankGame.resize(tankCount, static_cast<uint32_t>(index));
+    tankTeam.resize(tankCount);
+    tankX.resize(tankCount);
+    tankY.resize(tankCount);
+    tankDirection.resize(tankCount);
+    tankAlive.resize(tankCount);
+    tankWasKilled.resize(tankCount);
+    tankCooldown.resize(tankCount);
+    tankShells.resize(tankCount);
+    tankMovingBackward.resize(tankCount);
+    tankBackwardCounter.resize(tankCount);
+    tankHasPrevious.resize(tankCount);
+    tankPreviousX.resize(tankCount);
+    tankPreviousY.resize(tankCount);
+    tankAlgorithm.resize(tankCount);
+
+    initGame(index, board, setup);
+    return index;
+}
+
+void LockstepBatch::resetGame(size_t game, const BoardData& board) {
+    Game& g = games[game];
+    size_t tanks = 0;
+    for (int team = 1; team <= MAX_TEAMS; team++) {
+        tanks += board.tankCount(team);
+    }
+    if (board.rows * board.columns != g.rows * g.columns || tanks != g.teamOrder.size()) {
+        throw runtime_error("LockstepBatch: a game can only be reset to a board of the same size with as many tanks");
+    }
+    Setup setup = prepareGame(board, g);
+
+    // Shells still in flight belong to the old game
+    active.erase(remove(active.begin(), active.end(), game), active.end());
+    g.finished = true;
+    dropShellsOfFinishedGames();
+
+    gameColumns[game] = static_cast<uint32_t>(board.columns);
+    gameRows[game] = static_cast<uint32_t>(board.rows);
+    initGame(game, board, setup);
+    if (checkStart(game)) {
+        active.push_back(game);
+    }
+}
+
+LockstepBatch::Setup LockstepBatch::prepareGame(const BoardData& board, const Game& game) {
+    Setup setup;
+    for (int team = 1; team <= board.numTeams; team++) {
+        setup.players.push_back(game.playerFactory->create(team, board.columns, board.rows, board.maxStep, board.numShells));
+    }
+    array<int, MAX_TEAMS + 1> nextTankIndex{};
+    for (size_t y = 0; y < board.rows; y++) {
+        for (size_t x = 0; x < board.columns; x++) {
+            char cell = board.board[y][x];
+            if (!isTankChar(cell)) {
+                continue;
+            }
+            int team = teamOf(cell);
+            setup.tanks.push_back({static_cast<uint32_t>(x), static_cast<uint32_t>(y), team});
+            // Tanks of external teams are driven by the caller
+            bool external = (game.externalTeams >> team) & 1u;
+            setup.algorithms.push_back(external ? TankAlgorithmPtr()
+                                                : game.algorithmFactory->createInArena(team, nextTankIndex[team], &arena));
+            nextTankIndex[team]++;
+        }
+    }
+    return setup;
+}
+
+void LockstepBatch::initGame(size_t index, const BoardData& board, Setup& setup) {
+    Game& game = games[index];
+    game.round = 0;
+    game.rows = board.rows;
+    game.columns = board.columns;
+    game.maxStep = board.maxStep;
+    game.numShells = board.numShells;
+    game.numTeams = board.numTeams;
+    game.players = std::move(setup.players);
+    game.snapshotRound = -1;
+    game.alive.fill(0);
+    game.shells.fill(0);
+    game.teamsAlive = 0;
+    game.totalShells = 0;
+    game.outOfShells = false;
+    game.roundsSinceNoShells = 0;
+    game.finished = false;
+    game.result = GameResult();
+    game.result.numTeams = board.numTeams;
+    game.error.clear();
+
+    char* row = cells.data() + gameCellBase[index];
+    for (const auto& boardRow : board.board) {
+        row = copy(boardRow.begin(), boardRow.end(), row);
+    }
+
+    array<vector<uint32_t>, MAX_TEAMS + 1> byTeam;
+    for (size_t i = 0; i < setup.tanks.size(); i++) {
+        const Setup::Tank& newTank = setup.tanks[i];
+        size_t tank = game.firstTank + i;
+        byTeam[newTank.team].push_back(static_cast<uint32_t>(tank));
+        tankTeam[tank] = newTank.team;
+        tankX[tank] = newTank.x;
+        tankY[tank] = newTank.y;
+        tankDirection[tank] = static_cast<uint8_t>(Directions::indexOf(startingDx(newTank.team), 0));
+        tankAlive[tank] = 1;
+        tankWasKilled[tank] = 0;
+        tankCooldown[tank] = 0;
+        tankShells[tank] = static_cast<int>(board.numShells);
+        tankMovingBackward[tank] = 0;
+        tankBackwardCounter[tank] = 0;
+        tankHasPrevious[tank] = 0;
+        tankPreviousX[tank] = 0;
+        tankPreviousY[tank] = 0;
+        tankAlgorithm[tank] = std::move(setup.algorithms[i]);
+    }
+    game.teamOrder.clear();
+    for (int team = 1; team <= MAX_TEAMS; team++) {
+        game.teamStart[team] = game.teamOrder.size();
+        game.teamOrder.insert(game.teamOrder.end(), byTeam[team].begin(), byTeam[team].end());
+    }
+    game.teamStart[MAX_TEAMS + 1] = game.teamOrder.size();
+
+    for (int team = 1; team <= board.numTeams; team++) {
+        game.alive[team] = static_cast<int>(board.tankCount(team));
+        game.shells[team] = static_cast<long>(board.tankCount(team) * board.numShells);
+        game.totalShells += game.shells[team];
+        if (game.alive[team] > 0) {
+            game.teamsAlive++;
+        }
+    }
+    game.dangerMap.reset(board.rows, board.columns);
+    game.reachability.reset(board.board);
+}
+
+bool LockstepBatch::checkStart(size_t game) {
+    if (!checkGameEnd(game) && games[game].maxStep == 0) {
+        finish(game, GameResult::Reason::MaxSteps, 0);
+    }
+    return !games[game].finished;
+}
+
+void LockstepBatch::run() {
+    start();
+    while (!active.empty()) {
+        playRound(nullptr);
+    }
+}
+
+void LockstepBatch::start() {
+    active.clear();
+    for (size_t game = 0; game < games.size(); game++) {
+        if (checkStart(game)) {
+            active.push_back(game);
+        }
+    }
+}
+
+void LockstepBatch::playRound(const ActionRequest* actions) {
+    kills.clear();
+    for (size_t game : active) {
+        games[game].round++;
+        size_t begin = gameCellBase[game];
+        size_t end = begin + games[game].rows * games[game].columns;
+        copy(cells.begin() + begin, cells.begin() + end, roundStartCells.begin() + begin);
+    }
+    beginRound();
+    moveShells();
+    moveShells();
+    refreshDangerMaps();
+
+    for (size_t game : active) {
+        try {
+            updateTanks(game, actions);
+        } catch (const exception& e) {
+            games[game].error = e.what();
+            games[game].finished = true;
+            continue;
+        }
+        checkTankSwapping(game);
+        if (!checkGameEnd(game) && static_cast<size_t>(games[game].round) >= games[game].maxStep) {
+            finish(game, GameResult::Reason::MaxSteps, 0);
+        }
+    }
+
+    size_t before = active.size();
+    active.erase(remove_if(active.begin(), active.end(), [this](size_t game) { return games[game].finished; }),
+                 active.end());
+    if (active.size() != before) {
+        dropShellsOfFinishedGames();
+    }
+}
+
+void LockstepBatch::beginRound() {
+    // Tanks of finished games are never read again, so every tank takes part
+    for (size_t i = 0; i < tankCooldown.size(); i++) {
+        tankWasKilled[i] = 0;
+        tankCooldown[i] -= tankCooldown[i] > 0;
+        tankBackwardCounter[i] += tankMovingBackward[i];
+        tankHasPrevious[i] = 0;
+    }
+}
+
+void LockstepBatch::moveShells() {
+    size_t count = shellX.size();
+    shellTarget.resize(count);
+
+    // The cell every shell moves into, and how many shells move into it.
+    // As in GameManager, shells only collide when they move into the same cell.
+    for (size_t i = 0; i < count; i++) {
+        size_t game = shellGame[i];
+        size_t x = Directions::wrapStep(shellX[i], Directions::dx(shellDirection[i]), gameColumns[game]);
+        size_t y = Directions::wrapStep(shellY[i], Directions::dy(shellDirection[i]), gameRows[game]);
+        size_t target = cellIndex(game, x, y);
+        shellTarget[i] = target;
+        cellHits[target] += cellHits[target] < 2;
+    }
+
+    // Shells leave their cells
+    for (size_t i = 0; i < count; i++) {
+        size_t cell = cellIndex(shellGame[i], shellX[i], shellY[i]);
+        cells[cell] = GameRules::cellLeftByShell(cells[cell]);
+    }
+
+    // Resolve every target cell once. Different cells don't affect each other, so the order is free.
+    for (size_t i = 0; i < count; i++) {
+        size_t target = shellTarget[i];
+        if (cellResolved[target]) {
+            continue;
+        }
+        cellResolved[target] = 1;
+        size_t game = shellGame[i];
+        size_t offset = target - gameCellBase[game];
+        uint32_t x = static_cast<uint32_t>(offset % gameColumns[game]);
+        uint32_t y = static_cast<uint32_t>(offset / gameColumns[game]);
+        char cell = cells[target];
+
+        if (cellHits[target] > 1) {
+            // Multiple shells destroy everything on the cell
+            if (isTankChar(cell)) {
+                killFirstTankAt(game, x, y);  // Not credited to any one shell
+            } else if (cell == WALL || cell == DAMAGED_WALL) {
+                games[game].dangerMap.markAll();
+            }
+            games[game].reachability.cellChanged(x, y, cell, EMPTY_SPACE);
+            cells[target] = EMPTY_SPACE;
+            cellCollided[target] = 1;
+            continue;
+        }
+
+        switch (GameRules::singleShellHit(cell)) {
+            case GameRules::ShellHit::Tank:
+                killFirstTankAt(game, x, y, shellOwner[i]);
+                cells[target] = EMPTY_SPACE;
+                cellCollided[target] = 1;
+                break;
+            case GameRules::ShellHit::Wall:
+                cells[target] = DAMAGED_WALL;
+                cellCollided[target] = 1;
+                break;
+            case GameRules::ShellHit::DamagedWall:
+                cells[target] = EMPTY_SPACE;
+                games[game].dangerMap.markAll();
+                games[game].reachability.openCell(x, y);
+                cellCollided[target] = 1;
+                break;
+            case GameRules::ShellHit::Mine:
+                cells[target] = MINE_SHELL_COLLISION;
+                break;
+            case GameRules::ShellHit::Empty:
+                cells[target] = SHELL;
+                break;
+            case GameRules::ShellHit::PassThrough:
+                break;
+        }
+    }
+
+    // Shells that collided are destroyed, the rest move on
+    size_t kept = 0;
+    for (size_t i = 0; i < count; i++) {
+        size_t game = shellGame[i];
+        size_t target = shellTarget[i];
+        if (cellCollided[target]) {
+            games[game].dangerMap.markShellPath(shellX[i], shellY[i], shellDirection[i], boardOf(game));
+            continue;
+        }
+        size_t offset = target - gameCellBase[game];
+        shellGame[kept] = shellGame[i];
+        shellX[kept] = static_cast<uint32_t>(offset % gameColumns[game]);
+        shellY[kept] = static_cast<uint32_t>(offset / gameColumns[game]);
+        shellDirection[kept] = shellDirection[i];
+        shellOwner[kept] = shellOwner[i];
+        games[game].dangerMap.markCell(shellX[kept], shellY[kept]);
+        kept++;
+    }
+    for (size_t i = 0; i < count; i++) {
+        size_t target = shellTarget[i];
+        cellHits[target] = 0;
+        cellResolved[target] = 0;
+        cellCollided[target] = 0;
+    }
+    shellGame.resize(kept);
+    shellX.resize(kept);
+    shellY.resize(kept);
+    shellDirection.resize(kept);
+    shellOwner.resize(kept);
+}
+
+void LockstepBatch::refreshDangerMaps() {
+    for (Game& game : games) {
+        if (!game.finished) {
+            game.dangerMap.clearMarked();
+        }
+    }
+    // Shells in flight also extend their horizon by two cells each round
+    for (size_t i = 0; i < shellX.size(); i++) {
+        size_t game = shellGame[i];
+        games[game].dangerMap.stampShell(shellX[i], shellY[i], shellDirection[i], games[game].round, boardOf(game));
+    }
+}
+
+void LockstepBatch::dropShellsOfFinishedGames() {
+    size_t kept = 0;
+    for (size_t i = 0; i < shellX.size(); i++) {
+        if (games[shellGame[i]].finished) {
+            continue;
+        }
+        shellGame[kept] = shellGame[i];
+        shellX[kept] = shellX[i];
+        shellY[kept] = shellY[i];
+        shellDirection[kept] = shellDirection[i];
+        shellOwner[kept] = shellOwner[i];
+        kept++;
+    }
+    shellGame.resize(kept);
+    shellX.resize(kept);
+    shellY.resize(kept);
+    shellDirection.resize(kept);
+    shellOwner.resize(kept);
+}
+
+void LockstepBatch::updateTanks(size_t game, const ActionRequest* actions) {
+    // Teams act in order, each team's tanks in creation order
+    const Game& g = games[game];
+    for (int team = 1; team <= g.numTeams; team++) {
+        for (size_t i = g.teamStart[team]; i < g.teamStart[team + 1]; i++) {
+            size_t tank = g.teamOrder[i];
+            // Tanks killed by a shell this round still get to choose an action
+            if (!tankAlive[tank] && !tankWasKilled[tank]) {
+                continue;
+            }
+            if (tankAlgorithm[tank]) {
+                applyAction(game, tank, tankAlgorithm[tank]->getAction());
+            } else {
+                applyAction(game, tank, actions ? actions[tank] : ActionRequest::DoNothing);
+            }
+        }
+    }
+}
+
+void LockstepBatch::applyAction(size_t game, size_t tank, ActionRequest action) {
+    if (!tankAlive[tank]) {
+        return;
+    }
+
+    // A tank in a backward movement sequence can only cancel it with a forward move
+    if (tankMovingBackward[tank]) {
+        if (action == ActionRequest::MoveForward) {
+            tankMovingBackward[tank] = 0;
+            tankBackwardCounter[tank] = 0;
+        }
+        return;
+    }
+
+    int direction = tankDirection[tank];
+    switch (action) {
+        case ActionRequest::MoveForward: {
+            uint32_t nextX = static_cast<uint32_t>(Directions::wrapStep(tankX[tank], Directions::dx(direction), gameColumns[game]));
+            uint32_t nextY = static_cast<uint32_t>(Directions::wrapStep(tankY[tank], Directions::dy(direction), gameRows[game]));
+            char nextCell = cells[cellIndex(game, nextX, nextY)];
+            if (!GameRules::blocksTank(nextCell)) {
+                driveTank(game, tank, nextX, nextY, nextCell);
+            }
+            break;
+        }
+
+        case ActionRequest::MoveBackward:
+            tankMovingBackward[tank] = 1;
+            tankBackwardCounter[tank] = 0;
+            if (tankBackwardCounter[tank] == 2) {
+                uint32_t nextX = static_cast<uint32_t>(Directions::wrapStep(tankX[tank], -Directions::dx(direction), gameColumns[game]));
+                uint32_t nextY = static_cast<uint32_t>(Directions::wrapStep(tankY[tank], -Directions::dy(direction), gameRows[game]));
+                char nextCell = cells[cellIndex(game, nextX, nextY)];
+                if (!GameRules::blocksTank(nextCell)) {
+                    driveTank(game, tank, nextX, nextY, nextCell);
+                }
+            }
+            break;
+
+        case ActionRequest::RotateLeft90:
+            tankDirection[tank] = static_cast<uint8_t>(Directions::rotate(direction, -2));
+            break;
+        case ActionRequest::RotateRight90:
+            tankDirection[tank] = static_cast<uint8_t>(Directions::rotate(direction, 2));
+            break;
+        case ActionRequest::RotateLeft45:
+            tankDirection[tank] = static_cast<uint8_t>(Directions::rotate(direction, -1));
+            break;
+        case ActionRequest::RotateRight45:
+            tankDirection[tank] = static_cast<uint8_t>(Directions::rotate(direction, 1));
+            break;
+
+        case ActionRequest::Shoot:
+            if (tankCooldown[tank] == 0 && tankShells[tank] > 0) {
+                addShell(game, tank);
+                tankCooldown[tank] = TankTable::SHOOT_COOLDOWN;
+                tankShells[tank]--;
+            }
+            break;
+
+        case ActionRequest::GetBattleInfo:
+            giveBattleInfo(game, tank);
+            break;
+
+        default:
+            break;
+    }
+}
+
+void LockstepBatch::driveTank(size_t game, size_t tank, uint32_t nextX, uint32_t nextY, char nextCell) {
+    uint32_t previousX = tankX[tank];
+    uint32_t previousY = tankY[tank];
+    tankHasPrevious[tank] = 1;
+    tankPreviousX[tank] = previousX;
+    tankPreviousY[tank] = previousY;
+    tankX[tank] = nextX;
+    tankY[tank] = nextY;
+    cells[cellIndex(game, previousX, previousY)] = cellLeftByTank(game, previousX, previousY);
+    cells[cellIndex(game, nextX, nextY)] = GameRules::cellEnteredByTank(nextCell, tankTeam[tank]);
+    games[game].reachability.cellChanged(nextX, nextY, nextCell, cells[cellIndex(game, nextX, nextY)]);
+}
+
+char LockstepBatch::cellLeftByTank(size_t game, uint32_t x, uint32_t y) const {
+    char cell = cells[cellIndex(game, x, y)];
+    if (isTankChar(cell)) {
+        return EMPTY_SPACE;
+    }
+    if (cell != TANK_TANK_COLLISION) {
+        return cell;
+    }
+    // The tanks still on the cell decide what it shows
+    int tankCount = 0;
+    int firstTeam = 0;
+    for (uint32_t tank : games[game].teamOrder) {
+        if (tankAlive[tank] && tankX[tank] == x && tankY[tank] == y && tankCount++ == 0) {
+            firstTeam = tankTeam[tank];
+        }
+    }
+    if (tankCount > 1) {
+        return TANK_TANK_COLLISION;
+    }
+    return tankCount == 1 ? tankChar(firstTeam) : EMPTY_SPACE;
+}
+
+void LockstepBatch::addShell(size_t game, size_t tank) {
+    shellGame.push_back(static_cast<uint32_t>(game));
+    shellX.push_back(tankX[tank]);
+    shellY.push_back(tankY[tank]);
+    shellDirection.push_back(tankDirection[tank]);
+    shellOwner.push_back(static_cast<int64_t>(tank));
+    games[game].dangerMap.stampShell(tankX[tank], tankY[tank], tankDirection[tank], games[game].round, boardOf(game));
+    games[game].shells[tankTeam[tank]]--;
+    games[game].totalShells--;
+}
+
+void LockstepBatch::giveBattleInfo(size_t game, size_t tank) {
+    Game& g = games[game];
+    if (!tankAlgorithm[tank]) {
+        return;  // External tanks see the board through the caller
+    }
+    // Algorithms see the board as it was at the start of the round
+    if (g.snapshotRound != g.round) {
+        g.roundStartBoard.resize(g.rows);
+        const char* row = roundStartCells.data() + gameCellBase[game];
+        for (size_t y = 0; y < g.rows; y++, row += g.columns) {
+            g.roundStartBoard[y].assign(row, row + g.columns);
+        }
+        g.snapshotRound = g.round;
+    }
+    GameSatelliteView satelliteView(g.roundStartBoard, g.rows, g.columns, tankX[tank], tankY[tank],
+                                    &g.dangerMap, g.round, &g.reachability);
+    g.players[tankTeam[tank] - 1]->updateTankWithBattleInfo(*tankAlgorithm[tank], satelliteView);
+}
+
+void LockstepBatch::killTank(size_t tank, int64_t shooter) {
+    Game& game = games[tankGame[tank]];
+    int team = tankTeam[tank];
+    tankAlive[tank] = 0;
+    tankWasKilled[tank] = 1;
+    kills.push_back({tank, shooter});
+    // The shells of a dead tank no longer count
+    game.shells[team] -= tankShells[tank];
+    game.totalShells -= tankShells[tank];
+    if (--game.alive[team] == 0) {
+        game.teamsAlive--;
+    }
+}
+
+void LockstepBatch::killFirstTankAt(size_t game, uint32_t x, uint32_t y, int64_t shooter) {
+    // The first living tank on the cell in team order is hit
+    for (uint32_t tank : games[game].teamOrder) {
+        if (tankAlive[tank] && tankX[tank] == x && tankY[tank] == y) {
+            killTank(tank, shooter);
+            return;
+        }
+    }
+}
+
+void LockstepBatch::checkTankSwapping(size_t game) {
+    const Game& g = games[game];
+    size_t end = g.firstTank + g.teamOrder.size();
+
+    // Owner of every occupied cell, the last living tank on it in team order
+    for (uint32_t tank : g.teamOrder) {
+        if (tankAlive[tank]) {
+            cellOwner[cellIndex(game, tankX[tank], tankY[tank])] = tank;
+        }
+    }
+
+    // A swap partner must own the cell this tank left, so there is at most one per tank
+    vector<pair<size_t, size_t>> swapped;
+    for (size_t i = g.firstTank; i < end; i++) {
+        if (!tankAlive[i] || !tankHasPrevious[i] || cellOwner[cellIndex(game, tankX[i], tankY[i])] != static_cast<int64_t>(i)) {
+            continue;
+        }
+        int64_t j = cellOwner[cellIndex(game, tankPreviousX[i], tankPreviousY[i])];
+        if (j <= static_cast<int64_t>(i)) {
+            continue;
+        }
+        if (tankHasPrevious[j] && tankPreviousX[j] == tankX[i] && tankPreviousY[j] == tankY[i]) {
+            swapped.push_back({i, static_cast<size_t>(j)});
+        }
+    }
+
+    for (uint32_t tank : g.teamOrder) {
+        cellOwner[cellIndex(game, tankX[tank], tankY[tank])] = -1;
+    }
+
+    // Both tanks of a swap are destroyed
+    for (const auto& [first, second] : swapped) {
+        killTank(first);
+        cells[cellIndex(game, tankX[first], tankY[first])] = EMPTY_SPACE;
+        killTank(second);
+        cells[cellIndex(game, tankX[second], tankY[second])] = EMPTY_SPACE;
+    }
+}
+
+bool LockstepBatch::checkGameEnd(size_t game) {
+    Game& g = games[game];
+    if (!g.outOfShells && g.totalShells == 0) {
+        g.outOfShells = true;
+        g.roundsSinceNoShells = 0;
+    }
+    if (g.outOfShells && ++g.roundsSinceNoShells >= OutputWriter::ZERO_SHELLS_STEPS) {
+        finish(game, GameResult::Reason::ZeroShells, 0);
+        return true;
+    }
+
+    if (g.teamsAlive == 0) {
+        finish(game, GameResult::Reason::AllTanksDead, 0);
+        return true;
+    }
+    if (g.teamsAlive == 1) {
+        int lastTeam = 0;
+        for (int team = g.numTeams; team >= 1 && lastTeam == 0; team--) {
+            if (g.alive[team] > 0) {
+                lastTeam = team;
+            }
+        }
+        finish(game, GameResult::Reason::AllTanksDead, lastTeam);
+        return true;
+    }
+    return false;
+}
+
+void LockstepBatch::finish(size_t game, GameResult::Reason reason, int winner) {
+    Game& g = games[game];
+    g.finished = true;
+    g.result.reason = reason;
+    g.result.winner = winner;
+    g.result.rounds = static_cast<size_t>(g.round);
+    g.result.numTeams = g.numTeams;
+    for (int team = 1; team <= g.numTeams; team++) {
+        g.result.teamTanks[team] = static_cast<size_t>(g.alive[team]);
+    }
+}
@@ -0,0 +1,183 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <vector>
+#include "GameManager.h"
+#include "ShellDangerMap.h"
+#include "ReachabilityMap.h"
+#include "BoardReader.h"
+#include "../common/Player.h"
+#include "../common/PlayerFactory.h"
+#include "../common/TankAlgorithmFactory.h"
+#include "../constants/BoardConstants.h"
+
+using namespace std;
+
+// Plays many independent games in lockstep, one phase of a round for all of them
+// before the next. The boards, tanks and shells of all games sit side by side in
+// flat arrays, so beginning a round and moving and resolving shells are single
+// passes over every game at once; only the algorithms are asked game by game.
+// Results are the same as playing each board with its own GameManager. No output,
+// statistics or events are written and cycles are not fast-forwarded.
+// Tanks of external teams have no algorithm; their actions are passed to playRound().
+class LockstepBatch {
+public:
+    // A tank killed during the last round, and the tank whose shell killed it (-1 if none did alone)
+    struct Kill {
+        size_t tank;
+        int64_t shooter;
+    };
+
+    LockstepBatch();
+
+    // The factories are not owned and must outlive the batch. externalTeams has bit k set
+    // for every team k driven from outside. Returns the game's index.
+    size_t addGame(const BoardData& board, PlayerFactory& playerFactory, TankAlgorithmFactory& algorithmFactory,
+                   uint32_t externalTeams = 0);
+    size_t size() const { return games.size(); }
+
+    void run();  // Play every game to its end
+
+    // The same one round at a time: start() checks the games that end before the first
+    // round, then every playRound() plays one round of all unfinished games. actions
+    // holds one entry per tank of the batch, numbered as below, and is only read for tanks
+    // of external teams; it may be null when there are none.
+    void start();
+    void playRound(const ActionRequest* actions);
+    bool allFinished() const { return active.empty(); }
+    const vector<Kill>& lastRoundKills() const { return kills; }
+
+    // Start the game over on a board of the same size with as many tanks, in place
+    void resetGame(size_t game, const BoardData& board);
+
+    bool isFinished(size_t game) const { return games[game].finished; }
+    int getRound(size_t game) const { return games[game].round; }
+    const GameResult& getResult(size_t game) const { return games[game].result; }
+    // Why the game was abandoned, empty unless one of its algorithms threw
+    const string& getError(size_t game) const { return games[game].error; }
+
+    // Tanks of all games are numbered together, each game's in creation order
+    size_t tankCount() const { return tankX.size(); }
+    size_t firstTank(size_t game) const { return games[game].firstTank; }
+    size_t tankCount(size_t game) const { return games[game].teamOrder.size(); }
+
+private:
+    friend class TankEnv;
+
+    // Cold per-game data; everything the round passes touch is in the flat arrays below
+    struct Game {
+        PlayerFactory* playerFactory = nullptr;
+        TankAlgorithmFactory* algorithmFactory = nullptr;
+        uint32_t externalTeams = 0;
+        int round = 0;
+        size_t rows = 0;
+        size_t columns = 0;
+        size_t maxStep = 0;
+        size_t numShells = 0;
+        int numTeams = 0;
+        size_t firstTank = 0;              // Tanks are firstTank.. in creation order
+        vector<uint32_t> teamOrder;        // Tank indices grouped by team, each team in creation order
+        array<size_t, BoardConstants::MAX_TEAMS + 2> teamStart{};
+        vector<unique_ptr<Player>> players;  // Player of team k at k - 1
+        ShellDangerMap dangerMap;
+        ReachabilityMap reachability;
+        vector<vector<char>> roundStartBoard;  // Built from the snapshot when an algorithm asks for it
+        int snapshotRound = -1;
+
+        // Team tallies for the end checks
+        array<int, BoardConstants::MAX_TEAMS + 1> alive{};
+        array<long, BoardConstants::MAX_TEAMS + 1> shells{};
+        int teamsAlive = 0;
+        long totalShells = 0;
+        bool outOfShells = false;
+        int roundsSinceNoShells = 0;
+
+        bool finished = false;
+        GameResult result;
+        string error;
+    };
+
+    // Algorithms of all games are allocated here; declared first so it outlives them.
+    // A pool, as games that are reset give their algorithms' memory back.
+    pmr::unsynchronized_pool_resource arena;
+    vector<Game> games;
+    vector<size_t> active;  // Unfinished games
+    vector<Kill> kills;
+
+    // Per game, read by the round passes
+    vector<size_t> gameCellBase;  // Offset of the game's board in cells
+    vector<uint32_t> gameColumns;
+    vector<uint32_t> gameRows;
+
+    // Boards of all games, row-major one after another
+    vector<char> cells;
+    vector<char> roundStartCells;
+
+    // Tanks of all games, each game's tanks together in creation order
+    vector<uint32_t> tankGame;
+    vector<int> tankTeam;
+    vector<uint32_t> tankX;
+    vector<uint32_t> tankY;
+    vector<uint8_t> tankDirection;
+    vector<uint8_t> tankAlive;
+    vector<uint8_t> tankWasKilled;  // Killed this round
+    vector<int> tankCooldown;
+    vector<int> tankShells;
+    vector<uint8_t> tankMovingBackward;
+    vector<int> tankBackwardCounter;
+    vector<uint8_t> tankHasPrevious;
+    vector<uint32_t> tankPreviousX;
+    vector<uint32_t> tankPreviousY;
+    vector<TankAlgorithmPtr> tankAlgorithm;  // Null for tanks of external teams
+
+    // Shells in flight in all games, in firing order
+    vector<uint32_t> shellGame;
+    vector<uint32_t> shellX;
+    vector<uint32_t> shellY;
+    vector<uint8_t> shellDirection;
+    vector<int64_t> shellOwner;  // Tank that fired it
+
+    // Scratch, kept zeroed (or -1) between uses
+    vector<size_t> shellTarget;   // Cell each shell moves into
+    vector<uint8_t> cellHits;     // Shells moving into each cell, saturated at 2
+    vector<uint8_t> cellResolved;
+    vector<uint8_t> cellCollided; // Shells moving into the cell are destroyed
+    vector<int64_t> cellOwner;    // Tank owning each cell during the swap check, -1 for none
+
+    // Everything a game needs that may fail to be created, made before any slot is touched
+    struct Setup {
+        struct Tank { uint32_t x, y; int team; };
+        vector<unique_ptr<Player>> players;
+        vector<Tank> tanks;  // In board order, which is the creation order GameManager uses
+        vector<TankAlgorithmPtr> algorithms;
+    };
+    Setup prepareGame(const BoardData& board, const Game& game);
+    void initGame(size_t game, const BoardData& board, Setup& setup);  // Fill the game's existing slots
+    bool checkStart(size_t game);  // The checks before the first round; true if the game goes on
+
+    size_t cellIndex(size_t game, size_t x, size_t y) const { return gameCellBase[game] + y * gameColumns[game] + x; }
+    BoardRows boardOf(size_t game) const { return BoardRows{cells.data() + gameCellBase[game], gameColumns[game]}; }
+
+    // Round phases over all unfinished games
+    void beginRound();
+    void moveShells();
+    void refreshDangerMaps();
+    void dropShellsOfFinishedGames();
+
+    // Per game
+    void updateTanks(size_t game, const ActionRequest* actions);
+    void applyAction(size_t game, size_t tank, ActionRequest action);
+    void driveTank(size_t game, size_t tank, uint32_t nextX, uint32_t nextY, char nextCell);
+    char cellLeftByTank(size_t game, uint32_t x, uint32_t y) const;
+    void addShell(size_t game, size_t tank);
+    void giveBattleInfo(size_t game, size_t tank);
+    void killTank(size_t tank, int64_t shooter = -1);
+    void killFirstTankAt(size_t game, uint32_t x, uint32_t y, int64_t shooter = -1);
+    void checkTankSwapping(size_t game);
+    bool checkGameEnd(size_t game);
+    void finish(size_t game, GameResult::Reason reason, int winner);
+};
@@ -0,0 +1,106 @@
+#include "MatchStats.h"
+#include "TypeName.h"
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <stdexcept>
+#include <typeinfo>
+
+string algorithmName(const TankAlgorithm& algorithm) {
+    return demangledName(typeid(algorithm));
+}
+
+namespace {
+    double ratio(int part, int whole) {
+        return whole > 0 ? static_cast<double>(part) / whole : 0.0;
+    }
+}
+
+MatchStats::MatchStats() : shellCollisions(0) {}
+
+void MatchStats::reset() {
+    tanks.clear();
+    shellCollisions = 0;
+}
+
+void MatchStats::addTank(int player, const TankAlgorithm& algorithm) {
+    TankStats stats;
+    stats.player = player;
+    stats.algorithm = algorithmName(algorithm);
+    tanks.push_back(stats);
+}
+
+void MatchStats::onGameEvent(const GameEvent& event) {
+    TankStats* tank = tankAt(event.tank);
+    TankStats* other = tankAt(event.otherTank);
+    switch (event.type) {
+        case GameEvent::Type::ShellFired:
+            if (tank) tank->shots++;
+            break;
+        case GameEvent::Type::TankKilled:
+            if (other) other->hits++;
+            break;
+        case GameEvent::Type::WallDamaged:
+        case GameEvent::Type::WallDestroyed:
+            if (other) other->wallHits++;
+            break;
+        case GameEvent::Type::MineTriggered:
+            if (tank) tank->mineTriggers++;
+            break;
+        case GameEvent::Type::ShellsCollided:
+            shellCollisions++;
+            break;
+        case GameEvent::Type::TanksCollided:
+            if (tank) tank->collisions++;
+            break;
+        case GameEvent::Type::TanksSwapped:
+            if (tank) tank->swaps++;
+            if (other) other->swaps++;
+            break;
+        case GameEvent::Type::ActionTaken:
+            if (tank) tank->actions++;
+            break;
+        case GameEvent::Type::ActionIgnored:
+            if (tank) tank->ignored++;
+            break;
+    }
+}
+
+void MatchStats::write(const string& fileName) const {
+    ofstream file(fileName);
+    if (!file.is_open()) {
+        throw runtime_error("Could not open stats file: " + fileName);
+    }
+    file << fixed << setprecision(3);
+
+    file << "tank,player,algorithm,shots,hits,accuracy,wall_hits,mine_triggers,collisions,swaps,actions,ignored,ignored_rate\n";
+    for (size_t i = 0; i < tanks.size(); i++) {
+        const TankStats& t = tanks[i];
+        file << i << ',' << t.player << ',' << t.algorithm << ',' << t.shots << ',' << t.hits << ','
+             << ratio(t.hits, t.shots) << ',' << t.wallHits << ',' << t.mineTriggers << ',' << t.collisions << ','
+             << t.swaps << ',' << t.actions << ',' << t.ignored << ',' << ratio(t.ignored, t.actions) << '\n';
+    }
+
+    // Same counters summed per algorithm
+    map<string, TankStats> byAlgorithm;
+    map<string, int> tankCounts;
+    for (const TankStats& t : tanks) {
+        TankStats& sum = byAlgorithm[t.algorithm];
+        sum.shots += t.shots;
+        sum.hits += t.hits;
+        sum.wallHits += t.wallHits;
+        sum.mineTriggers += t.mineTriggers;
+        sum.collisions += t.collisions;
+        sum.swaps += t.swaps;
+        sum.actions += t.actions;
+        sum.ignored += t.ignored;
+        tankCounts[t.algorithm]++;
+    }
+    file << "\nalgorithm,tanks,shots,hits,accuracy,wall_hits,mine_triggers,collisions,swaps,actions,ignored,ignored_rate\n";
+    for (const auto& [name, t] : byAlgorithm) {
+        file << name << ',' << tankCounts[name] << ',' << t.shots << ',' << t.hits << ',' << ratio(t.hits, t.shots) << ','
+             << t.wallHits << ',' << t.mineTriggers << ',' << t.collisions << ',' << t.swaps << ','
+             << t.actions << ',' << t.ignored << ',' << ratio(t.ignored, t.actions) << '\n';
+    }
+    file << "\nshell_collisions," << shellCollisions << '\n';
+}
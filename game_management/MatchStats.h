@@ -0,0 +1,44 @@
+#pragma once
+#include <string>
+#include <vector>
+#include "GameEvents.h"
+#include "../common/TankAlgorithm.h"
+
+using namespace std;
+
+// Demangled class name of an algorithm, used to group tanks by algorithm
+string algorithmName(const TankAlgorithm& algorithm);
+
+// Combat counters of one tank
+struct TankStats {
+    int player = 0;
+    string algorithm;
+    int shots = 0;         // Shells fired
+    int hits = 0;          // Tanks killed by a shell of this tank alone
+    int wallHits = 0;      // Shells of this tank spent on walls
+    int mineTriggers = 0;  // Times this tank drove onto a mine
+    int collisions = 0;    // Times this tank drove onto another tank
+    int swaps = 0;         // Swaps this tank died in
+    int actions = 0;       // Actions played while alive
+    int ignored = 0;       // Of those, actions that were ignored
+};
+
+// Per-tank and per-algorithm combat statistics of a match, counted from the event
+// stream while the match runs and written to a small CSV-style file at the end.
+class MatchStats : public GameEventListener {
+private:
+    vector<TankStats> tanks;  // Indexed by creation order
+    int shellCollisions;
+
+    TankStats* tankAt(int index) { return index >= 0 && index < static_cast<int>(tanks.size()) ? &tanks[index] : nullptr; }
+
+public:
+    MatchStats();
+
+    void reset();
+    void addTank(int player, const TankAlgorithm& algorithm);  // Register tanks in creation order
+    void onGameEvent(const GameEvent& event) override;
+
+    const vector<TankStats>& getTanks() const { return tanks; }
+    void write(const string& fileName) const;
+};
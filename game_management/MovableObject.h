@@ -3,37 +3,56 @@
 #include <utility>
 #include <cstddef>  // for size_t
 #include <optional>
-#include <vector>
+#include <tuple>
+#include "../constants/Directions.h"
 
+// Position and direction of an object moving on the wrapping board. Not polymorphic:
+// stepping and rotating are table lookups that inline into the game loop.
 class MovableObject {
 protected:
     size_t x;
     size_t y;
-    std::array<int, 2> direction;  // [x, y] direction vector
+    int direction;  // Index into Directions::VECTORS
     size_t boardWidth;
     size_t boardHeight;
     std::optional<std::pair<size_t, size_t>> previousPosition;  // Store previous position for swap detection
 
+    ~MovableObject() = default;
+
 public:
     MovableObject(size_t x, size_t y, size_t width, size_t height);
-    virtual ~MovableObject() = default;
 
     // Getters
-    size_t getX() const;
-    size_t getY() const;
-    const std::array<int, 2>& getDirection() const;
+    size_t getX() const { return x; }
+    size_t getY() const { return y; }
+    const std::array<int, 2>& getDirection() const { return Directions::VECTORS[direction]; }
+    int getDirectionIndex() const { return direction; }
     std::optional<std::pair<size_t, size_t>> getPreviousPosition() const { return previousPosition; }
     void clearPreviousPosition() { previousPosition = std::nullopt; }
 
     // Movement methods
-    virtual void move();
-    virtual void moveBackwards();
-    virtual std::pair<size_t, size_t> getPotentialMove() const;
-    virtual std::pair<size_t, size_t> getPotentialMoveBackwards() const;
-    virtual void setPosition(size_t newX, size_t newY);
+    void move() {
+        // Store current position before moving
+        previousPosition = {x, y};
+        std::tie(x, y) = getPotentialMove();
+    }
+    void moveBackwards() {
+        // Store current position before moving
+        previousPosition = {x, y};
+        std::tie(x, y) = getPotentialMoveBackwards();
+    }
+    std::pair<size_t, size_t> getPotentialMove() const {
+        return {Directions::wrapStep(x, Directions::dx(direction), boardWidth),
+                Directions::wrapStep(y, Directions::dy(direction), boardHeight)};
+    }
+    std::pair<size_t, size_t> getPotentialMoveBackwards() const {
+        return {Directions::wrapStep(x, -Directions::dx(direction), boardWidth),
+                Directions::wrapStep(y, -Directions::dy(direction), boardHeight)};
+    }
+    void setPosition(size_t newX, size_t newY) { x = newX; y = newY; }
 
     // Direction methods
-    virtual void setDirection(int dx, int dy);
-    virtual void rotate90(bool clockwise);
-    virtual void rotate45(bool clockwise);
+    void setDirection(int dx, int dy);
+    void rotate90(bool clockwise) { direction = Directions::rotate(direction, clockwise ? 2 : -2); }
+    void rotate45(bool clockwise) { direction = Directions::rotate(direction, clockwise ? 1 : -1); }
 }; 
\ No newline at end of file
@@ -1,7 +1,7 @@
 #include "OutputWriter.h"
 #include <iostream>
 
-OutputWriter::OutputWriter(const std::string& fileName) {
+OutputWriter::OutputWriter(const std::string& fileName, int numPlayers) : numPlayers(numPlayers) {
     outputFile.open(fileName);
     if (!outputFile.is_open()) {
         throw std::runtime_error("Could not open output file: " + fileName);
@@ -99,20 +99,22 @@ void OutputWriter::writeOutputFile() {
 
 void OutputWriter::writeGameEnd(int winner, int remainingTanks) {
     if (winner == 0) {
-        outputFile << "Tie, both players have zero tanks" << std::endl;
+        outputFile << "Tie, " << allPlayers() << " have zero tanks" << std::endl;
     } else {
         outputFile << "Player " << winner << " won with " << remainingTanks << " tanks still alive" << std::endl;
     }
 }
 
-void OutputWriter::writeMaxStepsTie(int maxSteps, int player1Tanks, int player2Tanks) {
-    outputFile << "Tie, reached max steps = " << maxSteps 
-               << ", player 1 has " << player1Tanks 
-               << " tanks, player 2 has " << player2Tanks << " tanks" << std::endl;
+void OutputWriter::writeMaxStepsTie(int maxSteps, const std::vector<int>& playerTanks) {
+    outputFile << "Tie, reached max steps = " << maxSteps;
+    for (size_t i = 0; i < playerTanks.size(); i++) {
+        outputFile << ", player " << i + 1 << " has " << playerTanks[i] << " tanks";
+    }
+    outputFile << std::endl;
 }
 
 void OutputWriter::writeZeroShellsTie() {
-    outputFile << "Tie, both players have zero shells for <" << ZERO_SHELLS_STEPS << "> steps" << std::endl;
+    outputFile << "Tie, " << allPlayers() << " have zero shells for <" << ZERO_SHELLS_STEPS << "> steps" << std::endl;
 }
 
 void OutputWriter::writeCurrentRound() {
@@ -133,4 +135,27 @@ void OutputWriter::writeCurrentRound() {
     }
     
     writeRoundToFile(currentRound);
-} 
\ No newline at end of file
+}
+
+bool OutputWriter::roundsMatch(size_t firstRound, size_t secondRound) const {
+    for (const auto& history : tankHistory) {
+        if (firstRound >= history.size() || secondRound >= history.size()) {
+            return false;
+        }
+        const RoundInfo& a = history[firstRound];
+        const RoundInfo& b = history[secondRound];
+        if (a.isAlive != b.isAlive || a.action != b.action ||
+            a.wasActionIgnored != b.wasActionIgnored || a.wasKilled != b.wasKilled) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void OutputWriter::repeatRound(size_t sourceRound) {
+    for (auto& history : tankHistory) {
+        if (sourceRound < history.size()) {
+            history.push_back(history[sourceRound]);
+        }
+    }
+}
@@ -9,6 +9,7 @@
 class OutputWriter {
 private:
     std::ofstream outputFile;
+    int numPlayers;  // Two player games keep their "both players" wording
     
     // 2D vector matrix to store tank history
     // First dimension: tank ID
@@ -17,9 +18,10 @@ private:
 
     void writeRoundToFile(const std::vector<RoundInfo>& currentRound);
     std::string actionToString(ActionRequest action) const;
+    const char* allPlayers() const { return numPlayers == 2 ? "both players" : "all players"; }
 
 public:
-    OutputWriter(const std::string& fileName);
+    OutputWriter(const std::string& fileName, int numPlayers = 2);
     ~OutputWriter();
 
     static constexpr int ZERO_SHELLS_STEPS = 40;
@@ -27,9 +29,13 @@ public:
     void addRoundForTank(int tankId, const RoundInfo& info);
     void writeOutputFile();
     void writeCurrentRound();
+
+    // Cycle support: compare two logged rounds, and log a copy of an earlier round
+    bool roundsMatch(size_t firstRound, size_t secondRound) const;
+    void repeatRound(size_t sourceRound);
     
     // Game end conditions
     void writeGameEnd(int winner, int remainingTanks);
-    void writeMaxStepsTie(int maxSteps, int player1Tanks, int player2Tanks);
+    void writeMaxStepsTie(int maxSteps, const std::vector<int>& playerTanks);  // Tanks of player k at k - 1
     void writeZeroShellsTie();
 }; 
\ No newline at end of file
@@ -0,0 +1,65 @@
+#include "ReachabilityMap.h"
+#include <utility>
+#include "../constants/Directions.h"
+
+ReachabilityMap::ReachabilityMap() : rows(0), columns(0), components(0) {}
+
+void ReachabilityMap::reset(const vector<vector<char>>& board) {
+    rows = board.size();
+    columns = rows > 0 ? board[0].size() : 0;
+    parent.resize(rows * columns);
+    componentSize.assign(rows * columns, 1);
+    open.assign(rows * columns, false);
+    components = 0;
+    for (size_t cell = 0; cell < parent.size(); cell++) {
+        parent[cell] = static_cast<uint32_t>(cell);
+    }
+
+    for (size_t y = 0; y < rows; y++) {
+        for (size_t x = 0; x < columns; x++) {
+            if (!blocksPath(board[y][x])) {
+                openCell(x, y);
+            }
+        }
+    }
+}
+
+uint32_t ReachabilityMap::find(uint32_t cell) const {
+    // Path halving
+    while (parent[cell] != cell) {
+        parent[cell] = parent[parent[cell]];
+        cell = parent[cell];
+    }
+    return cell;
+}
+
+void ReachabilityMap::join(size_t a, size_t b) {
+    if (!open[a] || !open[b]) {
+        return;
+    }
+    uint32_t rootA = find(static_cast<uint32_t>(a));
+    uint32_t rootB = find(static_cast<uint32_t>(b));
+    if (rootA == rootB) {
+        return;
+    }
+    // Union by size
+    if (componentSize[rootA] < componentSize[rootB]) {
+        swap(rootA, rootB);
+    }
+    parent[rootB] = rootA;
+    componentSize[rootA] += componentSize[rootB];
+    components--;
+}
+
+void ReachabilityMap::openCell(size_t x, size_t y) {
+    if (open[index(x, y)]) {
+        return;
+    }
+    open[index(x, y)] = true;
+    components++;
+    for (int direction = 0; direction < Directions::COUNT; direction++) {
+        size_t nextX = Directions::wrapStep(x, Directions::dx(direction), columns);
+        size_t nextY = Directions::wrapStep(y, Directions::dy(direction), rows);
+        join(index(x, y), index(nextX, nextY));
+    }
+}
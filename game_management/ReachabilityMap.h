@@ -0,0 +1,52 @@
+#pragma once
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include "../constants/BoardConstants.h"
+#include "../common/BoardForecast.h"
+
+using namespace std;
+
+// Connected components of the cells a tank can drive through without shooting,
+// moving to any of the 8 neighbours across the wrapping edges.
+// Walls and mines are only ever removed, never placed, so components only merge:
+// they are kept in a union-find and every opened cell is one union per open neighbour.
+// Tanks and shells don't block, as they move on.
+class ReachabilityMap final : public ComponentIndex {
+private:
+    size_t rows;
+    size_t columns;
+    mutable vector<uint32_t> parent;  // Shortened on every find, even from const queries
+    vector<uint32_t> componentSize;   // Valid for roots only
+    vector<bool> open;
+    size_t components;                // Over open cells only
+
+    size_t index(size_t x, size_t y) const { return y * columns + x; }
+    uint32_t find(uint32_t cell) const;
+    void join(size_t a, size_t b);
+
+public:
+    static constexpr int NO_COMPONENT = -1;
+
+    // Mines stay in place under a shell flying over them
+    static bool blocksPath(char cell) {
+        return cell == BoardConstants::WALL || cell == BoardConstants::DAMAGED_WALL ||
+               cell == BoardConstants::MINE || cell == BoardConstants::MINE_SHELL_COLLISION;
+    }
+
+    ReachabilityMap();
+
+    void reset(const vector<vector<char>>& board);
+    void openCell(size_t x, size_t y);  // A wall fell or a mine went off
+    // Call for every cell written; opens it when it no longer blocks
+    void cellChanged(size_t x, size_t y, char before, char after) {
+        if (blocksPath(before) && !blocksPath(after)) {
+            openCell(x, y);
+        }
+    }
+
+    // Cells with the same component are connected. A blocked cell is alone in its own.
+    int componentOf(size_t x, size_t y) const override { return static_cast<int>(find(static_cast<uint32_t>(index(x, y)))); }
+    bool connected(size_t x1, size_t y1, size_t x2, size_t y2) const { return componentOf(x1, y1) == componentOf(x2, y2); }
+    size_t componentCount() const { return components; }
+};
@@ -0,0 +1,100 @@
+#include "ResultCache.h"
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+namespace {
+    // 64-bit FNV-1a
+    const uint64_t FNV_OFFSET = 0xCBF29CE484222325ULL;
+    const uint64_t FNV_PRIME = 0x100000001B3ULL;
+
+    void hashBytes(uint64_t& hash, const void* data, size_t size) {
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < size; i++) {
+            hash = (hash ^ bytes[i]) * FNV_PRIME;
+        }
+    }
+
+    void hashValue(uint64_t& hash, uint64_t value) {
+        hashBytes(hash, &value, sizeof(value));
+    }
+}
+
+ResultCache::ResultCache(const string& fileName) : fileName(fileName) {
+    load();
+}
+
+uint64_t ResultCache::key(const BoardData& board, const string& versionTag) {
+    // The map name is only a description and does not affect the game
+    uint64_t hash = FNV_OFFSET;
+    hashValue(hash, board.rows);
+    hashValue(hash, board.columns);
+    hashValue(hash, board.maxStep);
+    hashValue(hash, board.numShells);
+    for (const auto& row : board.board) {
+        hashBytes(hash, row.data(), row.size());
+    }
+    hashValue(hash, versionTag.size());
+    hashBytes(hash, versionTag.data(), versionTag.size());
+    return hash;
+}
+
+void ResultCache::load() {
+    ifstream file(fileName);
+    if (!file.is_open()) {
+        return;  // Nothing cached yet
+    }
+    string line;
+    while (getline(file, line)) {
+        istringstream fields(line);
+        uint64_t entryKey;
+        int reason;
+        GameResult result;
+        if (!(fields >> hex >> entryKey >> dec >> reason >> result.winner >> result.rounds >> result.numTeams) ||
+            result.numTeams < 0 || result.numTeams > BoardConstants::MAX_TEAMS) {
+            std::cerr << "ResultCache: Skipping malformed line in " << fileName << std::endl;
+            continue;
+        }
+        result.reason = static_cast<GameResult::Reason>(reason);
+        bool complete = true;
+        for (int team = 1; team <= result.numTeams && complete; team++) {
+            complete = static_cast<bool>(fields >> result.teamTanks[team]);
+        }
+        if (complete) {
+            results[entryKey] = result;
+        }
+    }
+}
+
+bool ResultCache::lookup(uint64_t key, GameResult& result) const {
+    lock_guard<mutex> guard(lock);
+    auto it = results.find(key);
+    if (it == results.end()) {
+        return false;
+    }
+    result = it->second;
+    return true;
+}
+
+void ResultCache::store(uint64_t key, const GameResult& result) {
+    lock_guard<mutex> guard(lock);
+    if (!results.emplace(key, result).second) {
+        return;
+    }
+    ofstream file(fileName, ios::app);
+    if (!file.is_open()) {
+        std::cerr << "ResultCache: Could not write " << fileName << std::endl;
+        return;
+    }
+    file << hex << key << dec << ' ' << static_cast<int>(result.reason) << ' ' << result.winner << ' '
+         << result.rounds << ' ' << result.numTeams;
+    for (int team = 1; team <= result.numTeams; team++) {
+        file << ' ' << result.teamTanks[team];
+    }
+    file << '\n';
+}
+
+size_t ResultCache::size() const {
+    lock_guard<mutex> guard(lock);
+    return results.size();
+}
@@ -0,0 +1,32 @@
+#pragma once
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include "BoardReader.h"
+#include "GameManager.h"
+
+using namespace std;
+
+// On-disk memo of game results. A game is fully determined by its parsed board
+// and the algorithms playing it, so a result is keyed by a hash of the board's
+// dimensions, limits and cells together with a version tag of the algorithms.
+// Entries are appended to the file as they are stored, one line per game.
+// Safe to share between the games of a batch.
+class ResultCache {
+public:
+    explicit ResultCache(const string& fileName);
+
+    static uint64_t key(const BoardData& board, const string& versionTag);
+
+    bool lookup(uint64_t key, GameResult& result) const;
+    void store(uint64_t key, const GameResult& result);
+    size_t size() const;
+
+private:
+    string fileName;
+    mutable mutex lock;
+    unordered_map<uint64_t, GameResult> results;
+
+    void load();
+};
@@ -1,7 +1,7 @@
 #include "Shell.h"
 
-Shell::Shell(size_t x, size_t y, int dx, int dy, size_t width, size_t height)
-    : MovableObject(x, y, width, height) {
+Shell::Shell(size_t x, size_t y, int dx, int dy, size_t width, size_t height, int owner)
+    : MovableObject(x, y, width, height), owner(owner) {
     // Set the initial direction
     setDirection(dx, dy);
 } 
\ No newline at end of file
@@ -1,8 +1,13 @@
 #pragma once
 #include "MovableObject.h"
 
-class Shell : public MovableObject {
+class Shell final : public MovableObject {
+private:
+    int owner;  // Creation order of the tank that fired it, -1 if unknown
+
 public:
     // Constructor takes initial position, direction, and board dimensions
-    Shell(size_t x, size_t y, int dx, int dy, size_t width, size_t height);
+    Shell(size_t x, size_t y, int dx, int dy, size_t width, size_t height, int owner = -1);
+
+    int getOwner() const { return owner; }
 }; 
\ No newline at end of file
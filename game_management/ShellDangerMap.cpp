@@ -0,0 +1,106 @@
+#include "ShellDangerMap.h"
+#include <algorithm>
+#include "../constants/BoardConstants.h"
+
+using namespace BoardConstants;
+
+ShellDangerMap::ShellDangerMap() : rows(0), columns(0), allDirty(false) {}
+
+void ShellDangerMap::reset(size_t newRows, size_t newColumns) {
+    rows = newRows;
+    columns = newColumns;
+    arrivalRound.assign(rows * columns, NO_SHELL);
+    dirty.assign(rows * columns, false);
+    dirtyCells.clear();
+    allDirty = false;
+}
+
+template <typename Board, typename Visitor>
+void ShellDangerMap::walkShellPath(size_t x, size_t y, int direction, const Board& board, Visitor visit) const {
+    int dx = Directions::dx(direction);
+    int dy = Directions::dy(direction);
+
+    for (int step = 1; step <= 2 * HORIZON_ROUNDS; step++) {
+        x = (x + columns + dx) % columns;
+        y = (y + rows + dy) % rows;
+        char cell = board[y][x];
+        if (cell == WALL || cell == DAMAGED_WALL) {
+            break;  // The shell is destroyed on the wall
+        }
+        visit(index(x, y), step);
+    }
+}
+
+template <typename Board>
+void ShellDangerMap::stampShell(size_t x, size_t y, int direction, int round, const Board& board) {
+    // A shell sitting in its cell at the end of `round` covers steps 1-2 in the next round, 3-4 after that...
+    walkShellPath(x, y, direction, board, [&](size_t cell, int step) {
+        arrivalRound[cell] = min(arrivalRound[cell], round + (step + 1) / 2);
+    });
+}
+
+template <typename Board>
+void ShellDangerMap::markShellPath(size_t x, size_t y, int direction, const Board& board) {
+    walkShellPath(x, y, direction, board, [&](size_t cell, int /*step*/) {
+        if (!dirty[cell]) {
+            dirty[cell] = true;
+            dirtyCells.push_back(cell);
+        }
+    });
+}
+
+void ShellDangerMap::addShell(const Shell& shell, int round, const vector<vector<char>>& board) {
+    stampShell(shell.getX(), shell.getY(), shell.getDirectionIndex(), round, board);
+}
+
+void ShellDangerMap::markShellPath(const Shell& shell, const vector<vector<char>>& board) {
+    markShellPath(shell.getX(), shell.getY(), shell.getDirectionIndex(), board);
+}
+
+void ShellDangerMap::markCell(size_t x, size_t y) {
+    size_t cell = index(x, y);
+    if (!dirty[cell]) {
+        dirty[cell] = true;
+        dirtyCells.push_back(cell);
+    }
+}
+
+void ShellDangerMap::markAll() {
+    allDirty = true;
+}
+
+void ShellDangerMap::clearMarked() {
+    if (allDirty) {
+        fill(arrivalRound.begin(), arrivalRound.end(), NO_SHELL);
+    } else {
+        for (size_t cell : dirtyCells) {
+            arrivalRound[cell] = NO_SHELL;
+        }
+    }
+    for (size_t cell : dirtyCells) {
+        dirty[cell] = false;
+    }
+    dirtyCells.clear();
+    allDirty = false;
+}
+
+void ShellDangerMap::refresh(const pmr::vector<Shell>& shells, int round, const vector<vector<char>>& board) {
+    clearMarked();
+    // Shells in flight also extend their horizon by two cells each round
+    for (const auto& shell : shells) {
+        stampShell(shell.getX(), shell.getY(), shell.getDirectionIndex(), round, board);
+    }
+}
+
+template void ShellDangerMap::stampShell(size_t, size_t, int, int, const vector<vector<char>>&);
+template void ShellDangerMap::stampShell(size_t, size_t, int, int, const BoardRows&);
+template void ShellDangerMap::markShellPath(size_t, size_t, int, const vector<vector<char>>&);
+template void ShellDangerMap::markShellPath(size_t, size_t, int, const BoardRows&);
+
+int ShellDangerMap::getRoundsUntilShell(size_t x, size_t y, int currentRound) const {
+    int arrival = arrivalRound[index(x, y)];
+    if (arrival == NO_SHELL || arrival <= currentRound) {
+        return NO_SHELL;
+    }
+    return arrival - currentRound;
+}
@@ -0,0 +1,65 @@
+#pragma once
+#include <vector>
+#include <memory_resource>
+#include <cstddef>
+#include "Shell.h"
+#include "../common/BoardForecast.h"
+
+using namespace std;
+
+// Row-major board kept in one array, read as board[y][x] like the nested vectors
+struct BoardRows {
+    const char* cells;
+    size_t columns;
+    const char* operator[](size_t y) const { return cells + y * columns; }
+};
+
+// Per-cell "earliest round a shell arrives" map.
+// Shells fly 2 cells per round in a straight line, so the cells ahead of each
+// shell are fully predictable. Paths are stamped when a shell is fired. Each round
+// only the cells touched by moved or destroyed shells are cleared, but every shell
+// still in flight is stamped again over its horizon of 2 * HORIZON_ROUNDS cells,
+// so a refresh costs that many cells per shell whatever the board size.
+// The board may be given as nested vectors or as BoardRows.
+class ShellDangerMap final : public ShellForecast {
+private:
+    size_t rows;
+    size_t columns;
+    vector<int> arrivalRound;  // Earliest predicted arrival round per cell (row-major)
+    vector<bool> dirty;        // Cells whose stamp must be recomputed on the next refresh
+    vector<size_t> dirtyCells;
+    bool allDirty;             // Set when a wall opens up and every shell path may extend
+
+    size_t index(size_t x, size_t y) const { return y * columns + x; }
+
+    // Walk the cells ahead of a shell until it would hit a wall or the horizon ends
+    template <typename Board, typename Visitor>
+    void walkShellPath(size_t x, size_t y, int direction, const Board& board, Visitor visit) const;
+
+public:
+    static constexpr int HORIZON_ROUNDS = 5;  // Covers the oldest battle info an algorithm may hold
+
+    ShellDangerMap();
+
+    void reset(size_t rows, size_t columns);
+
+    // Shell events
+    void addShell(const Shell& shell, int round, const vector<vector<char>>& board);  // Shell fired this round
+    void markShellPath(const Shell& shell, const vector<vector<char>>& board);        // Shell about to be destroyed
+    void markCell(size_t x, size_t y);                                               // Shell entered this cell
+    void markAll();                                                                  // A wall was destroyed
+
+    // Clear the dirty cells and stamp all shells still in flight again, after the shell phase of a round
+    void refresh(const pmr::vector<Shell>& shells, int round, const vector<vector<char>>& board);
+
+    // The same for shells given by position and direction index. A refresh is
+    // clearMarked() followed by stampShell() for every shell in flight.
+    template <typename Board>
+    void stampShell(size_t x, size_t y, int direction, int round, const Board& board);
+    template <typename Board>
+    void markShellPath(size_t x, size_t y, int direction, const Board& board);
+    void clearMarked();
+
+    int getArrivalRound(size_t x, size_t y) const { return arrivalRound[index(x, y)]; }
+    int getRoundsUntilShell(size_t x, size_t y, int currentRound) const override;  // NO_SHELL if none is predicted
+};
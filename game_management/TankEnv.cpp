@@ -0,0 +1,150 @@
+#include "TankEnv.h"
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+using namespace BoardConstants;
+
+TankEnv::TankEnv(PlayerFactory& playerFactory, TankAlgorithmFactory& algorithmFactory, unsigned controlledTeams)
+    : playerFactory(playerFactory), algorithmFactory(algorithmFactory), controlledTeams(controlledTeams),
+      autoReset(true), tanks(0), boardRows(0), boardColumns(0)
+{
+}
+
+void TankEnv::reset(const vector<BoardData>& boards) {
+    if (boards.empty()) {
+        throw runtime_error("TankEnv: reset needs at least one board");
+    }
+    size_t tankCount = 0;
+    for (int team = 1; team <= MAX_TEAMS; team++) {
+        tankCount += boards[0].tankCount(team);
+    }
+    for (const BoardData& board : boards) {
+        size_t count = 0;
+        for (int team = 1; team <= MAX_TEAMS; team++) {
+            count += board.tankCount(team);
+        }
+        if (board.rows != boards[0].rows || board.columns != boards[0].columns || count != tankCount) {
+            throw runtime_error("TankEnv: all boards must have the same size and tank count (" + board.mapName + ")");
+        }
+    }
+
+    // The same shape again starts every game over in place and keeps the memory
+    bool sameShape = batch && boards.size() == envBoards.size() && boards[0].rows == boardRows &&
+                     boards[0].columns == boardColumns && tankCount == tanks;
+    envBoards = boards;
+    lastResults.assign(boards.size(), GameResult());
+    tanks = tankCount;
+    boardRows = boards[0].rows;
+    boardColumns = boards[0].columns;
+    if (sameShape) {
+        for (size_t env = 0; env < envBoards.size(); env++) {
+            batch->resetGame(env, envBoards[env]);
+        }
+        return;
+    }
+    batch = make_unique<LockstepBatch>();
+    for (const BoardData& board : envBoards) {
+        batch->addGame(board, playerFactory, algorithmFactory, controlledTeams);
+    }
+    batch->start();
+}
+
+void TankEnv::step(const ActionRequest* actions, float* stepRewards, uint8_t* dones) {
+    if (!batch) {
+        throw runtime_error("TankEnv: step before reset");
+    }
+    size_t total = envBoards.size() * tanks;
+    fill(stepRewards, stepRewards + total, 0.0f);
+    vector<uint8_t> wasFinished(envBoards.size());
+    for (size_t env = 0; env < envBoards.size(); env++) {
+        wasFinished[env] = batch->isFinished(env);
+    }
+
+    batch->playRound(actions);
+
+    for (const LockstepBatch::Kill& kill : batch->lastRoundKills()) {
+        stepRewards[kill.tank] += rewards.death;
+        if (kill.shooter >= 0) {
+            bool sameTeam = batch->tankTeam[kill.shooter] == batch->tankTeam[kill.tank];
+            stepRewards[kill.shooter] += sameTeam ? rewards.teamKill : rewards.kill;
+        }
+    }
+
+    for (size_t env = 0; env < envBoards.size(); env++) {
+        bool finished = batch->isFinished(env);
+        for (size_t tank = 0; tank < tanks; tank++) {
+            dones[index(env, tank)] = finished || !batch->tankAlive[index(env, tank)];
+        }
+        if (!finished || wasFinished[env]) {
+            continue;
+        }
+        // The game ended this step
+        lastResults[env] = batch->getResult(env);
+        int winner = lastResults[env].winner;
+        if (winner != 0) {
+            for (size_t tank = 0; tank < tanks; tank++) {
+                stepRewards[index(env, tank)] += teamOf(env, tank) == winner ? rewards.win : rewards.loss;
+            }
+        }
+        if (autoReset) {
+            batch->resetGame(env, envBoards[env]);
+        }
+    }
+}
+
+template <typename T>
+void TankEnv::observe(T* out) const {
+    const LockstepBatch& b = *batch;
+    size_t planeSize = boardRows * boardColumns;
+    size_t perTank = observationSize();
+    fill(out, out + envBoards.size() * tanks * perTank, T(0));
+
+    // The board planes are the same for all tanks of an env: fill the first tank's, then copy them on
+    for (size_t env = 0; env < envBoards.size(); env++) {
+        T* first = out + index(env, 0) * perTank;
+        const char* cells = b.cells.data() + b.gameCellBase[env];
+        for (size_t cell = 0; cell < planeSize; cell++) {
+            switch (cells[cell]) {
+                case WALL: first[Wall * planeSize + cell] = T(1); break;
+                case DAMAGED_WALL: first[DamagedWall * planeSize + cell] = T(1); break;
+                case MINE:
+                case MINE_SHELL_COLLISION:
+                case TANK_MINE_COLLISION:
+                    first[Mine * planeSize + cell] = T(1);
+                    break;
+                default: break;
+            }
+        }
+    }
+    // Shells of finished games are already gone
+    for (size_t i = 0; i < b.shellX.size(); i++) {
+        T* first = out + index(b.shellGame[i], 0) * perTank;
+        first[Shell * planeSize + b.shellY[i] * boardColumns + b.shellX[i]] = T(1);
+    }
+
+    for (size_t env = 0; env < envBoards.size(); env++) {
+        T* first = out + index(env, 0) * perTank;
+        for (size_t viewer = 0; viewer < tanks; viewer++) {
+            T* block = first + viewer * perTank;
+            if (viewer > 0) {
+                copy(first, first + OwnTank * planeSize, block);
+            }
+            size_t viewerIndex = index(env, viewer);
+            for (size_t tank = index(env, 0); tank < index(env, tanks); tank++) {
+                if (!b.tankAlive[tank]) {
+                    continue;
+                }
+                size_t cell = b.tankY[tank] * boardColumns + b.tankX[tank];
+                Plane plane = b.tankTeam[tank] == b.tankTeam[viewerIndex] ? OwnTank : EnemyTank;
+                block[plane * planeSize + cell] = T(1);
+                if (tank == viewerIndex) {
+                    block[Self * planeSize + cell] = T(1);
+                }
+            }
+        }
+    }
+}
+
+template void TankEnv::observe(float*) const;
+template void TankEnv::observe(uint8_t*) const;
@@ -0,0 +1,82 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "LockstepBatch.h"
+#include "BoardReader.h"
+#include "../common/ActionRequest.h"
+#include "../common/PlayerFactory.h"
+#include "../common/TankAlgorithmFactory.h"
+
+using namespace std;
+
+// Step-by-step environment for learning agents, over many games at once.
+// The tanks of the controlled teams take their actions from step(); the other
+// teams play their algorithms. Every game must have the same board size and tank
+// count, so tanks are numbered env * tanksPerEnv() + tank, each env's tanks in
+// board order, and rewards, done flags and observations all follow that order.
+class TankEnv {
+public:
+    static constexpr unsigned ALL_TEAMS = ~0u;
+
+    // One-hot planes of an observation, each rows() x columns()
+    enum Plane { Wall, DamagedWall, Mine, Shell, OwnTank, EnemyTank, Self, PLANES };
+
+    // Rewards handed out per tank and step
+    struct Rewards {
+        float kill = 1.0f;       // Our shell alone killed an enemy tank
+        float teamKill = -1.0f;  // Our shell alone killed a tank of our team
+        float death = -1.0f;     // We were killed
+        float win = 1.0f;        // The game ended and our team won
+        float loss = -1.0f;      // The game ended and another team won
+    };
+
+    // controlledTeams has bit k set for every team k driven through step()
+    TankEnv(PlayerFactory& playerFactory, TankAlgorithmFactory& algorithmFactory, unsigned controlledTeams = ALL_TEAMS);
+
+    void setRewards(const Rewards& newRewards) { rewards = newRewards; }
+    // Start a finished game over on its board within the step that ends it (default on)
+    void setAutoReset(bool enabled) { autoReset = enabled; }
+
+    void reset(const vector<BoardData>& boards);  // One env per board
+    void reset(const BoardData& board) { reset(vector<BoardData>{board}); }
+
+    // actions, rewards and dones hold numEnvs() * tanksPerEnv() entries. Actions of
+    // tanks of teams that are not controlled are ignored. A tank is done once it is
+    // dead or its game has ended; with auto reset the env then already shows the next game.
+    void step(const ActionRequest* actions, float* stepRewards, uint8_t* dones);
+
+    // Write every tank's observation, laid out [env][tank][plane][y][x], as 0 or 1
+    template <typename T>
+    void observe(T* out) const;
+
+    size_t numEnvs() const { return envBoards.size(); }
+    size_t tanksPerEnv() const { return tanks; }
+    size_t rows() const { return boardRows; }
+    size_t columns() const { return boardColumns; }
+    size_t observationSize() const { return PLANES * boardRows * boardColumns; }  // Per tank
+
+    int teamOf(size_t env, size_t tank) const { return batch->tankTeam[index(env, tank)]; }
+    bool isAlive(size_t env, size_t tank) const { return batch->tankAlive[index(env, tank)] != 0; }
+    int directionOf(size_t env, size_t tank) const { return batch->tankDirection[index(env, tank)]; }
+    int roundOf(size_t env) const { return batch->getRound(env); }
+    // Result of the env's last finished game
+    const GameResult& lastResult(size_t env) const { return lastResults[env]; }
+
+private:
+    PlayerFactory& playerFactory;
+    TankAlgorithmFactory& algorithmFactory;
+    unsigned controlledTeams;
+    Rewards rewards;
+    bool autoReset;
+
+    unique_ptr<LockstepBatch> batch;
+    vector<BoardData> envBoards;
+    vector<GameResult> lastResults;
+    size_t tanks;
+    size_t boardRows;
+    size_t boardColumns;
+
+    size_t index(size_t env, size_t tank) const { return env * tanks + tank; }
+};
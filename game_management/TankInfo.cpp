@@ -1,5 +1,6 @@
 #include "TankInfo.h"
 #include <iostream>
+#include <stdexcept>
 
 // All possible directions in the game:
 // Cardinal directions (90 degrees):
@@ -31,30 +32,40 @@
 // - RotateRight90 -> [0,-1] (Up)
 // - RotateRight90 -> [1,0] (Right) - back to start
 
-TankInfo::TankInfo(size_t x, size_t y, int dx, int dy, std::unique_ptr<TankAlgorithm> algo, size_t width, size_t height, int playerId, int creationOrder, int numShells)
-    : MovableObject(x, y, width, height), isAlive(true), shootCooldown(0),
-      algorithm(std::move(algo)), playerId(playerId), creationOrder(creationOrder),
-      backwardMoveCounter(0), isMovingBackward(false), numShells(numShells) {
-    clearRoundInfo();
-    roundInfo.isAlive = true;
-    // Set the initial direction
-    setDirection(dx, dy);
-    std::cout << "Tank " << creationOrder << " has " << numShells << " shells" << std::endl;
+// Movement methods
+void TankInfo::move() {
+    // Store current position before moving
+    auto [newX, newY] = getPotentialMove();
+    table->hasPrevious[index] = 1;
+    table->previousX[index] = getX();
+    table->previousY[index] = getY();
+    setPosition(newX, newY);
 }
 
-// Tank-specific getters
-bool TankInfo::getIsAlive() const { return isAlive; }
-int TankInfo::getShootCooldown() const { return shootCooldown; }
-TankAlgorithm* TankInfo::getAlgorithm() { return algorithm.get(); }
+void TankInfo::moveBackwards() {
+    // Store current position before moving
+    auto [newX, newY] = getPotentialMoveBackwards();
+    table->hasPrevious[index] = 1;
+    table->previousX[index] = getX();
+    table->previousY[index] = getY();
+    setPosition(newX, newY);
+}
+
+void TankInfo::setDirection(int dx, int dy) {
+    int d = Directions::indexOf(dx, dy);
+    if (d < 0) {
+        throw std::runtime_error("Invalid direction");
+    }
+    table->direction[index] = static_cast<uint8_t>(d);
+}
 
 // Tank-specific actions
 void TankInfo::killTank() { 
-    isAlive = false; 
-    roundInfo.isAlive = false;
-    roundInfo.wasKilled = true;
+    table->alive[index] = 0;
+    table->roundInfo[index].isAlive = false;
+    table->roundInfo[index].wasKilled = true;
 }
-void TankInfo::startShootCooldown() { shootCooldown = 4; }  // Assuming 2 turns cooldown
-void TankInfo::updateShootCooldown() { if (shootCooldown > 0) shootCooldown--; }
+void TankInfo::startShootCooldown() { table->shootCooldown[index] = TankTable::SHOOT_COOLDOWN; }
 
 void TankInfo::rotate(ActionRequest action) {
     switch (action) {
@@ -76,20 +87,13 @@ void TankInfo::rotate(ActionRequest action) {
 }
 
 void TankInfo::startBackwardMove() {
-    if (!isMovingBackward) {
-        isMovingBackward = true;
-        backwardMoveCounter = 0;
+    if (!getIsMovingBackward()) {
+        table->movingBackward[index] = 1;
+        table->backwardCounter[index] = 0;
     }
 }
 
 void TankInfo::cancelBackwardMove() {
-    isMovingBackward = false;
-    backwardMoveCounter = 0;
+    table->movingBackward[index] = 0;
+    table->backwardCounter[index] = 0;
 }
-
-void TankInfo::updateBackwardMove() {
-    if (isMovingBackward) {
-        backwardMoveCounter++;
-    }
-}
-
@@ -1,70 +1,82 @@
 #pragma once
 #include <memory>
-#include "MovableObject.h"
+#include "TankTable.h"
 #include "../common/TankAlgorithm.h"
+#include "../common/TankAlgorithmFactory.h"
 #include "../common/ActionRequest.h"
 #include "../common/RoundInfo.h"
 #include <optional>
 #include <iostream>
 
-class TankInfo : public MovableObject {
+// Handle to one tank in a TankTable. Cheap to copy; all state lives in the table.
+class TankInfo {
 private:
-    bool isAlive;
-    int shootCooldown;  // Count of turns until next shoot is available
-    std::unique_ptr<TankAlgorithm> algorithm;
-    RoundInfo roundInfo;  // Added to store round information
-    int playerId;  // Added to track which player owns this tank
-    int creationOrder;  // Added to track the order of creation in the board
-    int backwardMoveCounter;  // Counter for backward movement steps
-    bool isMovingBackward;  // Flag to track if tank is in backward movement sequence
-    int numShells;  // Number of shells the tank has
+    TankTable* table;
+    size_t index;  // Creation order, also the tank's row in the table
 
 public:
-    TankInfo(size_t x, size_t y, int dx, int dy, std::unique_ptr<TankAlgorithm> algo, size_t width, size_t height, int playerId, int creationOrder, int numShells);
+    TankInfo(TankTable& table, size_t index) : table(&table), index(index) {}
+
+    // Position and direction
+    size_t getX() const { return table->x[index]; }
+    size_t getY() const { return table->y[index]; }
+    const std::array<int, 2>& getDirection() const { return Directions::VECTORS[table->direction[index]]; }
+    int getDirectionIndex() const { return table->direction[index]; }
+    std::optional<std::pair<size_t, size_t>> getPreviousPosition() const {
+        if (!table->hasPrevious[index]) return std::nullopt;
+        return std::make_pair(table->previousX[index], table->previousY[index]);
+    }
+    void clearPreviousPosition() { table->hasPrevious[index] = 0; }
+
+    // Movement methods
+    void move();
+    void moveBackwards();
+    std::pair<size_t, size_t> getPotentialMove() const {
+        int d = table->direction[index];
+        return {Directions::wrapStep(getX(), Directions::dx(d), table->boardWidth),
+                Directions::wrapStep(getY(), Directions::dy(d), table->boardHeight)};
+    }
+    std::pair<size_t, size_t> getPotentialMoveBackwards() const {
+        int d = table->direction[index];
+        return {Directions::wrapStep(getX(), -Directions::dx(d), table->boardWidth),
+                Directions::wrapStep(getY(), -Directions::dy(d), table->boardHeight)};
+    }
+    void setPosition(size_t newX, size_t newY) { table->x[index] = newX; table->y[index] = newY; }
+
+    // Direction methods
+    void setDirection(int dx, int dy);
+    void rotate90(bool clockwise) { rotateSteps(clockwise ? 2 : -2); }
+    void rotate45(bool clockwise) { rotateSteps(clockwise ? 1 : -1); }
+    void rotateSteps(int steps) {
+        table->direction[index] = static_cast<uint8_t>(Directions::rotate(table->direction[index], steps));
+    }
 
     // Tank-specific getters
-    bool getIsAlive() const;
-    int getShootCooldown() const;
-    TankAlgorithm* getAlgorithm();
-    int getPlayerId() const { return playerId; }
-    int getCreationOrder() const { return creationOrder; }
-    bool getIsMovingBackward() const { return isMovingBackward; }
-    int getBackwardMoveCounter() const { return backwardMoveCounter; }
-    int getNumShells() const { return numShells; }
-    void setNumShells(int shells) { numShells = shells; std::cout << "Tank " << creationOrder << " has " << numShells << " shells" << std::endl; }
+    bool getIsAlive() const { return table->alive[index] != 0; }
+    int getShootCooldown() const { return table->shootCooldown[index]; }
+    TankAlgorithm* getAlgorithm() { return table->algorithm[index].get(); }
+    int getPlayerId() const { return table->playerId[index]; }
+    int getCreationOrder() const { return static_cast<int>(index); }
+    bool getIsMovingBackward() const { return table->movingBackward[index] != 0; }
+    int getBackwardMoveCounter() const { return table->backwardCounter[index]; }
+    int getNumShells() const { return table->numShells[index]; }
+    void setNumShells(int shells) { table->numShells[index] = shells; std::cout << "Tank " << index << " has " << shells << " shells" << std::endl; }
 
     // RoundInfo getters and setters
-    bool getRoundIsAlive() const { return roundInfo.isAlive; }
-    ActionRequest getRoundAction() const { return roundInfo.action; }
-    bool getRoundWasActionIgnored() const { return roundInfo.wasActionIgnored; }
-    bool getRoundWasKilled() const { return roundInfo.wasKilled; }
-    
-    void setRoundIsAlive(bool value) { roundInfo.isAlive = value; }
-    void setRoundAction(ActionRequest action) { roundInfo.action = action; }
-    void setRoundWasActionIgnored(bool value) { roundInfo.wasActionIgnored = value; }
-    void setRoundWasKilled(bool value) { roundInfo.wasKilled = value; }
+    bool getRoundIsAlive() const { return table->roundInfo[index].isAlive; }
+    ActionRequest getRoundAction() const { return table->roundInfo[index].action; }
+    bool getRoundWasActionIgnored() const { return table->roundInfo[index].wasActionIgnored; }
+    bool getRoundWasKilled() const { return table->roundInfo[index].wasKilled; }
     
-    void clearRoundInfo() {
-        roundInfo.action = ActionRequest::DoNothing;
-        roundInfo.wasActionIgnored = false;
-        roundInfo.wasKilled = false;
-    }
+    void setRoundIsAlive(bool value) { table->roundInfo[index].isAlive = value; }
+    void setRoundAction(ActionRequest action) { table->roundInfo[index].action = action; }
+    void setRoundWasActionIgnored(bool value) { table->roundInfo[index].wasActionIgnored = value; }
+    void setRoundWasKilled(bool value) { table->roundInfo[index].wasKilled = value; }
 
     // Tank-specific actions
     void killTank();
     void rotate(ActionRequest action);
     void startShootCooldown();
-    void updateShootCooldown();
     void startBackwardMove();
     void cancelBackwardMove();
-    void updateBackwardMove();
-    void resetRoundFlags() { 
-        updateShootCooldown();       // Update cooldown
-    }
-    void beginRound() {
-        clearRoundInfo();           // Clear round info
-        updateShootCooldown();      // Update cooldown
-        updateBackwardMove();       // Update backward movement state
-        clearPreviousPosition();    // Clear previous position
-    }
 }; 
\ No newline at end of file
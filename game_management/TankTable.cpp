@@ -0,0 +1,109 @@
+#include "TankTable.h"
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+
+TankTable::TankTable(pmr::memory_resource* resource)
+    : resource(resource), boardWidth(0), boardHeight(0),
+      x(resource), y(resource), direction(resource), alive(resource), shootCooldown(resource),
+      numShells(resource), movingBackward(resource), backwardCounter(resource), hasPrevious(resource),
+      previousX(resource), previousY(resource), playerId(resource), algorithm(resource), roundInfo(resource),
+      byTeam(resource)
+{
+    teamStart.fill(0);
+}
+
+void TankTable::clear() {
+    // Assigning fresh arrays, rather than clearing, also returns their buffers
+    x = pmr::vector<size_t>(resource);
+    y = pmr::vector<size_t>(resource);
+    direction = pmr::vector<uint8_t>(resource);
+    alive = pmr::vector<uint8_t>(resource);
+    shootCooldown = pmr::vector<int>(resource);
+    numShells = pmr::vector<int>(resource);
+    movingBackward = pmr::vector<uint8_t>(resource);
+    backwardCounter = pmr::vector<int>(resource);
+    hasPrevious = pmr::vector<uint8_t>(resource);
+    previousX = pmr::vector<size_t>(resource);
+    previousY = pmr::vector<size_t>(resource);
+    playerId = pmr::vector<int>(resource);
+    algorithm = pmr::vector<TankAlgorithmPtr>(resource);
+    roundInfo = pmr::vector<RoundInfo>(resource);
+    byTeam = pmr::vector<size_t>(resource);
+    teamStart.fill(0);
+}
+
+void TankTable::setBoardSize(size_t width, size_t height) {
+    boardWidth = width;
+    boardHeight = height;
+}
+
+size_t TankTable::add(size_t tankX, size_t tankY, int dx, int dy, TankAlgorithmPtr tankAlgorithm, int tankPlayerId, int tankShells) {
+    if (tankPlayerId < 1 || tankPlayerId > BoardConstants::MAX_TEAMS) {
+        throw runtime_error("Invalid team: " + to_string(tankPlayerId));
+    }
+    x.push_back(tankX);
+    y.push_back(tankY);
+    direction.push_back(static_cast<uint8_t>(Directions::indexOf(dx, dy)));
+    alive.push_back(1);
+    shootCooldown.push_back(0);
+    numShells.push_back(tankShells);
+    movingBackward.push_back(0);
+    backwardCounter.push_back(0);
+    hasPrevious.push_back(0);
+    previousX.push_back(0);
+    previousY.push_back(0);
+    playerId.push_back(tankPlayerId);
+    algorithm.push_back(std::move(tankAlgorithm));
+    roundInfo.push_back({true, ActionRequest::DoNothing, false, false});
+
+    // Append to the end of the team's group, shifting the groups of later teams
+    size_t index = x.size() - 1;
+    byTeam.insert(byTeam.begin() + teamStart[tankPlayerId + 1], index);
+    for (int team = tankPlayerId + 1; team < static_cast<int>(teamStart.size()); team++) {
+        teamStart[team]++;
+    }
+    return index;
+}
+
+void TankTable::beginRound() {
+    for (auto& info : roundInfo) {
+        info.action = ActionRequest::DoNothing;
+        info.wasActionIgnored = false;
+        info.wasKilled = false;
+    }
+    for (auto& cooldown : shootCooldown) {
+        if (cooldown > 0) {
+            cooldown--;
+        }
+    }
+    for (size_t i = 0; i < backwardCounter.size(); i++) {
+        backwardCounter[i] += movingBackward[i];
+    }
+    fill(hasPrevious.begin(), hasPrevious.end(), 0);
+}
+
+void TankTable::findSwappedPairs(pmr::vector<pair<size_t, size_t>>& pairs) const {
+    // Owner of every occupied cell, the last living tank on it in team order
+    pmr::unordered_map<size_t, size_t> owner(pairs.get_allocator().resource());
+    for (size_t i : byTeam) {
+        if (alive[i]) {
+            owner[y[i] * boardWidth + x[i]] = i;
+        }
+    }
+
+    // A swap partner must own the cell this tank left, so there is at most one per tank
+    for (size_t i = 0; i < x.size(); i++) {
+        if (!alive[i] || !hasPrevious[i] || owner[y[i] * boardWidth + x[i]] != i) {
+            continue;
+        }
+        auto it = owner.find(previousY[i] * boardWidth + previousX[i]);
+        if (it == owner.end() || it->second <= i) {
+            continue;
+        }
+        size_t j = it->second;
+        if (hasPrevious[j] && previousX[j] == x[i] && previousY[j] == y[i]) {
+            pairs.push_back({i, j});
+        }
+    }
+}
@@ -0,0 +1,73 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <utility>
+#include <vector>
+#include "../common/TankAlgorithmFactory.h"
+#include "../common/RoundInfo.h"
+#include "../constants/BoardConstants.h"
+#include "../constants/Directions.h"
+
+using namespace std;
+
+class TankInfo;
+
+// Storage for all tanks of a match, indexed by creation order. The fields the
+// per-round passes read sit in parallel arrays; the algorithm, owner and round
+// history are kept in separate arrays that those passes never touch.
+// A second index groups the tanks by team (1 to MAX_TEAMS), which is the order
+// they act in.
+class TankTable {
+public:
+    static constexpr int SHOOT_COOLDOWN = 4;
+
+    explicit TankTable(pmr::memory_resource* resource = pmr::get_default_resource());
+
+    void clear();  // Drop all tanks and give the arrays' memory back to the resource
+    void setBoardSize(size_t width, size_t height);
+    size_t add(size_t x, size_t y, int dx, int dy, TankAlgorithmPtr algorithm, int playerId, int numShells);
+    size_t size() const { return x.size(); }
+
+    // Tank indices grouped by team, each team in creation order. The tanks of a team
+    // are teamOrder()[teamBegin(team)] up to teamOrder()[teamEnd(team)].
+    const pmr::vector<size_t>& teamOrder() const { return byTeam; }
+    size_t teamBegin(int team) const { return teamStart[team]; }
+    size_t teamEnd(int team) const { return teamStart[team + 1]; }
+
+    // Per-round passes over all tanks
+    void beginRound();      // Clear round info, tick cooldowns and backward counters, forget previous positions
+    // Pairs of living tanks that swapped cells this round. Where tanks share a cell only the last
+    // one in team order is considered, as the position map of the original check did.
+    void findSwappedPairs(pmr::vector<pair<size_t, size_t>>& pairs) const;
+
+private:
+    friend class TankInfo;
+
+    pmr::memory_resource* resource;
+    size_t boardWidth;
+    size_t boardHeight;
+
+    // Hot fields
+    pmr::vector<size_t> x;
+    pmr::vector<size_t> y;
+    pmr::vector<uint8_t> direction;  // Index into Directions::VECTORS
+    pmr::vector<uint8_t> alive;
+    pmr::vector<int> shootCooldown;
+    pmr::vector<int> numShells;
+    pmr::vector<uint8_t> movingBackward;
+    pmr::vector<int> backwardCounter;
+    pmr::vector<uint8_t> hasPrevious;
+    pmr::vector<size_t> previousX;
+    pmr::vector<size_t> previousY;
+
+    // Cold fields
+    pmr::vector<int> playerId;
+    pmr::vector<TankAlgorithmPtr> algorithm;
+    pmr::vector<RoundInfo> roundInfo;
+
+    // Team index, kept up to date by add()
+    pmr::vector<size_t> byTeam;
+    array<size_t, BoardConstants::MAX_TEAMS + 2> teamStart;
+};
@@ -0,0 +1,50 @@
+#include "TeamTally.h"
+
+TeamTally::TeamTally() : numTeams(0), teamsAlive(0), totalShells(0) {
+    alive.fill(0);
+    shells.fill(0);
+}
+
+void TeamTally::reset(const BoardData& board) {
+    numTeams = board.numTeams;
+    alive.fill(0);
+    shells.fill(0);
+    teamsAlive = 0;
+    totalShells = 0;
+    for (int team = 1; team <= numTeams; team++) {
+        alive[team] = static_cast<int>(board.tankCount(team));
+        shells[team] = static_cast<long>(board.tankCount(team) * board.numShells);
+        totalShells += shells[team];
+        if (alive[team] > 0) {
+            teamsAlive++;
+        }
+    }
+}
+
+void TeamTally::onGameEvent(const GameEvent& event) {
+    switch (event.type) {
+        case GameEvent::Type::ShellFired:
+            shells[event.player]--;
+            totalShells--;
+            break;
+        case GameEvent::Type::TankKilled:
+            // The shells of a dead tank no longer count
+            shells[event.player] -= event.count;
+            totalShells -= event.count;
+            if (--alive[event.player] == 0) {
+                teamsAlive--;
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+int TeamTally::lastTeamWithTanks() const {
+    for (int team = numTeams; team >= 1; team--) {
+        if (alive[team] > 0) {
+            return team;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,31 @@
+#pragma once
+#include <array>
+#include "GameEvents.h"
+#include "BoardReader.h"
+#include "../constants/BoardConstants.h"
+
+using namespace std;
+
+// Living tanks and the shells they hold, per team, kept up to date from the
+// event stream so the end-of-game checks never have to look at the tanks.
+class TeamTally : public GameEventListener {
+private:
+    int numTeams;
+    array<int, BoardConstants::MAX_TEAMS + 1> alive;   // Indexed by team, entry 0 unused
+    array<long, BoardConstants::MAX_TEAMS + 1> shells;
+    int teamsAlive;
+    long totalShells;
+
+public:
+    TeamTally();
+
+    // Start a match with every tank of the board alive and fully loaded
+    void reset(const BoardData& board);
+    void onGameEvent(const GameEvent& event) override;
+
+    int aliveCount(int team) const { return alive[team]; }
+    long shellCount(int team) const { return shells[team]; }
+    int teamsWithTanks() const { return teamsAlive; }
+    int lastTeamWithTanks() const;  // Highest team with a living tank, 0 if none
+    bool allOutOfShells() const { return totalShells == 0; }
+};
@@ -0,0 +1,125 @@
+#include "TerminalRenderer.h"
+#include "../constants/BoardConstants.h"
+
+using namespace BoardConstants;
+
+namespace {
+    // Select Graphic Rendition parameters; every style starts with a reset
+    enum Style { Plain, Wall, DamagedWall, Mine, Shell, Collision, FirstTeam };
+
+    const char* const STYLES[FirstTeam + MAX_TEAMS] = {
+        "0", "0;97", "0;90", "0;35", "0;1;93", "0;1;97;41",
+        "0;1;31", "0;1;34", "0;1;32", "0;1;33", "0;1;35", "0;1;36", "0;1;91", "0;1;94", "0;1;92"
+    };
+
+    int styleOf(char cell) {
+        if (isTankChar(cell)) {
+            return FirstTeam + teamOf(cell) - 1;
+        }
+        switch (cell) {
+            case EMPTY_SPACE: return Plain;
+            case WALL: return Wall;
+            case DAMAGED_WALL: return DamagedWall;
+            case MINE: return Mine;
+            case SHELL: return Shell;
+            default: return isCollision(cell) ? Collision : Plain;
+        }
+    }
+
+    void moveCursor(string& buffer, size_t row, size_t column) {
+        // 1-based; the title takes the first line
+        buffer += "\x1b[";
+        buffer += to_string(row + 2);
+        buffer += ';';
+        buffer += to_string(column + 1);
+        buffer += 'H';
+    }
+}
+
+TerminalRenderer::TerminalRenderer(ostream& out, double maxFps)
+    : out(out), minInterval(0), drawn(false), shownRows(0), shownColumns(0)
+{
+    if (maxFps > 0) {
+        minInterval = chrono::duration_cast<chrono::nanoseconds>(chrono::duration<double>(1.0 / maxFps));
+    }
+}
+
+TerminalRenderer::~TerminalRenderer() {
+    if (drawn) {
+        out << "\x1b[0m\x1b[?25h" << flush;
+    }
+}
+
+void TerminalRenderer::reset() {
+    if (drawn) {
+        out << "\x1b[0m\x1b[?25h" << flush;
+    }
+    drawn = false;
+}
+
+bool TerminalRenderer::draw(const string& title, int round, const vector<vector<char>>& board, bool force) {
+    size_t columns = board.empty() ? 0 : board[0].size();
+    return drawRows(title, round, board.size(), columns, [&board](size_t y) { return board[y].data(); }, force);
+}
+
+bool TerminalRenderer::draw(const string& title, int round, size_t rows, size_t columns, const char* cells, bool force) {
+    return drawRows(title, round, rows, columns, [cells, columns](size_t y) { return cells + y * columns; }, force);
+}
+
+template <typename RowAt>
+bool TerminalRenderer::drawRows(const string& title, int round, size_t rows, size_t columns, RowAt rowAt, bool force) {
+    auto now = chrono::steady_clock::now();
+    if (drawn && !force && now - lastDraw < minInterval) {
+        return false;
+    }
+    lastDraw = now;
+
+    buffer.clear();
+    if (!drawn || rows != shownRows || columns != shownColumns) {
+        // Start from a cleared screen, on which every empty cell is already right
+        buffer += "\x1b[?25l\x1b[0m\x1b[2J";
+        shown.assign(rows * columns, EMPTY_SPACE);
+        shownRows = rows;
+        shownColumns = columns;
+    }
+    buffer += "\x1b[1;1H\x1b[0m";
+    buffer += title;
+    buffer += " - round ";
+    buffer += to_string(round);
+    buffer += "\x1b[K";
+
+    int style = Plain;
+    size_t cursorRow = rows;  // Unknown until the first cell is written
+    size_t cursorColumn = 0;
+    for (size_t y = 0; y < rows; y++) {
+        const char* row = rowAt(y);
+        char* shownRow = shown.data() + y * columns;
+        for (size_t x = 0; x < columns; x++) {
+            char cell = row[x];
+            if (cell == shownRow[x]) {
+                continue;
+            }
+            if (cursorRow != y || cursorColumn != x) {
+                moveCursor(buffer, y, x);
+            }
+            int cellStyle = styleOf(cell);
+            if (cellStyle != style) {
+                buffer += "\x1b[";
+                buffer += STYLES[cellStyle];
+                buffer += 'm';
+                style = cellStyle;
+            }
+            buffer += cell;
+            shownRow[x] = cell;
+            cursorRow = y;
+            cursorColumn = x + 1;
+        }
+    }
+    buffer += "\x1b[0m";
+    moveCursor(buffer, rows, 0);
+
+    out.write(buffer.data(), static_cast<streamsize>(buffer.size()));
+    out.flush();
+    drawn = true;
+    return true;
+}
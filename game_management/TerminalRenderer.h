@@ -0,0 +1,42 @@
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Draws boards to an ANSI terminal, one frame over the previous one. Only the cells
+// that changed since the last frame drawn are written, each preceded by a cursor move
+// when it does not follow the previous one, so a mostly static board costs little no
+// matter its size. Tanks are coloured by team and collisions stand out in red.
+// With a frame rate limit, frames that come too soon after the last one are skipped;
+// the next frame drawn still shows everything that changed meanwhile.
+class TerminalRenderer {
+public:
+    // maxFps of 0 draws every frame
+    explicit TerminalRenderer(ostream& out, double maxFps = 0);
+    ~TerminalRenderer();  // Leaves the cursor below the board and visible
+    TerminalRenderer(const TerminalRenderer&) = delete;
+    TerminalRenderer& operator=(const TerminalRenderer&) = delete;
+
+    // Draw a frame, unless the rate limit skips it and force is not set. True if drawn.
+    bool draw(const string& title, int round, const vector<vector<char>>& board, bool force = false);
+    bool draw(const string& title, int round, size_t rows, size_t columns, const char* cells, bool force = false);
+
+    void reset();  // Forget the frame on screen, the next one clears it and is drawn in full
+
+private:
+    ostream& out;
+    chrono::nanoseconds minInterval;
+    chrono::steady_clock::time_point lastDraw;
+    bool drawn;  // Something is on screen and shown describes it
+    size_t shownRows;
+    size_t shownColumns;
+    vector<char> shown;  // Glyphs on screen, row-major
+    string buffer;       // Escape sequences of the frame being drawn
+
+    template <typename RowAt>
+    bool drawRows(const string& title, int round, size_t rows, size_t columns, RowAt rowAt, bool force);
+};
@@ -0,0 +1,18 @@
+#include "TypeName.h"
+#ifdef __GNUG__
+#include <cxxabi.h>
+#include <cstdlib>
+#endif
+
+string demangledName(const type_info& type) {
+#ifdef __GNUG__
+    int status = 0;
+    char* demangled = abi::__cxa_demangle(type.name(), nullptr, nullptr, &status);
+    if (status == 0 && demangled) {
+        string result(demangled);
+        free(demangled);
+        return result;
+    }
+#endif
+    return type.name();
+}
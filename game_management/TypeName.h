@@ -0,0 +1,8 @@
+#pragma once
+#include <string>
+#include <typeinfo>
+
+using namespace std;
+
+// Readable class name of a type, demangled where the compiler supports it
+string demangledName(const type_info& type);
@@ -0,0 +1,65 @@
+#include "ZobristHash.h"
+#include <algorithm>
+#include "../constants/BoardConstants.h"
+
+using namespace BoardConstants;
+
+namespace {
+    const uint64_t ZOBRIST_SEED = 0x5DEECE66D2F1A3B7ULL;
+
+    // splitmix64 finalizer - cheap and well distributed
+    uint64_t mix(uint64_t z) {
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+}
+
+ZobristHash::ZobristHash() : columns(0), hash(0) {}
+
+uint64_t ZobristHash::key(Feature feature, uint64_t a, uint64_t b) {
+    return mix(ZOBRIST_SEED ^ mix(static_cast<uint64_t>(feature) ^ mix(a ^ mix(b))));
+}
+
+void ZobristHash::reset(const vector<vector<char>>& board, TankTable& tanks, const pmr::vector<Shell>& shells) {
+    columns = board.empty() ? 0 : board[0].size();
+    hash = 0;
+    for (size_t y = 0; y < board.size(); y++) {
+        for (size_t x = 0; x < board[y].size(); x++) {
+            toggleCell(x, y, board[y][x]);
+        }
+    }
+    for (size_t i = 0; i < tanks.size(); i++) {
+        toggleTank(TankInfo(tanks, i));
+    }
+    for (const auto& shell : shells) {
+        toggleShell(shell);
+    }
+}
+
+void ZobristHash::toggleCell(size_t x, size_t y, char cell) {
+    if (cell == EMPTY_SPACE) {
+        return;  // Empty cells contribute nothing
+    }
+    hash ^= key(Feature::Cell, cellIndex(x, y), static_cast<unsigned char>(cell));
+}
+
+void ZobristHash::toggleTank(const TankInfo& tank) {
+    uint64_t id = static_cast<uint64_t>(tank.getCreationOrder());
+    if (!tank.getIsAlive()) {
+        hash ^= key(Feature::TankDead, id, 0);
+        return;
+    }
+    // The backward counter keeps growing while a tank waits, but only values up to 2 affect the rules
+    uint64_t backward = tank.getIsMovingBackward() ? 1 + min(tank.getBackwardMoveCounter(), 3) : 0;
+
+    hash ^= key(Feature::TankPosition, id, cellIndex(tank.getX(), tank.getY()));
+    hash ^= key(Feature::TankDirection, id, static_cast<uint64_t>(tank.getDirectionIndex()));
+    hash ^= key(Feature::TankCooldown, id, static_cast<uint64_t>(tank.getShootCooldown()));
+    hash ^= key(Feature::TankBackward, id, backward);
+    hash ^= key(Feature::TankShells, id, static_cast<uint64_t>(tank.getNumShells()));
+}
+
+void ZobristHash::toggleShell(const Shell& shell) {
+    hash ^= key(Feature::Shell, cellIndex(shell.getX(), shell.getY()), static_cast<uint64_t>(shell.getDirectionIndex()));
+}
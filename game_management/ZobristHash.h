@@ -0,0 +1,47 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <memory_resource>
+#include "TankInfo.h"
+#include "Shell.h"
+
+using namespace std;
+
+// Incrementally maintained 64-bit Zobrist hash of the game state.
+// Every feature (a board cell glyph, a tank's position/direction/cooldown/shells,
+// a shell's position and direction) maps to a pseudo-random key, and the state
+// hash is the XOR of the keys of all present features. Toggling a feature out
+// and back in after a change keeps the hash up to date in O(1).
+class ZobristHash {
+private:
+    enum class Feature : uint64_t {
+        Cell = 1,
+        TankPosition,
+        TankDirection,
+        TankCooldown,
+        TankBackward,
+        TankShells,
+        TankDead,
+        Shell
+    };
+
+    size_t columns;
+    uint64_t hash;
+
+    // Keys are derived on the fly from a fixed seed, so no key tables are needed
+    static uint64_t key(Feature feature, uint64_t a, uint64_t b);
+    uint64_t cellIndex(size_t x, size_t y) const { return y * columns + x; }
+
+public:
+    ZobristHash();
+
+    // Recompute the hash from scratch
+    void reset(const vector<vector<char>>& board, TankTable& tanks, const pmr::vector<Shell>& shells);
+
+    void toggleCell(size_t x, size_t y, char cell);
+    void toggleTank(const TankInfo& tank);
+    void toggleShell(const Shell& shell);
+
+    uint64_t value() const { return hash; }
+};
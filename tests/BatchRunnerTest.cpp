@@ -0,0 +1,115 @@
+// Plays generated boards once through BatchRunner::run(), one GameManager per game,
+// and again through runLockstep() with and without a pool. Every game must end the
+// same way in all three.
+#include "../game_management/BatchRunner.h"
+#include "../common/MyPlayerFactory.h"
+#include "../common/MyTankAlgorithmFactory.h"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+    const int BOARDS = 300;
+    int failures = 0;
+
+    void check(bool condition, const std::string& what) {
+        if (!condition) {
+            std::cerr << "  FAILED: " << what << std::endl;
+            failures++;
+        }
+    }
+
+    // Small random boards with walls, mines and two or three teams of up to three tanks
+    std::string writeBoard(int seed) {
+        std::mt19937 random(static_cast<unsigned>(seed));
+        auto between = [&random](int low, int high) { return std::uniform_int_distribution<int>(low, high)(random); };
+        int rows = between(3, 10);
+        int columns = between(3, 12);
+        int teams = between(0, 3) == 0 ? 3 : 2;
+        std::vector<std::string> grid(rows, std::string(columns, ' '));
+        for (std::string& row : grid) {
+            for (char& cell : row) {
+                int roll = between(0, 99);
+                cell = roll < 15 ? '#' : roll < 20 ? '@' : ' ';
+            }
+        }
+        std::vector<int> cells(rows * columns);
+        for (int i = 0; i < rows * columns; i++) {
+            cells[i] = i;
+        }
+        std::shuffle(cells.begin(), cells.end(), random);
+        size_t next = 0;
+        for (int team = 1; team <= teams; team++) {
+            for (int tank = between(1, 3); tank > 0 && next < cells.size(); tank--, next++) {
+                grid[cells[next] / columns][cells[next] % columns] = static_cast<char>('0' + team);
+            }
+        }
+
+        std::string fileName = "board" + std::to_string(seed) + ".txt";
+        std::ofstream file(fileName);
+        file << "generated " << seed << "\n"
+             << "MaxSteps = " << between(20, 80) << "\n"
+             << "NumShells = " << between(0, 6) << "\n"
+             << "Rows = " << rows << "\n"
+             << "Cols = " << columns << "\n";
+        for (const std::string& row : grid) {
+            file << row << "\n";
+        }
+        return fileName;
+    }
+
+    void compare(const std::string& mode, const std::vector<BatchEntry>& expected, const std::vector<BatchEntry>& actual) {
+        check(expected.size() == actual.size(), mode + ": one entry per board");
+        for (size_t i = 0; i < expected.size() && i < actual.size(); i++) {
+            const BatchEntry& a = expected[i];
+            const BatchEntry& b = actual[i];
+            const std::string board = mode + " " + a.boardFile;
+            check(!a.failed && !b.failed, board + " played (" + a.error + b.error + ")");
+            check(a.result.reason == b.result.reason, board + ": same end reason");
+            check(a.result.winner == b.result.winner, board + ": winner " + std::to_string(a.result.winner) +
+                  " vs " + std::to_string(b.result.winner));
+            check(a.result.rounds == b.result.rounds, board + ": rounds " + std::to_string(a.result.rounds) +
+                  " vs " + std::to_string(b.result.rounds));
+            check(a.result.numTeams == b.result.numTeams, board + ": same number of teams");
+            check(a.result.teamTanks == b.result.teamTanks, board + ": same tanks left per team");
+        }
+    }
+}
+
+int main() {
+    // The games write their output files next to the boards
+    std::filesystem::path directory = "batch_runner_test_boards";
+    std::filesystem::create_directories(directory);
+    std::filesystem::current_path(directory);
+    std::vector<std::string> boards;
+    for (int seed = 1; seed <= BOARDS; seed++) {
+        boards.push_back(writeBoard(seed));
+    }
+
+    // The games log every step to cout
+    std::ofstream log("games.log");
+    std::streambuf* console = std::cout.rdbuf(log.rdbuf());
+
+    MyPlayerFactory playerFactory;
+    MyTankAlgorithmFactory algorithmFactory;
+    WorkStealingPool pool(2);
+    BatchRunner pooled(playerFactory, algorithmFactory, pool);
+    BatchRunner single(playerFactory, algorithmFactory);
+    std::vector<BatchEntry> separate = pooled.run(boards);
+    std::vector<BatchEntry> lockstep = pooled.runLockstep(boards);
+    std::vector<BatchEntry> lockstepAlone = single.runLockstep(boards);
+    std::cout.rdbuf(console);
+
+    compare("lockstep on the pool", separate, lockstep);
+    compare("lockstep on one thread", separate, lockstepAlone);
+    if (failures > 0) {
+        std::cerr << failures << " check(s) failed" << std::endl;
+        return 1;
+    }
+    std::cout << "Lockstep results match " << boards.size() << " separate games" << std::endl;
+    return 0;
+}
@@ -0,0 +1,232 @@
+// Checks the path finders against bfsPathfinder on random boards that wrap at the
+// edges: jump point search and D* Lite must find paths as short as BFS, the cluster
+// search a valid path whenever BFS finds one, and the parallel BFS the very same path.
+#include "../common/PathFinder.h"
+#include "../common/WorkStealingPool.h"
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+    const int BOARDS = 400;
+    int failures = 0;
+
+    void check(bool condition, const std::string& what) {
+        if (!condition) {
+            std::cerr << "  FAILED: " << what << std::endl;
+            failures++;
+        }
+    }
+
+    // Swallows the path finders' logs
+    class NullBuffer : public std::streambuf {
+    protected:
+        int overflow(int c) override { return c; }
+    };
+
+    struct Case {
+        vector<vector<char>> grid;
+        Point start;
+        Point end;
+        std::string name;
+    };
+
+    bool passable(const vector<vector<char>>& grid, Point p, bool includeWalls) {
+        char cell = grid[p.y][p.x];
+        return cell == BoardConstants::EMPTY_SPACE || BoardConstants::isTankChar(cell) ||
+               (includeWalls && (cell == BoardConstants::WALL || cell == BoardConstants::DAMAGED_WALL));
+    }
+
+    bool usesWalls(const vector<vector<char>>& grid, const vector<Point>& path) {
+        for (Point p : path) {
+            if (!passable(grid, p, false)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // From start to end in single king moves over the wrapping board, through cells a path may use
+    bool isValidPath(const vector<vector<char>>& grid, const vector<Point>& path, Point start, Point end, bool includeWalls) {
+        if (path.empty() || !(path.front() == start) || !(path.back() == end)) {
+            return false;
+        }
+        int rows = grid.size();
+        int cols = grid[0].size();
+        for (size_t i = 0; i < path.size(); i++) {
+            Point p = path[i];
+            if (p.x < 0 || p.x >= cols || p.y < 0 || p.y >= rows || !passable(grid, p, includeWalls)) {
+                return false;
+            }
+            if (i > 0) {
+                int dx = std::abs(p.x - path[i - 1].x);
+                int dy = std::abs(p.y - path[i - 1].y);
+                dx = std::min(dx, cols - dx);
+                dy = std::min(dy, rows - dy);
+                if (std::max(dx, dy) != 1) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    Point randomFreeCell(const vector<vector<char>>& grid, std::mt19937& random) {
+        int rows = grid.size();
+        int cols = grid[0].size();
+        while (true) {
+            Point p{std::uniform_int_distribution<int>(0, cols - 1)(random), std::uniform_int_distribution<int>(0, rows - 1)(random)};
+            if (grid[p.y][p.x] == BoardConstants::EMPTY_SPACE) {
+                return p;
+            }
+        }
+    }
+
+    // Walls, damaged walls and mines over a mostly open board, from narrow strips to 40x40
+    // unless the sides are given
+    Case makeCase(int seed, int rows = 0, int cols = 0, int maxDensity = 45) {
+        std::mt19937 random(static_cast<unsigned>(seed));
+        auto between = [&random](int low, int high) { return std::uniform_int_distribution<int>(low, high)(random); };
+        if (rows == 0) {
+            rows = seed % 10 == 0 ? between(1, 2) : between(3, 40);
+            cols = seed % 10 == 5 ? between(1, 2) : between(3, 40);
+        }
+        int density = between(5, maxDensity);
+        Case c;
+        c.grid.assign(rows, vector<char>(cols, BoardConstants::EMPTY_SPACE));
+        for (auto& row : c.grid) {
+            for (char& cell : row) {
+                int roll = between(0, 99);
+                if (roll < density) {
+                    cell = roll % 7 == 0 ? BoardConstants::DAMAGED_WALL : roll % 5 == 0 ? BoardConstants::MINE : BoardConstants::WALL;
+                }
+            }
+        }
+        // Keep two free cells for the ends
+        c.grid[0][0] = BoardConstants::EMPTY_SPACE;
+        c.grid[rows - 1][cols - 1] = BoardConstants::EMPTY_SPACE;
+        c.start = randomFreeCell(c.grid, random);
+        c.end = randomFreeCell(c.grid, random);
+        c.name = "board " + std::to_string(seed) + " (" + std::to_string(rows) + "x" + std::to_string(cols) + ")";
+        return c;
+    }
+
+    void checkJumpPoints(const Case& c, BfsScratch& bfsScratch, JpsScratch& jpsScratch) {
+        for (bool includeWalls : {false, true}) {
+            vector<Point> expected = bfsPathfinder(c.grid, c.start, c.end, includeWalls, bfsScratch);
+            vector<Point> path = jumpPointPathfinder(c.grid, c.start, c.end, includeWalls, jpsScratch);
+            std::string what = c.name + (includeWalls ? " through walls" : "");
+            check(path.size() == expected.size(), "jump points: " + what + ", " + std::to_string(path.size()) +
+                  " cells vs " + std::to_string(expected.size()) + " by BFS");
+            if (!expected.empty()) {
+                check(isValidPath(c.grid, path, c.start, c.end, includeWalls || usesWalls(c.grid, expected)),
+                      "jump points: " + what + ", valid path");
+            }
+        }
+    }
+
+    // BFS without walls falls back to walls; D* Lite and the cluster search do not use them
+    size_t wallFreeLength(const Case& c, BfsScratch& scratch) {
+        vector<Point> path = bfsPathfinder(c.grid, c.start, c.end, false, scratch);
+        return usesWalls(c.grid, path) ? 0 : path.size();
+    }
+
+    void checkIncremental(Case c, std::mt19937& random, BfsScratch& scratch) {
+        IncrementalPathFinder finder;
+        vector<Point> path = finder.plan(c.grid, c.start, c.end);
+        size_t expected = wallFreeLength(c, scratch);
+        check(path.size() == expected, "D* Lite plan: " + c.name + ", " + std::to_string(path.size()) +
+              " cells vs " + std::to_string(expected) + " by BFS");
+        if (expected > 0) {
+            check(isValidPath(c.grid, path, c.start, c.end, false), "D* Lite plan: " + c.name + ", valid path");
+        }
+
+        // Step along, open and close cells and move the target, then repair the plan
+        int rows = c.grid.size();
+        int cols = c.grid[0].size();
+        for (int change = 0; change < 6; change++) {
+            if (path.size() > 1) {
+                c.start = path[1];
+            }
+            for (int k = 0; k < 1 + rows * cols / 30; k++) {
+                Point p{std::uniform_int_distribution<int>(0, cols - 1)(random), std::uniform_int_distribution<int>(0, rows - 1)(random)};
+                if (!(p == c.start) && !(p == c.end)) {
+                    char& cell = c.grid[p.y][p.x];
+                    cell = cell == BoardConstants::EMPTY_SPACE ? BoardConstants::WALL : BoardConstants::EMPTY_SPACE;
+                }
+            }
+            if (change % 3 == 2) {
+                c.end = randomFreeCell(c.grid, random);
+            }
+            path = finder.replan(c.grid, c.start, c.end);
+            expected = wallFreeLength(c, scratch);
+            std::string what = "D* Lite replan " + std::to_string(change) + ": " + c.name;
+            check(path.size() == expected, what + ", " + std::to_string(path.size()) + " cells vs " +
+                  std::to_string(expected) + " by BFS");
+            if (expected > 0) {
+                check(isValidPath(c.grid, path, c.start, c.end, false), what + ", valid path");
+            }
+        }
+    }
+
+    void checkParallel(const Case& c, WorkStealingPool& pool, BfsScratch& bfsScratch, ParallelBfsScratch& parallelScratch) {
+        for (bool includeWalls : {false, true}) {
+            vector<Point> expected = bfsPathfinder(c.grid, c.start, c.end, includeWalls, bfsScratch);
+            std::string what = c.name + (includeWalls ? " through walls" : "");
+            vector<Point> alone = parallelBfsPathfinder(c.grid, c.start, c.end, includeWalls, nullptr, parallelScratch);
+            check(alone == expected, "parallel BFS without a pool: " + what + ", same path as BFS");
+            vector<Point> pooled = parallelBfsPathfinder(c.grid, c.start, c.end, includeWalls, &pool, parallelScratch);
+            check(pooled == expected, "parallel BFS on the pool: " + what + ", same path as BFS");
+        }
+    }
+
+    void checkClusters(const Case& c, BfsScratch& scratch) {
+        // Small clusters, so that even small boards have several
+        ClusterPathFinder finder(4);
+        vector<Point> expected = bfsPathfinder(c.grid, c.start, c.end, false, scratch);
+        vector<Point> path = finder.findPath(c.grid, c.start, c.end);
+        check(path.empty() == expected.empty(), "clusters: " + c.name + ", found a path as BFS did");
+        if (!expected.empty()) {
+            check(path.size() >= expected.size(), "clusters: " + c.name + ", no shorter than BFS");
+            check(isValidPath(c.grid, path, c.start, c.end, usesWalls(c.grid, expected)), "clusters: " + c.name + ", valid path");
+        }
+    }
+}
+
+int main() {
+    NullBuffer discarded;
+    std::streambuf* console = std::cout.rdbuf(&discarded);
+    std::mt19937 random(12345);
+    BfsScratch bfsScratch;
+    JpsScratch jpsScratch;
+    ParallelBfsScratch parallelScratch;
+    WorkStealingPool pool(3);
+    for (int seed = 1; seed <= BOARDS; seed++) {
+        Case c = makeCase(seed);
+        checkJumpPoints(c, bfsScratch, jpsScratch);
+        checkIncremental(c, random, bfsScratch);
+        checkClusters(c, bfsScratch);
+        checkParallel(c, pool, bfsScratch, parallelScratch);
+        if (failures > 20) {
+            break;
+        }
+    }
+    // Frontiers only get split across the pool from a few thousand cells on, so these
+    // boards are open and their ends half a board apart
+    for (int seed = 1; seed <= 3; seed++) {
+        Case c = makeCase(BOARDS + seed, 1200, 1000 + 100 * seed, 20);
+        int rows = c.grid.size();
+        int cols = c.grid[0].size();
+        c.end = {(c.start.x + cols / 2) % cols, (c.start.y + rows / 2) % rows};
+        c.grid[c.end.y][c.end.x] = BoardConstants::EMPTY_SPACE;
+        checkParallel(c, pool, bfsScratch, parallelScratch);
+    }
+    std::cout.rdbuf(console);
+    if (failures > 0) {
+        std::cerr << failures << " check(s) failed" << std::endl;
+        return 1;
+    }
+    std::cout << "Path finders agree with BFS on " << BOARDS << " boards" << std::endl;
+    return 0;
+}
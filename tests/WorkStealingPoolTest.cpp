@@ -0,0 +1,234 @@
+// Tests of WorkStealingPool and TaskGroup. Every case runs under a time limit, as the
+// failures this guards against (a lost wake-up, a nested wait that never helps) hang.
+#include "../common/WorkStealingPool.h"
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <future>
+#include <iostream>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#ifdef __linux__
+#include <sched.h>
+#include <time.h>
+#endif
+
+namespace {
+    int failures = 0;
+
+    void check(bool condition, const std::string& what) {
+        if (!condition) {
+            std::cerr << "  FAILED: " << what << std::endl;
+            failures++;
+        }
+    }
+
+    void runCase(const std::string& name, void (*body)()) {
+        std::cout << name << std::endl;
+        std::packaged_task<void()> task(body);
+        std::future<void> done = task.get_future();
+        std::thread runner(std::move(task));
+        if (done.wait_for(std::chrono::seconds(30)) != std::future_status::ready) {
+            std::cerr << "  FAILED: timed out" << std::endl;
+            std::_Exit(1);  // The runner is stuck, it can't be joined
+        }
+        runner.join();
+        try {
+            done.get();
+        } catch (const std::exception& e) {
+            check(false, std::string("threw ") + e.what());
+        }
+    }
+
+    void runsEveryTask() {
+        WorkStealingPool pool(4);
+        std::atomic<int> count(0);
+        {
+            TaskGroup group(pool);
+            for (int i = 0; i < 10000; i++) {
+                group.run([&count]() { count++; });
+            }
+            group.wait();
+        }
+        check(count == 10000, "all 10000 tasks ran, got " + std::to_string(count.load()));
+    }
+
+    void idleWorkersSteal() {
+        // One task fills its own deque and then blocks without helping, so every
+        // subtask has to be stolen by the other workers
+        WorkStealingPool pool(4);
+        const int subtasks = 64;
+        std::atomic<int> done(0);
+        std::mutex threadsLock;
+        std::set<std::thread::id> thieves;
+        std::thread::id owner;
+        std::promise<void> finished;
+        pool.submit([&]() {
+            owner = std::this_thread::get_id();
+            for (int i = 0; i < subtasks; i++) {
+                pool.submit([&]() {
+                    {
+                        std::lock_guard<std::mutex> guard(threadsLock);
+                        thieves.insert(std::this_thread::get_id());
+                    }
+                    done++;
+                });
+            }
+            while (done < subtasks) {
+                std::this_thread::yield();
+            }
+            finished.set_value();
+        });
+        finished.get_future().wait();
+        check(done == subtasks, "all subtasks ran");
+        check(thieves.count(owner) == 0, "the blocked owner ran none of its subtasks");
+        check(!thieves.empty(), "other workers stole the subtasks");
+    }
+
+    void nestedWaitOnOneThread() {
+        // With a single worker, an inner wait can only finish by running the inner
+        // tasks itself
+        WorkStealingPool pool(1);
+        std::atomic<int> count(0);
+        TaskGroup outer(pool);
+        for (int i = 0; i < 8; i++) {
+            outer.run([&pool, &count]() {
+                TaskGroup inner(pool);
+                for (int j = 0; j < 8; j++) {
+                    inner.run([&pool, &count]() {
+                        TaskGroup innermost(pool);
+                        for (int k = 0; k < 4; k++) {
+                            innermost.run([&count]() { count++; });
+                        }
+                        innermost.wait();
+                    });
+                }
+                inner.wait();
+            });
+        }
+        outer.wait();
+        check(count == 8 * 8 * 4, "all nested tasks ran, got " + std::to_string(count.load()));
+    }
+
+    void nestedWaitOnManyThreads() {
+        WorkStealingPool pool(3);
+        std::atomic<long> sum(0);
+        TaskGroup outer(pool);
+        for (int i = 0; i < 32; i++) {
+            outer.run([&pool, &sum, i]() {
+                TaskGroup inner(pool);
+                for (int j = 0; j < 32; j++) {
+                    inner.run([&sum, i, j]() { sum += i * 32 + j; });
+                }
+                inner.wait();
+            });
+        }
+        outer.wait();
+        long n = 32 * 32;
+        check(sum == n * (n - 1) / 2, "nested sum is " + std::to_string(sum.load()));
+    }
+
+    void waitRethrowsFirstError() {
+        WorkStealingPool pool(2);
+        TaskGroup group(pool);
+        std::atomic<int> count(0);
+        for (int i = 0; i < 16; i++) {
+            group.run([&count, i]() {
+                count++;
+                if (i % 4 == 0) {
+                    throw std::runtime_error("task failed");
+                }
+            });
+        }
+        bool threw = false;
+        try {
+            group.wait();
+        } catch (const std::runtime_error&) {
+            threw = true;
+        }
+        check(threw, "wait() rethrew the task's exception");
+        check(count == 16, "the other tasks still ran");
+        group.wait();  // The error was reported once
+    }
+
+    void waitSleepsWhileNothingIsQueued() {
+        // The only task sleeps on a worker, so a waiter that spins would burn the whole wait
+        WorkStealingPool pool(1);
+        TaskGroup group(pool);
+        std::promise<void> started;
+        group.run([&started]() {
+            started.set_value();
+            std::this_thread::sleep_for(std::chrono::milliseconds(300));
+        });
+        started.get_future().wait();
+#ifdef __linux__
+        timespec before;
+        clock_gettime(CLOCK_THREAD_CPUTIME_ID, &before);
+#endif
+        group.wait();
+#ifdef __linux__
+        timespec after;
+        clock_gettime(CLOCK_THREAD_CPUTIME_ID, &after);
+        double cpuMs = (after.tv_sec - before.tv_sec) * 1e3 + (after.tv_nsec - before.tv_nsec) / 1e6;
+        check(cpuMs < 100, "wait() used " + std::to_string(cpuMs) + " ms of CPU over a 300 ms wait");
+#endif
+    }
+
+    void failedSubmitLeavesPoolRunning() {
+        WorkStealingPool pool(2);
+        std::promise<void> ran;
+        pool.submit([]() { throw std::runtime_error("bare task failed (expected)"); });
+        pool.submit([&ran]() { ran.set_value(); });
+        ran.get_future().wait();
+        std::atomic<int> count(0);
+        TaskGroup group(pool);
+        for (int i = 0; i < 8; i++) {
+            group.run([&count]() { count++; });
+        }
+        group.wait();
+        check(count == 8, "the pool kept running after a task threw");
+    }
+
+    void pinnedWorkersRunOnOneCore() {
+        WorkStealingPool pool(2, true);
+        std::atomic<int> ran(0);
+        std::atomic<int> pinned(0);
+        TaskGroup group(pool);
+        for (int i = 0; i < 64; i++) {
+            group.run([&ran, &pinned]() {
+                ran++;
+#ifdef __linux__
+                cpu_set_t cpus;
+                if (sched_getaffinity(0, sizeof(cpus), &cpus) == 0 && CPU_COUNT(&cpus) == 1) {
+                    pinned++;
+                }
+#else
+                pinned++;
+#endif
+            });
+        }
+        group.wait();
+        check(ran == 64, "pinned workers ran every task");
+        check(pinned == 64, "every task ran on a worker bound to a single core, " + std::to_string(pinned.load()) + " of 64");
+    }
+}
+
+int main() {
+    runCase("runs every task", runsEveryTask);
+    runCase("idle workers steal", idleWorkersSteal);
+    runCase("nested wait on one thread", nestedWaitOnOneThread);
+    runCase("nested wait on many threads", nestedWaitOnManyThreads);
+    runCase("wait rethrows the first error", waitRethrowsFirstError);
+    runCase("wait sleeps while nothing is queued", waitSleepsWhileNothingIsQueued);
+    runCase("a failed submit leaves the pool running", failedSubmitLeavesPoolRunning);
+    runCase("pinned workers run on one core", pinnedWorkersRunOnOneCore);
+    if (failures > 0) {
+        std::cerr << failures << " check(s) failed" << std::endl;
+        return 1;
+    }
+    std::cout << "All WorkStealingPool tests passed" << std::endl;
+    return 0;
+}